@@ -64,11 +64,18 @@ typedef enum
    HPL_COLUMN_MAJOR  = 202
 } HPL_T_ORDER;
 
+typedef enum
+{
+   HPL_COLL_TREE     = 211,       /* binomial trees over send / recv */
+   HPL_COLL_MPI      = 212                    /* native MPI collectives */
+} HPL_T_COLL;
+
 typedef struct HPL_S_grid
 {
    MPI_Comm        all_comm;                     /* grid communicator */
    MPI_Comm        row_comm;                      /* row communicator */
    MPI_Comm        col_comm;                   /* column communicator */
+   MPI_Comm        node_comm;      /* procs of my row sharing my node */
    HPL_T_ORDER     order;        /* ordering of the procs in the grid */
    int             iam;                        /* my rank in the grid */
    int             myrow;                /* my row number in the grid */
@@ -84,6 +91,8 @@ typedef struct HPL_S_grid
    int             col_hdim;     /* col_ip2 procs hypercube dimension */
    int             col_ip2m1;      /* largest power of two <= npcol-1 */
    int             col_mask;        /* col_ip2m1 procs hypercube mask */
+   int             * row_node;    /* 1st column of the node of every */
+                                       /* process of my row, or NULL */
 } HPL_T_grid;
 
 /*
@@ -100,6 +109,11 @@ typedef void (*HPL_T_OP)
  */
 #define    HPL_2_MPI_TYPE( typ ) \
                            ( ( typ == HPL_INT ? MPI_INT : MPI_DOUBLE ) )
+/*
+ * Default minimum number of entries of an all-reduce done as reduce-
+ * scatter + allgather with the HPL_COLL_MPI backend
+ */
+#define    HPL_COLL_LONG       16384
 /*
  * The following macros perform common modulo operations;  All functions
  * except MPosMod assume arguments are < d (i.e., arguments are themsel-
@@ -184,6 +198,21 @@ STDC_ARGS( (
    MPI_Comm
 ) );
 
+void                             HPL_coll_set
+STDC_ARGS( (
+   const HPL_T_COLL,
+   const int
+) );
+HPL_T_COLL                       HPL_coll_get
+STDC_ARGS( (
+   int *
+) );
+int                              HPL_coll_op
+STDC_ARGS( (
+   const HPL_T_OP,
+   MPI_Op *
+) );
+
 void                             HPL_max
 STDC_ARGS( (
    const int,
@@ -30,11 +30,6 @@
  */
 #include "hplai_misc.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
 #define HPLAI_NORM_A HPL_NORM_A
 #define HPLAI_NORM_1 HPL_NORM_1
 #define HPLAI_NORM_I HPL_NORM_I
@@ -55,7 +50,38 @@ extern "C"
 #define HPLAI_fprintf HPL_fprintf
 #define HPLAI_warn HPL_warn
 #define HPLAI_abort HPL_abort
+/*
+ * Timeline trace events (HPLAI_trace_event)
+ */
+    typedef enum
+    {
+        HPLAI_TRACE_PFACT = 0,
+        HPLAI_TRACE_MXSWP = 1,
+        HPLAI_TRACE_BCAST = 2,
+        HPLAI_TRACE_LASWP = 3,
+        HPLAI_TRACE_TRSM = 4,
+        HPLAI_TRACE_GEMM = 5,
+        HPLAI_TRACE_REFINE = 6,
+        HPLAI_TRACE_NEVENT = 7
+    } HPLAI_T_TRACE;
+/*
+ * Default capacity of the ring buffer of the timeline recorder
+ */
+#define HPLAI_TRACE_SIZE 262144
+
+    int HPLAI_trace_init STDC_ARGS((const char *, const int));
+    void HPLAI_trace_finalize STDC_ARGS((void));
+    double HPLAI_trace_time STDC_ARGS((void));
+    double HPLAI_trace_event STDC_ARGS((const HPLAI_T_TRACE, const double, const int));
+    void HPLAI_trace_account STDC_ARGS((const int));
+    void HPLAI_trace_stat STDC_ARGS((double *));
+
+    int HPLAI_progress_init STDC_ARGS((const double, const char *));
+    void HPLAI_progress_finalize STDC_ARGS((void));
+    void HPLAI_progress_start STDC_ARGS((void));
+    void HPLAI_progress_report STDC_ARGS((const HPL_T_grid *, const int, const int));
 
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alacpy
         STDC_ARGS((
             const int,
@@ -64,6 +90,7 @@ extern "C"
             const int,
             HPLAI_T_AFLOAT *,
             const int));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alatcpy
         STDC_ARGS((
             const int,
@@ -73,10 +100,6 @@ extern "C"
             HPLAI_T_AFLOAT *,
             const int));
 
-#ifdef __cplusplus
-}
-#endif
-
 #endif
 /*
  * End of hplai_auxil.hh
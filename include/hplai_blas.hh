@@ -35,9 +35,9 @@ int64_t blas::iamax<double>(
     int64_t incx);
 
 template <>
-int64_t blas::iamax<HPLAI_T_AFLOAT>(
+int64_t blas::iamax<HPLAI_T_LFLOAT>(
     int64_t n,
-    HPLAI_T_AFLOAT const *x,
+    HPLAI_T_LFLOAT const *x,
     int64_t incx);
 
 template <>
@@ -50,12 +50,12 @@ void blas::axpy<double, double>(
     int64_t incy);
 
 template <>
-void blas::axpy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+void blas::axpy<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
     int64_t n,
-    blas::scalar_type<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT> alpha,
-    HPLAI_T_AFLOAT const *x,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> alpha,
+    HPLAI_T_LFLOAT const *x,
     int64_t incx,
-    HPLAI_T_AFLOAT *y,
+    HPLAI_T_LFLOAT *y,
     int64_t incy);
 
 template <>
@@ -67,11 +67,11 @@ void blas::copy<double, double>(
     int64_t incy);
 
 template <>
-void blas::copy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+void blas::copy<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
     int64_t n,
-    HPLAI_T_AFLOAT const *x,
+    HPLAI_T_LFLOAT const *x,
     int64_t incx,
-    HPLAI_T_AFLOAT *y,
+    HPLAI_T_LFLOAT *y,
     int64_t incy);
 
 template <>
@@ -92,20 +92,20 @@ void blas::gemm<double, double, double>(
     int64_t ldc);
 
 template <>
-void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+void blas::gemm<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
     blas::Layout layout,
     blas::Op transA,
     blas::Op transB,
     int64_t m,
     int64_t n,
     int64_t k,
-    blas::scalar_type<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT> alpha,
-    HPLAI_T_AFLOAT const *A,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> alpha,
+    HPLAI_T_LFLOAT const *A,
     int64_t lda,
-    HPLAI_T_AFLOAT const *B,
+    HPLAI_T_LFLOAT const *B,
     int64_t ldb,
-    blas::scalar_type<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT> beta,
-    HPLAI_T_AFLOAT *C,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> beta,
+    HPLAI_T_LFLOAT *C,
     int64_t ldc);
 
 template <>
@@ -124,18 +124,18 @@ void blas::gemv<double, double, double>(
     int64_t incy);
 
 template <>
-void blas::gemv<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+void blas::gemv<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
     blas::Layout layout,
     blas::Op trans,
     int64_t m,
     int64_t n,
-    blas::scalar_type<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT> alpha,
-    HPLAI_T_AFLOAT const *A,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> alpha,
+    HPLAI_T_LFLOAT const *A,
     int64_t lda,
-    HPLAI_T_AFLOAT const *x,
+    HPLAI_T_LFLOAT const *x,
     int64_t incx,
-    blas::scalar_type<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT> beta,
-    HPLAI_T_AFLOAT *y,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> beta,
+    HPLAI_T_LFLOAT *y,
     int64_t incy);
 
 template <>
@@ -152,16 +152,16 @@ void blas::ger<double, double, double>(
     int64_t lda);
 
 template <>
-void blas::ger<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+void blas::ger<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
     blas::Layout layout,
     int64_t m,
     int64_t n,
-    blas::scalar_type<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT> alpha,
-    HPLAI_T_AFLOAT const *x,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> alpha,
+    HPLAI_T_LFLOAT const *x,
     int64_t incx,
-    HPLAI_T_AFLOAT const *y,
+    HPLAI_T_LFLOAT const *y,
     int64_t incy,
-    HPLAI_T_AFLOAT *A,
+    HPLAI_T_LFLOAT *A,
     int64_t lda);
 
 template <>
@@ -172,10 +172,10 @@ void blas::scal<double>(
     int64_t incx);
 
 template <>
-void blas::scal<HPLAI_T_AFLOAT>(
+void blas::scal<HPLAI_T_LFLOAT>(
     int64_t n,
-    HPLAI_T_AFLOAT alpha,
-    HPLAI_T_AFLOAT *x,
+    HPLAI_T_LFLOAT alpha,
+    HPLAI_T_LFLOAT *x,
     int64_t incx);
 
 template <>
@@ -194,7 +194,7 @@ void blas::trsm<double, double>(
     int64_t ldb);
 
 template <>
-void blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+void blas::trsm<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
     blas::Layout layout,
     blas::Side side,
     blas::Uplo uplo,
@@ -202,10 +202,10 @@ void blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
     blas::Diag diag,
     int64_t m,
     int64_t n,
-    blas::scalar_type<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT> alpha,
-    HPLAI_T_AFLOAT const *A,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> alpha,
+    HPLAI_T_LFLOAT const *A,
     int64_t lda,
-    HPLAI_T_AFLOAT *B,
+    HPLAI_T_LFLOAT *B,
     int64_t ldb);
 
 template <>
@@ -221,25 +221,35 @@ void blas::trsv<double, double>(
     int64_t incx);
 
 template <>
-void blas::trsv<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+void blas::trsv<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
     blas::Layout layout,
     blas::Uplo uplo,
     blas::Op trans,
     blas::Diag diag,
     int64_t n,
-    HPLAI_T_AFLOAT const *A,
+    HPLAI_T_LFLOAT const *A,
     int64_t lda,
-    HPLAI_T_AFLOAT *x,
+    HPLAI_T_LFLOAT *x,
     int64_t incx);
 
 #endif
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
+    /*
+ * HPLAI_MPI_AFLOAT is the MPI datatype of the HPLAI_T_AFLOAT in scope,
+ * committed by HPLAI_blas_init for every instantiated precision.
+ */
+    template <typename HPLAI_T_AFLOAT>
+    struct HPLAI_S_mpi
+    {
+        static MPI_Datatype afloat;
+    };
+#define HPLAI_MPI_AFLOAT (HPLAI_S_mpi<HPLAI_T_AFLOAT>::afloat)
 
-    extern MPI_Datatype HPLAI_MPI_AFLOAT;
+template <>
+MPI_Datatype HPLAI_S_mpi<HPLAI_T_LFLOAT>::afloat;
+
+template <>
+MPI_Datatype HPLAI_S_mpi<double>::afloat;
 
     void HPLAI_blas_init
         STDC_ARGS((
@@ -248,10 +258,6 @@ extern "C"
 
     void HPLAI_blas_finalize();
 
-#ifdef __cplusplus
-}
-#endif
-
 #endif
 /*
  * End of hplai_blas.hh
@@ -36,19 +36,31 @@
  * ---------------------------------------------------------------------
  */
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
 #define HPLAI_FAILURE HPL_FAILURE
 #define HPLAI_SUCCESS HPL_SUCCESS
 #define HPLAI_KEEP_TESTING HPL_KEEP_TESTING
+/*
+ * ---------------------------------------------------------------------
+ * #typedefs and data structures
+ * ---------------------------------------------------------------------
+ */
+    typedef int (*HPLAI_T_BPROG_FUN)
+        STDC_ARGS((
+            void *,
+            int *));
+
+    typedef struct HPLAI_S_bstat
+    {
+        double npanel; /* # of panels broadcast */
+        double tidle;  /* time spent by the main thread in bcast/bwait */
+        int thread;    /* whether the progress thread is running */
+    } HPLAI_T_bstat;
     /*
  * ---------------------------------------------------------------------
  * comm function prototypes
  * ---------------------------------------------------------------------
  */
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_send
         STDC_ARGS((
             HPLAI_T_AFLOAT *,
@@ -56,6 +68,7 @@ extern "C"
             int,
             int,
             MPI_Comm));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_recv
         STDC_ARGS((
             HPLAI_T_AFLOAT *,
@@ -63,6 +76,7 @@ extern "C"
             int,
             int,
             MPI_Comm));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_sdrv
         STDC_ARGS((
             HPLAI_T_AFLOAT *,
@@ -73,53 +87,107 @@ extern "C"
             int,
             int,
             MPI_Comm));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_binit
         STDC_ARGS((
             HPLAI_T_panel *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_bcast
         STDC_ARGS((
             HPLAI_T_panel *,
             int *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_bwait
         STDC_ARGS((
             HPLAI_T_panel *));
+    template <typename HPLAI_T_AFLOAT>
+    int HPLAI_bcast_topo
+        STDC_ARGS((
+            HPLAI_T_panel *,
+            int *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_packL
         STDC_ARGS((
             HPLAI_T_panel *,
             const int,
             const int,
             const int));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_copyL
         STDC_ARGS((
             HPLAI_T_panel *));
 
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_binit_1ring STDC_ARGS((HPLAI_T_panel *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_bcast_1ring STDC_ARGS((HPLAI_T_panel *, int *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_bwait_1ring STDC_ARGS((HPLAI_T_panel *));
 
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_binit_1rinM STDC_ARGS((HPLAI_T_panel *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_bcast_1rinM STDC_ARGS((HPLAI_T_panel *, int *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_bwait_1rinM STDC_ARGS((HPLAI_T_panel *));
 
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_binit_2ring STDC_ARGS((HPLAI_T_panel *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_bcast_2ring STDC_ARGS((HPLAI_T_panel *, int *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_bwait_2ring STDC_ARGS((HPLAI_T_panel *));
 
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_binit_2rinM STDC_ARGS((HPLAI_T_panel *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_bcast_2rinM STDC_ARGS((HPLAI_T_panel *, int *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_bwait_2rinM STDC_ARGS((HPLAI_T_panel *));
 
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_binit_blong STDC_ARGS((HPLAI_T_panel *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_bcast_blong STDC_ARGS((HPLAI_T_panel *, int *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_bwait_blong STDC_ARGS((HPLAI_T_panel *));
 
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_binit_blonM STDC_ARGS((HPLAI_T_panel *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_bcast_blonM STDC_ARGS((HPLAI_T_panel *, int *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_bwait_blonM STDC_ARGS((HPLAI_T_panel *));
 
-#ifdef __cplusplus
-}
-#endif
+    template <typename HPLAI_T_AFLOAT>
+    int HPLAI_binit_ibcst STDC_ARGS((HPLAI_T_panel *));
+    template <typename HPLAI_T_AFLOAT>
+    int HPLAI_bcast_ibcst STDC_ARGS((HPLAI_T_panel *, int *));
+    template <typename HPLAI_T_AFLOAT>
+    int HPLAI_bwait_ibcst STDC_ARGS((HPLAI_T_panel *));
+
+    template <typename HPLAI_T_AFLOAT>
+    int HPLAI_binit_1rinS STDC_ARGS((HPLAI_T_panel *));
+    template <typename HPLAI_T_AFLOAT>
+    int HPLAI_bcast_1rinS STDC_ARGS((HPLAI_T_panel *, int *));
+    template <typename HPLAI_T_AFLOAT>
+    int HPLAI_bwait_1rinS STDC_ARGS((HPLAI_T_panel *));
+
+    template <typename HPLAI_T_AFLOAT>
+    int HPLAI_binit_hier STDC_ARGS((HPLAI_T_panel *));
+    template <typename HPLAI_T_AFLOAT>
+    int HPLAI_bcast_hier STDC_ARGS((HPLAI_T_panel *, int *));
+    template <typename HPLAI_T_AFLOAT>
+    int HPLAI_bwait_hier STDC_ARGS((HPLAI_T_panel *));
+
+    int HPLAI_bprog_init STDC_ARGS((const int, const int));
+    void HPLAI_bprog_finalize STDC_ARGS((void));
+    int HPLAI_bprog_post STDC_ARGS((HPLAI_T_BPROG_FUN, void *));
+    int HPLAI_bprog_test STDC_ARGS((void *, int *));
+    int HPLAI_bprog_wait STDC_ARGS((void *));
+    int HPLAI_bprog_timed STDC_ARGS((void));
+    void HPLAI_bprog_count STDC_ARGS((const double, const int));
+    void HPLAI_bprog_stat STDC_ARGS((HPLAI_T_bstat *));
 
 #endif
 /*
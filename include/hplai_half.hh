@@ -0,0 +1,132 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2021 WuK
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef HPLAI_HALF_HH
+#define HPLAI_HALF_HH
+
+/*
+ * ---------------------------------------------------------------------
+ * Include files
+ * ---------------------------------------------------------------------
+ */
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * ---------------------------------------------------------------------
+ * Software 16-bit storage types
+ * ---------------------------------------------------------------------
+ *
+ * HPLAI_T_half (IEEE binary16) and HPLAI_T_bfloat16 only store 16 bits,
+ * all arithmetic is done in float through the implicit conversions, and
+ * the result is rounded to nearest even when it is stored back.  They are
+ * trivially copyable, so they can be moved around with memcpy and sent as
+ * HPLAI_MPI_AFLOAT like any other HPLAI_T_AFLOAT.
+ */
+static inline float HPLAI_half2float(const uint16_t H)
+{
+    const uint32_t sign = ((uint32_t)(H & 0x8000)) << 16;
+    const uint32_t em = H & 0x7fff;
+    uint32_t u;
+    float f;
+
+    if (em >= 0x7c00) /* inf or nan */
+        u = sign | 0x7f800000 | ((em & 0x3ff) << 13);
+    else if (em >= 0x0400) /* normal, rebias the exponent */
+        u = sign | ((em << 13) + 0x38000000);
+    else /* zero or subnormal, em * 2^-24 is exact in float */
+    {
+        f = (float)em * 5.9604644775390625e-8f;
+        return (sign ? -f : f);
+    }
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static inline uint16_t HPLAI_float2half(const float F)
+{
+    const uint32_t f32infty = 0x7f800000, f16max = 0x47800000;
+    const uint32_t denorm = 0x3f000000; /* 0.5f, its ulp is 2^-24 */
+    uint32_t u, sign, odd;
+    float f;
+
+    memcpy(&u, &F, sizeof(u));
+    sign = (u >> 16) & 0x8000;
+    u &= 0x7fffffff;
+
+    if (u >= f16max) /* overflows to inf, or inf and nan */
+        return (uint16_t)(sign | (u > f32infty ? 0x7e00 : 0x7c00));
+    if (u < 0x38800000) /* below 2^-14: subnormal or zero */
+    {
+        memcpy(&f, &u, sizeof(f));
+        f += 0.5f; /* the float adder does the rounding */
+        memcpy(&u, &f, sizeof(u));
+        return (uint16_t)(sign | (u - denorm));
+    }
+    odd = (u >> 13) & 1;
+    u += 0xc8000fff + odd; /* rebias the exponent and round */
+    return (uint16_t)(sign | (u >> 13));
+}
+
+static inline float HPLAI_bfloat162float(const uint16_t H)
+{
+    const uint32_t u = ((uint32_t)H) << 16;
+    float f;
+
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static inline uint16_t HPLAI_float2bfloat16(const float F)
+{
+    uint32_t u;
+
+    memcpy(&u, &F, sizeof(u));
+    if ((u & 0x7fffffff) > 0x7f800000) /* keep nan quiet */
+        return (uint16_t)((u >> 16) | 0x0040);
+    u += 0x7fff + ((u >> 16) & 1);
+    return (uint16_t)(u >> 16);
+}
+
+#define HPLAI_T_16BIT(T, TO, FROM)                              \
+    struct T                                                    \
+    {                                                           \
+        uint16_t x;                                             \
+        T() = default;                                          \
+        T(const float f) : x(FROM(f)) {}                        \
+        operator float() const { return TO(x); }                \
+        T &operator+=(const float f) { return *this = TO(x) + f; } \
+        T &operator-=(const float f) { return *this = TO(x) - f; } \
+        T &operator*=(const float f) { return *this = TO(x) * f; } \
+        T &operator/=(const float f) { return *this = TO(x) / f; } \
+    }
+
+HPLAI_T_16BIT(HPLAI_T_half, HPLAI_half2float, HPLAI_float2half);
+HPLAI_T_16BIT(HPLAI_T_bfloat16, HPLAI_bfloat162float, HPLAI_float2bfloat16);
+
+#undef HPLAI_T_16BIT
+
+#endif
+/*
+ * End of hplai_half.hh
+ */
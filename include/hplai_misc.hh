@@ -59,10 +59,44 @@ extern "C"
  * #define macros definitions
  * ---------------------------------------------------------------------
  */
-#ifndef HPLAI_T_AFLOAT
-#define HPLAI_T_AFLOAT float
+/*
+ * The HPLAI_* routines are templates on their working precision, named
+ * HPLAI_T_AFLOAT inside them.  They are instantiated for HPLAI_T_LFLOAT
+ * and for double, xhpl_ai picks one per run from HPL.dat.
+ */
+#if defined(HPLAI_T_AFLOAT)
+#error "HPLAI_T_AFLOAT is chosen at run time, define HPLAI_T_LFLOAT instead"
+#endif
+
+#if defined(HPLAI_SOFT_HALF) || defined(HPLAI_SOFT_BFLOAT16)
+#include "hplai_half.hh"
+#define HPLAI_SOFT_LFLOAT
+#if defined(HPLAI_T_LFLOAT)
+#error "HPLAI_SOFT_HALF and HPLAI_SOFT_BFLOAT16 select HPLAI_T_LFLOAT"
+#elif defined(HPLAI_SOFT_HALF)
+#define HPLAI_T_LFLOAT HPLAI_T_half
+#define HPLAI_LFLOAT_NAME "fp16"
+#else
+#define HPLAI_T_LFLOAT HPLAI_T_bfloat16
+#define HPLAI_LFLOAT_NAME "bf16"
+#endif
+#if defined(HPLAI_DEVICE_BLASPP_GEMM) || defined(HPLAI_DEVICE_BLASPP_TRSM) || defined(HPLAI_ACL_BLASPP_GEMM)
+#error "software HPLAI_T_LFLOAT only runs on the host"
+#endif
 #endif
 
+#ifndef HPLAI_T_LFLOAT
+#define HPLAI_T_LFLOAT float
+#endif
+
+#ifndef HPLAI_LFLOAT_NAME
+#define HPLAI_LFLOAT_NAME "float"
+#endif
+
+#define HPLAI_INSTANTIATE(FUN)                                 \
+    template decltype(FUN<HPLAI_T_LFLOAT>) FUN<HPLAI_T_LFLOAT>; \
+    template decltype(FUN<double>) FUN<double>
+
 #define HPLAI_rone ((HPLAI_T_AFLOAT)HPL_rone)
 #define HPLAI_rtwo ((HPLAI_T_AFLOAT)HPL_rtwo)
 #define HPLAI_rzero ((HPLAI_T_AFLOAT)HPL_rzero)
@@ -32,17 +32,26 @@
 
 #include "hplai_pfact.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    /*
+ * ---------------------------------------------------------------------
+ * #typedefs and data structures
+ * ---------------------------------------------------------------------
+ */
+    typedef struct HPLAI_S_pwstat
+    {
+        double nalloc; /* # of panel workspaces allocated */
+        double balloc; /* # of bytes allocated */
+        double talloc; /* time spent allocating and first touching */
+        double nreuse; /* # of panel workspaces recycled */
+        double breuse; /* # of bytes recycled instead of allocated */
+    } HPLAI_T_pwstat;
     /*
  * ---------------------------------------------------------------------
  * panel function prototypes
  * ---------------------------------------------------------------------
  */
 
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_papanel_new
         STDC_ARGS((
             HPL_T_grid *,
@@ -55,6 +64,7 @@ extern "C"
             const int,
             const int,
             HPLAI_T_panel **));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_papanel_init
         STDC_ARGS((
             HPL_T_grid *,
@@ -67,16 +77,29 @@ extern "C"
             const int,
             const int,
             HPLAI_T_panel *));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_papanel_disp
         STDC_ARGS((
             HPLAI_T_panel **));
+    template <typename HPLAI_T_AFLOAT>
     int HPLAI_papanel_free
         STDC_ARGS((
             HPLAI_T_panel *));
-
-#ifdef __cplusplus
-}
-#endif
+    void *HPLAI_papanel_wget
+        STDC_ARGS((
+            void *,
+            size_t *,
+            const size_t,
+            const size_t));
+    void HPLAI_papanel_wstat
+        STDC_ARGS((
+            HPLAI_T_pwstat *));
+    template <typename HPLAI_T_AFLOAT>
+    void HPLAI_papanel_shm
+        STDC_ARGS((
+            HPLAI_T_panel *,
+            const size_t,
+            const size_t));
 
 #endif
 /*
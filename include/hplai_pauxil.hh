@@ -33,11 +33,6 @@
 
 
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
 #define HPLAI_indxg2lp HPL_indxg2lp
 #define HPLAI_indxg2l HPL_indxg2l
 #define HPLAI_indxg2p HPL_indxg2p
@@ -46,6 +41,7 @@ extern "C"
 #define HPLAI_numroc HPL_numroc
 #define HPLAI_numrocI HPL_numrocI
 
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alaswp00N
         STDC_ARGS((
             const int,
@@ -53,6 +49,7 @@ extern "C"
             HPLAI_T_AFLOAT *,
             const int,
             const int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alaswp10N
         STDC_ARGS((
             const int,
@@ -60,6 +57,7 @@ extern "C"
             HPLAI_T_AFLOAT *,
             const int,
             const int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alaswp01N
         STDC_ARGS((
             const int,
@@ -70,6 +68,7 @@ extern "C"
             const int,
             const int *,
             const int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alaswp01T
         STDC_ARGS((
             const int,
@@ -80,6 +79,7 @@ extern "C"
             const int,
             const int *,
             const int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alaswp02N
         STDC_ARGS((
             const int,
@@ -91,6 +91,7 @@ extern "C"
             const int,
             const int *,
             const int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alaswp03N
         STDC_ARGS((
             const int,
@@ -100,6 +101,7 @@ extern "C"
             const HPLAI_T_AFLOAT *,
             const HPLAI_T_AFLOAT *,
             const int));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alaswp03T
         STDC_ARGS((
             const int,
@@ -109,6 +111,7 @@ extern "C"
             const HPLAI_T_AFLOAT *,
             const HPLAI_T_AFLOAT *,
             const int));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alaswp04N
         STDC_ARGS((
             const int,
@@ -123,6 +126,7 @@ extern "C"
             const int,
             const int *,
             const int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alaswp04T
         STDC_ARGS((
             const int,
@@ -137,6 +141,7 @@ extern "C"
             const int,
             const int *,
             const int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alaswp05N
         STDC_ARGS((
             const int,
@@ -147,6 +152,7 @@ extern "C"
             const int,
             const int *,
             const int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alaswp05T
         STDC_ARGS((
             const int,
@@ -157,6 +163,7 @@ extern "C"
             const int,
             const int *,
             const int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alaswp06N
         STDC_ARGS((
             const int,
@@ -166,6 +173,7 @@ extern "C"
             HPLAI_T_AFLOAT *,
             const int,
             const int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alaswp06T
         STDC_ARGS((
             const int,
@@ -179,10 +187,6 @@ extern "C"
 #define HPLAI_pabort HPL_pabort
 #define HPLAI_pwarn HPL_pwarn
 
-#ifdef __cplusplus
-}
-#endif
-
 #endif
 /*
  * End of hplai_pauxil.hh
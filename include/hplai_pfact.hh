@@ -38,15 +38,23 @@
  * ---------------------------------------------------------------------
  */
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
 #define HPLAI_LEFT_LOOKING HPL_LEFT_LOOKING
 #define HPLAI_CROUT HPL_CROUT
 #define HPLAI_RIGHT_LOOKING HPL_RIGHT_LOOKING
 #define HPLAI_T_FACT HPL_T_FACT
+/*
+ * Tournament pivoting (communication-avoiding LU) of the whole panel,
+ * HPLAI_papantp{N,T},  used as both the panel and the recursive facto-
+ * rization.
+ */
+#define HPLAI_TOURNAMENT ((HPLAI_T_FACT)(304))
+/*
+ * Right looking panel factorization with the local rows shared by a team
+ * of OpenMP threads,  HPLAI_papanth{N,T},  and the minimum number of rows
+ * per thread.
+ */
+#define HPLAI_RIGHT_THREADED ((HPLAI_T_FACT)(305))
+#define HPLAI_PFTHR_ROWS 256
 
 #define HPLAI_1RING HPL_1RING
 #define HPLAI_1RING_M HPL_1RING_M
@@ -55,8 +63,42 @@ extern "C"
 #define HPLAI_BLONG HPL_BLONG
 #define HPLAI_BLONG_M HPL_BLONG_M
 #define HPLAI_T_TOP HPL_T_TOP
+/*
+ * MPI_Ibcast of the panel, progressed by the MPI library and tested from
+ * the update as the rings above. HPL_T_TOP itself is left as in HPL.
+ */
+#define HPLAI_IBCAST ((HPLAI_T_TOP)(407))
+/*
+ * Increasing ring cut into segments of ALGO->bseg entries,  every pro-
+ * cess forwarding a segment as soon as it has received it.
+ */
+#define HPLAI_1RING_S ((HPLAI_T_TOP)(408))
+#define HPLAI_BSEG_DEFAULT 65536
+/*
+ * Two-level broadcast:  binomial tree between the node leaders of the
+ * process row, then from every leader to the processes of its node.
+ */
+#define HPLAI_HIER ((HPLAI_T_TOP)(409))
+/*
+ * Same tree,  but  the processes of a node share a single copy of the
+ * panel in an MPI shared memory window (HPLAI_papanel_shm):  the leader
+ * fills it and only notifies the other processes of its node.
+ */
+#define HPLAI_HIER_SHM ((HPLAI_T_TOP)(410))
+/*
+ * Without pivoting (ALGO->nopiv),  the panel factorization falls back to
+ * partial pivoting as soon as a pivot is smaller  than HPLAI_NOPIV_TOL
+ * times the largest entry below it in the diagonal block.
+ */
+#define HPLAI_NOPIV_TOL 0.1
 
-    typedef struct HPLAI_S_pmat
+    /*
+ * The data structures below are templates on the working precision,
+ * HPLAI_T_AFLOAT; HPLAI_T_pmat, HPLAI_T_panel and HPLAI_T_palg name the
+ * instance for the HPLAI_T_AFLOAT in scope.
+ */
+    template <typename HPLAI_T_AFLOAT>
+    struct HPLAI_S_pmat
     {
 #ifdef HPL_CALL_VSIPL
         vsip_block_d *block;
@@ -69,28 +111,44 @@ extern "C"
         int mp;            /* local number of rows */
         int nq;            /* local number of columns */
         int info;          /* computational flag */
-    } HPLAI_T_pmat;
+    };
+#define HPLAI_T_pmat HPLAI_S_pmat<HPLAI_T_AFLOAT>
 
+    template <typename HPLAI_T_AFLOAT>
     struct HPLAI_S_palg;
+#define HPLAI_T_palg HPLAI_S_palg<HPLAI_T_AFLOAT>
 
-    typedef struct HPLAI_S_panel
+    template <typename HPLAI_T_AFLOAT>
+    struct HPLAI_S_panel
     {
         struct HPL_S_grid *grid;   /* ptr to the process grid */
-        struct HPLAI_S_palg *algo; /* ptr to the algo parameters */
+        HPLAI_T_palg *algo;        /* ptr to the algo parameters */
         HPLAI_T_pmat *pmat;        /* ptr to the local array info */
         HPLAI_T_AFLOAT *A;         /* ptr to trailing part of A */
         HPLAI_T_AFLOAT *WORK;      /* work space */
         HPLAI_T_AFLOAT *L2;        /* ptr to L */
         HPLAI_T_AFLOAT *L1;        /* ptr to jb x jb upper block of A */
-        HPLAI_T_AFLOAT *DPIV;      /* ptr to replicated jb pivot array */
-        HPLAI_T_AFLOAT *DINFO;     /* ptr to replicated scalar info */
+        int *IPIV;                 /* ptr to replicated jb pivot array */
+        int *IINFO;                /* ptr to replicated scalar info */
         HPLAI_T_AFLOAT *U;         /* ptr to U */
         int *IWORK;                /* integer workspace for swapping */
+        HPLAI_T_AFLOAT *PFWORK;    /* workspace of the panel factorization */
+        size_t lwork;              /* size in bytes of WORK */
+        size_t liwork;             /* size in bytes of IWORK */
         void ***buffers[2];        /* buffers for panel bcast */
         int counts[2];             /* counts for panel bcast */
         MPI_Datatype dtypes[2];    /* data types for panel bcast */
         MPI_Request request[1];    /* requests for panel bcast */
         MPI_Status status[1];      /* status for panel bcast */
+        MPI_Request *sreq;         /* requests for segmented panel bcast */
+        int nseg;                  /* # of segments of the panel bcast */
+        int iseg;                  /* # of segments done */
+        MPI_Win wshm;              /* node shared panel window */
+        HPLAI_T_AFLOAT *SHM;       /* node shared copy of L2, L1 and IPIV */
+        size_t lshm;               /* size in bytes of SHM */
+        MPI_Datatype mxtype;       /* pivot row type of HPLAI_pamxswpA */
+        MPI_Op mxop;               /* pivot row op of HPLAI_pamxswpA */
+        int mxn0;                  /* panel width mxtype was built for */
         int nb;                    /* distribution blocking factor */
         int jb;                    /* panel width */
         int m;                     /* global # of rows of trailing part of A */
@@ -113,17 +171,84 @@ extern "C"
         vsip_block_d *L2block; /* L2 block */
         vsip_block_d *Ublock;  /* U block */
 #endif
-    } HPLAI_T_panel;
+    };
+#define HPLAI_T_panel HPLAI_S_panel<HPLAI_T_AFLOAT>
+/*
+ * HPLAI_IALIGN(n) rounds n entries of HPLAI_T_AFLOAT up to a whole number
+ * of ints, so that an int stored right after them is aligned. It is n
+ * itself unless HPLAI_T_AFLOAT is narrower than int.
+ */
+#define HPLAI_IALIGN(n_) \
+    ((int)((((size_t)(n_) * sizeof(HPLAI_T_AFLOAT) + sizeof(int) - 1) / sizeof(int)) * \
+           sizeof(int) / sizeof(HPLAI_T_AFLOAT)))
+/*
+ * The pivot indexes IPIV and the info IINFO are integers stored right
+ * after L1 in the HPLAI_T_AFLOAT panel buffer, so that they are broadcast
+ * along with it. IPIV starts HPLAI_IALIGN(jb*jb) entries after L1, and
+ * HPLAI_IPIV_LEN(jb) is the number of HPLAI_T_AFLOAT entries they occupy
+ * past the jb*jb entries of L1, padding included.
+ */
+#define HPLAI_IPIV_LEN(jb_) \
+    (HPLAI_IALIGN((jb_) * (jb_)) - (jb_) * (jb_) + \
+     (int)((((size_t)(jb_) + 1) * sizeof(int) + sizeof(HPLAI_T_AFLOAT) - 1) / sizeof(HPLAI_T_AFLOAT)))
+/*
+ * The pivot search workspace starts with a header of HPLAI_MXSWP_HDR
+ * entries: WORK[0] is the absolute value max, the following entries
+ * hold the integers HPLAI_MXSWP_LINDX (local row index), HPLAI_MXSWP_GINDX
+ * (global row index) and HPLAI_MXSWP_PROW (process row owning the max).
+ * Row indexes thus remain exact whatever the precision of HPLAI_T_AFLOAT.
+ * HPLAI_MXSWP_CURR is only used by HPLAI_pamxswpA: it flags the buffers
+ * that carry the current row of A.
+ */
+#define HPLAI_MXSWP_LINDX 0
+#define HPLAI_MXSWP_GINDX 1
+#define HPLAI_MXSWP_PROW 2
+#define HPLAI_MXSWP_CURR 3
+#define HPLAI_MXSWP_NINT 4
+#define HPLAI_MXSWP_HDR \
+    (1 + (int)((HPLAI_MXSWP_NINT * sizeof(int) + sizeof(HPLAI_T_AFLOAT) - 1) / sizeof(HPLAI_T_AFLOAT)))
+
+    template <typename HPLAI_T_AFLOAT>
+    static inline int HPLAI_mxswp_geti(const HPLAI_T_AFLOAT *WORK, const int K)
+    {
+        int i;
+        memcpy(&i, (const char *)(WORK + 1) + (size_t)(K) * sizeof(int), sizeof(int));
+        return (i);
+    }
+
+    template <typename HPLAI_T_AFLOAT>
+    static inline void HPLAI_mxswp_seti(HPLAI_T_AFLOAT *WORK, const int K, const int I)
+    {
+        memcpy((char *)(WORK + 1) + (size_t)(K) * sizeof(int), &I, sizeof(int));
+    }
     /*
  * ---------------------------------------------------------------------
  * #typedefs and data structures
  * ---------------------------------------------------------------------
  */
-    typedef void (*HPLAI_T_PFA_FUN)(HPLAI_T_panel *, const int, const int, const int,
-                                    HPLAI_T_AFLOAT *);
-    typedef void (*HPLAI_T_RFA_FUN)(HPLAI_T_panel *, const int, const int, const int,
-                                    HPLAI_T_AFLOAT *);
-    typedef void (*HPLAI_T_UPD_FUN)(HPLAI_T_panel *, int *, HPLAI_T_panel *, const int);
+    template <typename HPLAI_T_AFLOAT>
+    using HPLAI_S_PFA_FUN = void (*)(HPLAI_T_panel *, const int, const int, const int,
+                                     HPLAI_T_AFLOAT *);
+    template <typename HPLAI_T_AFLOAT>
+    using HPLAI_S_RFA_FUN = void (*)(HPLAI_T_panel *, const int, const int, const int,
+                                     HPLAI_T_AFLOAT *);
+    template <typename HPLAI_T_AFLOAT>
+    using HPLAI_S_UPD_FUN = void (*)(HPLAI_T_panel *, int *, HPLAI_T_panel *, const int);
+#define HPLAI_T_PFA_FUN HPLAI_S_PFA_FUN<HPLAI_T_AFLOAT>
+#define HPLAI_T_RFA_FUN HPLAI_S_RFA_FUN<HPLAI_T_AFLOAT>
+#define HPLAI_T_UPD_FUN HPLAI_S_UPD_FUN<HPLAI_T_AFLOAT>
+    /*
+ * Operator  of  the  iterative refinement:  y := alpha * A x + beta * y,
+ * restricted to the local rows and columns of A.
+ */
+    typedef enum
+    {
+        HPLAI_OPER_STORED = 0,  /* stored double matrix (gemv) */
+        HPLAI_OPER_ANALYTIC = 1 /* matrix-free, from the generator formula */
+    } HPLAI_T_OPER;
+    typedef void (*HPLAI_T_OPR_FUN)(const HPL_T_grid *, const HPL_T_pmat *,
+                                    const double, const double *,
+                                    const double, double *);
 
 #define HPLAI_SWAP00 HPL_SWAP00
 #define HPLAI_SWAP01 HPL_SWAP01
@@ -131,7 +256,8 @@ extern "C"
 #define HPLAI_NO_SWP HPL_NO_SWP
 #define HPLAI_T_SWAP HPL_T_SWAP
 
-    typedef struct HPLAI_S_palg
+    template <typename HPLAI_T_AFLOAT>
+    struct HPLAI_S_palg
     {
         HPLAI_T_TOP btopo;     /* row broadcast topology */
         int depth;             /* look-ahead depth */
@@ -146,12 +272,19 @@ extern "C"
         int fsthr;             /* Swapping threshold */
         int equil;             /* Equilibration */
         int align;             /* data alignment constant */
-    } HPLAI_T_palg;
+        int bseg;              /* segment length of the 1ringS bcast */
+        int nopiv;             /* no pivoting, unless a pivot is too small */
+        int rbt;               /* depth of the random butterfly transform */
+        int mxswp;             /* pivot row exchange: 0=bin-exch,1=allreduce */
+        HPLAI_T_OPER oper;     /* refinement operator variant */
+        HPLAI_T_OPR_FUN opfun; /* refinement operator function ptr */
+    };
     /*
  * ---------------------------------------------------------------------
  * Function prototypes
  * ---------------------------------------------------------------------
  */
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alocmax
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -160,18 +293,21 @@ extern "C"
             const int,
             HPLAI_T_AFLOAT *));
 
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alocswpN
         STDC_ARGS((
             HPLAI_T_panel *,
             const int,
             const int,
             HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_alocswpT
         STDC_ARGS((
             HPLAI_T_panel *,
             const int,
             const int,
             HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_pamxswp
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -179,7 +315,16 @@ extern "C"
             const int,
             const int,
             HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
+    void HPLAI_pamxswpA
+        STDC_ARGS((
+            HPLAI_T_panel *,
+            const int,
+            const int,
+            const int,
+            HPLAI_T_AFLOAT *));
 
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_papancrN
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -187,6 +332,7 @@ extern "C"
             const int,
             const int,
             HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_papancrT
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -194,6 +340,7 @@ extern "C"
             const int,
             const int,
             HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_papanllN
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -201,6 +348,7 @@ extern "C"
             const int,
             const int,
             HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_papanllT
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -208,6 +356,7 @@ extern "C"
             const int,
             const int,
             HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_papanrlN
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -215,6 +364,7 @@ extern "C"
             const int,
             const int,
             HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_papanrlT
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -223,6 +373,7 @@ extern "C"
             const int,
             HPLAI_T_AFLOAT *));
 
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_parpancrN
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -230,6 +381,7 @@ extern "C"
             const int,
             const int,
             HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_parpancrT
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -237,6 +389,7 @@ extern "C"
             const int,
             const int,
             HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_parpanllN
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -244,6 +397,7 @@ extern "C"
             const int,
             const int,
             HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_parpanllT
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -251,6 +405,7 @@ extern "C"
             const int,
             const int,
             HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_parpanrlN
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -258,6 +413,7 @@ extern "C"
             const int,
             const int,
             HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_parpanrlT
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -266,13 +422,53 @@ extern "C"
             const int,
             HPLAI_T_AFLOAT *));
 
-    void HPLAI_pafact
+    template <typename HPLAI_T_AFLOAT>
+    void HPLAI_papanthN
+        STDC_ARGS((
+            HPLAI_T_panel *,
+            const int,
+            const int,
+            const int,
+            HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
+    void HPLAI_papanthT
+        STDC_ARGS((
+            HPLAI_T_panel *,
+            const int,
+            const int,
+            const int,
+            HPLAI_T_AFLOAT *));
+
+    template <typename HPLAI_T_AFLOAT>
+    void HPLAI_patourn
         STDC_ARGS((
             HPLAI_T_panel *));
+    template <typename HPLAI_T_AFLOAT>
+    void HPLAI_papantpN
+        STDC_ARGS((
+            HPLAI_T_panel *,
+            const int,
+            const int,
+            const int,
+            HPLAI_T_AFLOAT *));
+    template <typename HPLAI_T_AFLOAT>
+    void HPLAI_papantpT
+        STDC_ARGS((
+            HPLAI_T_panel *,
+            const int,
+            const int,
+            const int,
+            HPLAI_T_AFLOAT *));
 
-#ifdef __cplusplus
-}
-#endif
+    template <typename HPLAI_T_AFLOAT>
+    int HPLAI_panopiv
+        STDC_ARGS((
+            HPLAI_T_panel *));
+
+    template <typename HPLAI_T_AFLOAT>
+    void HPLAI_pafact
+        STDC_ARGS((
+            HPLAI_T_panel *));
 
 #endif
 /*
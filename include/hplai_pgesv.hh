@@ -37,16 +37,13 @@
 #include "hplai_comm.hh"
 #include "hplai_panel.hh"
 #include "hplai_pfact.hh"
-
-#ifdef __cplusplus
-extern "C"
-{
-#endif
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_pipid
         STDC_ARGS((
             HPLAI_T_panel *,
             int *,
             int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_plindx0
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -55,12 +52,14 @@ extern "C"
             int *,
             int *,
             int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_palaswp00N
         STDC_ARGS((
             HPLAI_T_panel *,
             int *,
             HPLAI_T_panel *,
             const int));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_palaswp00T
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -69,7 +68,17 @@ extern "C"
             const int));
 
 #define HPLAI_perm HPL_perm
+/*
+ * A negative lookahead depth selects the task graph driver HPLAI_pagesvT
+ */
+#define HPLAI_DEPTH_DYNAMIC (-1)
+/*
+ * Seeds of the random butterflies U and V of the transformation U'AV
+ */
+#define HPLAI_RBT_SEEDU 1
+#define HPLAI_RBT_SEEDV 2
 #define HPLAI_logsort HPL_logsort
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_plindx10
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -78,6 +87,7 @@ extern "C"
             int *,
             int *,
             int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_plindx1
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -91,6 +101,7 @@ extern "C"
             int *,
             int *,
             int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_spreadN
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -104,6 +115,7 @@ extern "C"
             const int *,
             const int *,
             const int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_spreadT
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -117,6 +129,7 @@ extern "C"
             const int *,
             const int *,
             const int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_equil
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -130,6 +143,7 @@ extern "C"
             const int *,
             const int *,
             int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_rollN
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -141,6 +155,7 @@ extern "C"
             const int *,
             const int *,
             const int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_rollT
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -152,37 +167,61 @@ extern "C"
             const int *,
             const int *,
             const int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_palaswp01N
         STDC_ARGS((
             HPLAI_T_panel *,
             int *,
             HPLAI_T_panel *,
             const int));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_palaswp01T
         STDC_ARGS((
             HPLAI_T_panel *,
             int *,
             HPLAI_T_panel *,
             const int));
+    template <typename HPLAI_T_AFLOAT>
+    int HPLAI_pnoswp
+        STDC_ARGS((
+            HPLAI_T_panel *));
+    template <typename HPLAI_T_AFLOAT>
+    void HPLAI_palaswp02N
+        STDC_ARGS((
+            HPLAI_T_panel *,
+            int *,
+            HPLAI_T_panel *,
+            const int));
+    template <typename HPLAI_T_AFLOAT>
+    void HPLAI_palaswp02T
+        STDC_ARGS((
+            HPLAI_T_panel *,
+            int *,
+            HPLAI_T_panel *,
+            const int));
 
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_paupdateNN
         STDC_ARGS((
             HPLAI_T_panel *,
             int *,
             HPLAI_T_panel *,
             const int));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_paupdateNT
         STDC_ARGS((
             HPLAI_T_panel *,
             int *,
             HPLAI_T_panel *,
             const int));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_paupdateTN
         STDC_ARGS((
             HPLAI_T_panel *,
             int *,
             HPLAI_T_panel *,
             const int));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_paupdateTT
         STDC_ARGS((
             HPLAI_T_panel *,
@@ -190,42 +229,73 @@ extern "C"
             HPLAI_T_panel *,
             const int));
 
-    void HPLAI_pdgesv
+    void HPLAI_pdoper_stored
+        STDC_ARGS((
+            const HPL_T_grid *,
+            const HPL_T_pmat *,
+            const double,
+            const double *,
+            const double,
+            double *));
+
+    template <typename HPLAI_T_AFLOAT>
+    int HPLAI_pdgesv
         STDC_ARGS((
             HPL_T_grid *,
             HPLAI_T_palg *,
             HPL_T_pmat *));
 
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_pagesv0
         STDC_ARGS((
             HPL_T_grid *,
             HPLAI_T_palg *,
             HPLAI_T_pmat *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_pagesvK1
         STDC_ARGS((
             HPL_T_grid *,
             HPLAI_T_palg *,
             HPLAI_T_pmat *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_pagesvK2
         STDC_ARGS((
             HPL_T_grid *,
             HPLAI_T_palg *,
             HPLAI_T_pmat *));
+    template <typename HPLAI_T_AFLOAT>
+    void HPLAI_pagesvT
+        STDC_ARGS((
+            HPL_T_grid *,
+            HPLAI_T_palg *,
+            HPLAI_T_pmat *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_pagesv
         STDC_ARGS((
             HPL_T_grid *,
             HPLAI_T_palg *,
             HPLAI_T_pmat *));
 
+    template <typename HPLAI_T_AFLOAT>
+    void HPLAI_parbt
+        STDC_ARGS((
+            HPL_T_grid *,
+            const blas::Side,
+            const blas::Op,
+            const int,
+            const int,
+            const int,
+            const int,
+            const int,
+            HPLAI_T_AFLOAT *,
+            const int));
+
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_patrsv
         STDC_ARGS((
             HPL_T_grid *,
             HPLAI_T_pmat *));
 
-#ifdef __cplusplus
-}
-#endif
-
 #endif
 /*
  * End of hplai_pgesv.hh
@@ -35,11 +35,6 @@
  * Function prototypes
  * ---------------------------------------------------------------------
  */
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
     void HPLAI_pdmatgen
         STDC_ARGS((
             const HPL_T_grid *,
@@ -49,10 +44,34 @@ extern "C"
             double *,
             const int,
             const int));
+    void HPLAI_pdrhsgen
+        STDC_ARGS((
+            const HPL_T_grid *,
+            const int,
+            const int,
+            double *,
+            const int));
+    void HPLAI_pdoper_analytic
+        STDC_ARGS((
+            const HPL_T_grid *,
+            const HPL_T_pmat *,
+            const double,
+            const double *,
+            const double,
+            double *));
 
-#ifdef __cplusplus
-}
-#endif
+/*
+ * Generate the matrix directly in precision T (float or double)
+ */
+template <typename T>
+void HPLAI_pmatgen(
+    const HPL_T_grid *,
+    const int,
+    const int,
+    const int,
+    T *,
+    const int,
+    const int);
 
 #endif
 /*
@@ -30,11 +30,6 @@
  */
 
 #include "hplai_misc.hh"
-
-#ifdef __cplusplus
-extern "C"
-{
-#endif
 /*
  * ---------------------------------------------------------------------
  * Data Structures
@@ -43,6 +38,20 @@ extern "C"
 #define HPLAI_S_test HPL_S_test
 #define HPLAI_T_test HPL_T_test
 
+    typedef enum
+    {
+        HPLAI_PREC_LFLOAT = 0, /* factorization in HPLAI_T_LFLOAT */
+        HPLAI_PREC_DOUBLE = 1  /* factorization in double */
+    } HPLAI_T_PREC;
+
+    typedef struct HPLAI_S_tres
+    {
+        double time;   /* wall time of HPLAI_pdgesv */
+        double gflops; /* Gflops of HPLAI_pdgesv */
+        double resid;  /* scaled residual, negative if not checked */
+        int iter;      /* # of GMRES iterations of the refinement */
+    } HPLAI_T_tres;
+
 /*
  * ---------------------------------------------------------------------
  * #define macro constants for testing only
@@ -100,18 +109,23 @@ extern "C"
             int *,
             int *,
             int *,
+            int *,
+            HPLAI_T_OPER *,
+            int *,
+            HPLAI_T_PREC *,
+            int *,
+            int *,
+            int *,
             int *));
+    template <typename HPLAI_T_AFLOAT>
     void HPLAI_pdtest
         STDC_ARGS((
             HPLAI_T_test *,
             HPL_T_grid *,
             HPLAI_T_palg *,
             const int,
-            const int));
-
-#ifdef __cplusplus
-}
-#endif
+            const int,
+            HPLAI_T_tres *));
 
 #endif
 /*
@@ -45,11 +45,7 @@
 #define HPL_LACPY_LOG2_N_DEPTH 1
 #endif
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_alacpy(
         const int M,
@@ -505,6 +501,4 @@ const int LDB;
 #endif
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_alacpy);
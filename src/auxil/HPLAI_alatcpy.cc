@@ -45,11 +45,7 @@
 #define HPL_LATCPY_LOG2_N_DEPTH 1
 #endif
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_alatcpy(
         const int M,
@@ -755,6 +751,4 @@ const int LDB;
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_alatcpy);
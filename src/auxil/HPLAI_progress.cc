@@ -0,0 +1,271 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+#include <sys/resource.h>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+    /*
+ * Progress report state:  INTERVAL is the reporting period in seconds,
+ * FP the output stream.  START, LAST and JLAST describe the beginning of
+ * the factorization and of the current reporting interval.
+ */
+    static struct
+    {
+        FILE *fp;
+        double interval;
+        double start;
+        double last;
+        int jlast;
+        int on;
+    } HPLAI_progress = {};
+
+    static double HPLAI_progress_mem(void)
+    {
+        /*
+ * Memory in use by this process in MB: the resident set size when it
+ * is available, the peak resident set size otherwise
+ */
+        struct rusage usage;
+#ifdef __linux__
+        FILE *fp;
+        long pages, rss;
+
+        fp = fopen("/proc/self/statm", "r");
+        if (fp != NULL)
+        {
+            if (fscanf(fp, "%ld %ld", &pages, &rss) == 2)
+            {
+                (void)fclose(fp);
+                return ((double)(rss) * (double)(sysconf(_SC_PAGESIZE)) /
+                        1048576.0);
+            }
+            (void)fclose(fp);
+        }
+#endif
+        (void)getrusage(RUSAGE_SELF, &usage);
+        return ((double)(usage.ru_maxrss) / 1024.0);
+    }
+
+#ifdef STDC_HEADERS
+    int HPLAI_progress_init(
+        const double INTERVAL,
+        const char *NAME)
+#else
+int HPLAI_progress_init(INTERVAL, NAME)
+    const double INTERVAL;
+const char *NAME;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_progress_init  enables  the progress report of the factoriza-
+ * tion:  every INTERVAL seconds,  process (0,0) writes the column being
+ * factored, the instantaneous and average Gflops, the fraction of the
+ * interval spent in the update, the panel factorization and waiting for
+ * the panel broadcast, its memory in use and an estimate of the time to
+ * completion based on the remaining (N-j)^3 work at the current rate.
+ * The report goes to the file NAME (appended), or to stdout when NAME
+ * is NULL.  It returns 1 if the report is enabled, 0 otherwise.
+ *
+ * Arguments
+ * =========
+ *
+ * INTERVAL (local input)                const double
+ *         On entry,  INTERVAL  is the reporting period in seconds.  The
+ *         report is disabled if it is not positive.
+ *
+ * NAME    (local input)                 const char *
+ *         On entry, NAME is the name of the output file, or NULL.
+ *
+ * ---------------------------------------------------------------------
+ */
+        int rank;
+
+        if ((INTERVAL <= HPL_rzero) || (HPLAI_progress.on != 0))
+            return (HPLAI_progress.on);
+
+        HPLAI_progress.fp = stdout;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        if ((rank == 0) && (NAME != NULL) && (*NAME != '\0'))
+        {
+            HPLAI_progress.fp = fopen(NAME, "a");
+            if (HPLAI_progress.fp == NULL)
+            {
+                HPLAI_pwarn(stderr, __LINE__, "HPLAI_progress_init",
+                            "Cannot open %s, reporting to stdout", NAME);
+                HPLAI_progress.fp = stdout;
+            }
+        }
+        HPLAI_progress.interval = INTERVAL;
+        HPLAI_progress.on = 1;
+        HPLAI_trace_account(1);
+        return (1);
+        /*
+ * End of HPLAI_progress_init
+ */
+    }
+
+#ifdef STDC_HEADERS
+    void HPLAI_progress_finalize(void)
+#else
+void HPLAI_progress_finalize()
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_progress_finalize disables the progress report.
+ *
+ * ---------------------------------------------------------------------
+ */
+        if (HPLAI_progress.on == 0)
+            return;
+
+        if ((HPLAI_progress.fp != stdout) && (HPLAI_progress.fp != NULL))
+            (void)fclose(HPLAI_progress.fp);
+        HPLAI_progress.fp = NULL;
+        HPLAI_progress.on = 0;
+        HPLAI_trace_account(0);
+        /*
+ * End of HPLAI_progress_finalize
+ */
+    }
+
+#ifdef STDC_HEADERS
+    void HPLAI_progress_start(void)
+#else
+void HPLAI_progress_start()
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_progress_start marks the beginning of a factorization.
+ *
+ * ---------------------------------------------------------------------
+ */
+        double time[HPLAI_TRACE_NEVENT];
+
+        if (HPLAI_progress.on == 0)
+            return;
+
+        HPLAI_progress.start = HPLAI_progress.last = HPL_ptimer_walltime();
+        HPLAI_progress.jlast = 0;
+        HPLAI_trace_stat(time);
+        /*
+ * End of HPLAI_progress_start
+ */
+    }
+
+#ifdef STDC_HEADERS
+    void HPLAI_progress_report(
+        const HPL_T_grid *GRID,
+        const int N,
+        const int J)
+#else
+void HPLAI_progress_report(GRID, N, J)
+    const HPL_T_grid *GRID;
+const int N;
+const int J;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_progress_report is called by the factorization drivers at the
+ * beginning of every iteration. Process (0,0) writes a report line when
+ * the reporting interval has elapsed, or when J reaches N.
+ *
+ * Arguments
+ * =========
+ *
+ * GRID    (local input)                 const HPL_T_grid *
+ *         On entry,  GRID  points  to the data structure containing the
+ *         process grid information.
+ *
+ * N       (global input)                const int
+ *         On entry,  N  specifies the order of the matrix being factored.
+ *
+ * J       (global input)                const int
+ *         On entry, J is the global index of the current column.
+ *
+ * ---------------------------------------------------------------------
+ */
+        double time[HPLAI_TRACE_NEVENT];
+        double dt, eta, flops, now, rate, total, wall;
+
+        if ((HPLAI_progress.on == 0) || (GRID->myrow != 0) ||
+            (GRID->mycol != 0))
+            return;
+
+        now = HPL_ptimer_walltime();
+        dt = now - HPLAI_progress.last;
+        if ((dt < HPLAI_progress.interval) && (J < N))
+            return;
+        /*
+ * 2/3 (N-j)^3 flops remain at column j: the rates are those of the last
+ * interval and of the factorization so far
+ */
+        flops = ((double)(N - HPLAI_progress.jlast) * (double)(N - HPLAI_progress.jlast) *
+                     (double)(N - HPLAI_progress.jlast) -
+                 (double)(N - J) * (double)(N - J) * (double)(N - J)) /
+                1.5;
+        total = (double)(N) * (double)(N) * (double)(N) -
+                (double)(N - J) * (double)(N - J) * (double)(N - J);
+        wall = now - HPLAI_progress.start;
+        rate = (dt > HPL_rzero ? flops / dt : HPL_rzero);
+        eta = (rate > HPL_rzero ? (double)(N - J) * (double)(N - J) * (double)(N - J) / 1.5 / rate
+                                : HPL_rzero);
+        if (dt <= HPL_rzero)
+            dt = 1.0;
+
+        HPLAI_trace_stat(time);
+        HPL_fprintf(HPLAI_progress.fp,
+                    "Column=%09d Fraction=%5.1f%% Time=%10.1f Gflops=%9.3e (avg %9.3e) "
+                    "Update=%5.1f%% Pfact=%5.1f%% Wait=%5.1f%% Mem=%9.1fMB ETA=%10.1f\n",
+                    J, 100.0 * (double)(J) / (double)(N), wall, rate / 1.0e+9,
+                    (wall > HPL_rzero ? total / 1.5 / wall / 1.0e+9 : HPL_rzero),
+                    100.0 * (time[HPLAI_TRACE_LASWP] + time[HPLAI_TRACE_TRSM] +
+                             time[HPLAI_TRACE_GEMM]) /
+                        dt,
+                    100.0 * time[HPLAI_TRACE_PFACT] / dt,
+                    100.0 * time[HPLAI_TRACE_BCAST] / dt, HPLAI_progress_mem(), eta);
+        (void)fflush(HPLAI_progress.fp);
+
+        HPLAI_progress.last = now;
+        HPLAI_progress.jlast = J;
+        /*
+ * End of HPLAI_progress_report
+ */
+    }
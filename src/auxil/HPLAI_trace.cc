@@ -0,0 +1,373 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+    /*
+ * One timeline event: EVENT ran from T0 to T1 (seconds since the
+ * origin) on thread TID of this process, ARG is the global column of
+ * the panel it belongs to (or the restart number of the refinement).
+ */
+    typedef struct HPLAI_S_tevent
+    {
+        double t0;
+        double t1;
+        int event;
+        int tid;
+        int arg;
+    } HPLAI_T_tevent;
+
+    /*
+ * The recorder keeps the last SIZE events in a ring buffer, NEXT is the
+ * total number of events recorded so far.  When ACC is set, the time of
+ * every event is also added to PHASE, see HPLAI_trace_stat.
+ */
+    static struct
+    {
+        HPLAI_T_tevent *buf;
+        char *file;
+        double origin;
+        double phase[HPLAI_TRACE_NEVENT];
+        long next;
+        int size;
+        int rank;
+        int on;
+        int acc;
+    } HPLAI_trace = {};
+
+    static const char *HPLAI_trace_name[HPLAI_TRACE_NEVENT] = {
+        "pfact", "mxswp", "bcast", "laswp", "trsm", "gemm", "refine"};
+
+#ifdef STDC_HEADERS
+    int HPLAI_trace_init(
+        const char *PREFIX,
+        const int NEVENT)
+#else
+int HPLAI_trace_init(PREFIX, NEVENT)
+    const char *PREFIX;
+const int NEVENT;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_trace_init enables the timeline recorder of this process. The
+ * last NEVENT events are kept in memory and written by HPLAI_trace_fi-
+ * nalize to the file PREFIX.<rank>.json. It returns 1 if the recorder
+ * is enabled, 0 otherwise (PREFIX is NULL or NEVENT is not positive).
+ * This routine is collective over MPI_COMM_WORLD when it is enabled:
+ * the time origin is taken right after a barrier,  so that the traces
+ * of all processes share the same time axis.
+ *
+ * Arguments
+ * =========
+ *
+ * PREFIX  (local input)                 const char *
+ *         On entry, PREFIX is the prefix of the trace file name.
+ *
+ * NEVENT  (local input)                 const int
+ *         On entry, NEVENT is the capacity of the ring buffer.
+ *
+ * ---------------------------------------------------------------------
+ */
+        size_t len;
+
+        if ((PREFIX == NULL) || (*PREFIX == '\0') || (NEVENT <= 0) ||
+            (HPLAI_trace.on != 0))
+            return (HPLAI_trace.on);
+
+        MPI_Comm_rank(MPI_COMM_WORLD, &HPLAI_trace.rank);
+        MPI_Barrier(MPI_COMM_WORLD);
+        HPLAI_trace.origin = HPL_ptimer_walltime();
+
+        len = strlen(PREFIX) + 32;
+        HPLAI_trace.file = (char *)malloc(len);
+        HPLAI_trace.buf = (HPLAI_T_tevent *)malloc((size_t)(NEVENT) *
+                                                   sizeof(HPLAI_T_tevent));
+        if ((HPLAI_trace.file == NULL) || (HPLAI_trace.buf == NULL))
+        {
+            if (HPLAI_trace.file)
+                free(HPLAI_trace.file);
+            if (HPLAI_trace.buf)
+                free(HPLAI_trace.buf);
+            HPLAI_trace.file = NULL;
+            HPLAI_trace.buf = NULL;
+            HPLAI_pwarn(stderr, __LINE__, "HPLAI_trace_init",
+                        "Memory allocation failed, tracing disabled");
+            return (0);
+        }
+        (void)snprintf(HPLAI_trace.file, len, "%s.%d.json", PREFIX,
+                       HPLAI_trace.rank);
+        HPLAI_trace.size = NEVENT;
+        HPLAI_trace.next = 0;
+        HPLAI_trace.on = 1;
+        return (1);
+        /*
+ * End of HPLAI_trace_init
+ */
+    }
+
+#ifdef STDC_HEADERS
+    void HPLAI_trace_finalize(void)
+#else
+void HPLAI_trace_finalize()
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_trace_finalize writes the recorded events of this process in
+ * the Chrome trace event format, and disables the recorder.  The file
+ * of rank 0 opens the JSON array, the others only contain events, so
+ * that the per-process files concatenated in rank order,
+ *
+ *    cat PREFIX.*.json > PREFIX.json
+ *
+ * form a single trace of the whole job, which chrome://tracing and
+ * https://ui.perfetto.dev load as is. Each process is shown as a pid,
+ * each thread as a tid, the events are in microseconds.
+ *
+ * ---------------------------------------------------------------------
+ */
+        HPLAI_T_tevent *e;
+        FILE *fp;
+        long i, first;
+
+        if (HPLAI_trace.on == 0)
+            return;
+        HPLAI_trace.on = 0;
+
+        fp = fopen(HPLAI_trace.file, "w");
+        if (fp == NULL)
+        {
+            HPLAI_pwarn(stderr, __LINE__, "HPLAI_trace_finalize",
+                        "Cannot open %s", HPLAI_trace.file);
+        }
+        else
+        {
+            first = HPLAI_trace.next - HPLAI_trace.size;
+            if (first < 0)
+                first = 0;
+
+            if (HPLAI_trace.rank == 0)
+                (void)fprintf(fp, "[\n");
+            (void)fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+                              "\"args\":{\"name\":\"rank %d\"}},\n",
+                          HPLAI_trace.rank, HPLAI_trace.rank);
+            (void)fprintf(fp, "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%d,"
+                              "\"args\":{\"sort_index\":%d}},\n",
+                          HPLAI_trace.rank, HPLAI_trace.rank);
+            if (first > 0)
+                (void)fprintf(fp, "{\"name\":\"dropped\",\"ph\":\"i\",\"s\":\"p\",\"pid\":%d,"
+                                  "\"tid\":0,\"ts\":0,\"args\":{\"events\":%ld}},\n",
+                              HPLAI_trace.rank, first);
+
+            for (i = first; i < HPLAI_trace.next; i++)
+            {
+                e = HPLAI_trace.buf + (i % HPLAI_trace.size);
+                (void)fprintf(fp, "{\"name\":\"%s\",\"cat\":\"hplai\",\"ph\":\"X\","
+                                  "\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                                  "\"args\":{\"col\":%d}},\n",
+                              HPLAI_trace_name[e->event], HPLAI_trace.rank, e->tid,
+                              1.0e+6 * e->t0, 1.0e+6 * (e->t1 - e->t0), e->arg);
+            }
+            (void)fclose(fp);
+        }
+
+        free(HPLAI_trace.buf);
+        free(HPLAI_trace.file);
+        HPLAI_trace.buf = NULL;
+        HPLAI_trace.file = NULL;
+        /*
+ * End of HPLAI_trace_finalize
+ */
+    }
+
+#ifdef STDC_HEADERS
+    double HPLAI_trace_time(void)
+#else
+double HPLAI_trace_time()
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_trace_time returns the start time of an event to be recorded,
+ * or 0 without reading the clock when neither the recorder nor the
+ * accounting are enabled.
+ *
+ * ---------------------------------------------------------------------
+ */
+        if ((HPLAI_trace.on == 0) && (HPLAI_trace.acc == 0))
+            return (HPL_rzero);
+        return (HPL_ptimer_walltime() - HPLAI_trace.origin);
+        /*
+ * End of HPLAI_trace_time
+ */
+    }
+
+#ifdef STDC_HEADERS
+    double HPLAI_trace_event(
+        const HPLAI_T_TRACE EVENT,
+        const double T0,
+        const int ARG)
+#else
+double HPLAI_trace_event(EVENT, T0, ARG)
+    const HPLAI_T_TRACE EVENT;
+const double T0;
+const int ARG;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_trace_event records that EVENT ran from T0, as returned by
+ * HPLAI_trace_time or by a previous HPLAI_trace_event, until now.  It
+ * returns the end time, so that back to back events can be chained
+ * with a single clock reading each. It may be called concurrently by
+ * the threads of an OpenMP team.
+ *
+ * Arguments
+ * =========
+ *
+ * EVENT   (local input)                 const HPLAI_T_TRACE
+ *         On entry, EVENT is the kind of the event.
+ *
+ * T0      (local input)                 const double
+ *         On entry, T0 is the start time of the event.
+ *
+ * ARG     (local input)                 const int
+ *         On entry, ARG is the global column of the panel the event
+ *         belongs to, or the restart number of the refinement.
+ *
+ * ---------------------------------------------------------------------
+ */
+        HPLAI_T_tevent *e;
+        double t1;
+        long i;
+
+        if ((HPLAI_trace.on == 0) && (HPLAI_trace.acc == 0))
+            return (HPL_rzero);
+
+        t1 = HPL_ptimer_walltime() - HPLAI_trace.origin;
+        if (HPLAI_trace.acc != 0)
+        {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+            HPLAI_trace.phase[EVENT] += t1 - T0;
+        }
+        if (HPLAI_trace.on == 0)
+            return (t1);
+#ifdef _OPENMP
+#pragma omp atomic capture
+#endif
+        i = HPLAI_trace.next++;
+
+        e = HPLAI_trace.buf + (i % HPLAI_trace.size);
+        e->t0 = T0;
+        e->t1 = t1;
+        e->event = (int)(EVENT);
+#ifdef _OPENMP
+        e->tid = omp_get_thread_num();
+#else
+        e->tid = 0;
+#endif
+        e->arg = ARG;
+        return (t1);
+        /*
+ * End of HPLAI_trace_event
+ */
+    }
+
+#ifdef STDC_HEADERS
+    void HPLAI_trace_account(
+        const int ON)
+#else
+void HPLAI_trace_account(ON)
+    const int ON;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_trace_account enables (ON non-zero) or disables the accounting
+ * of the time spent in every kind of event,  independently  of the
+ * recorder. The accumulated times are returned by HPLAI_trace_stat.
+ *
+ * ---------------------------------------------------------------------
+ */
+        HPLAI_trace.acc = (ON != 0 ? 1 : 0);
+        /*
+ * End of HPLAI_trace_account
+ */
+    }
+
+#ifdef STDC_HEADERS
+    void HPLAI_trace_stat(
+        double *TIME)
+#else
+void HPLAI_trace_stat(TIME)
+    double *TIME;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_trace_stat returns the time spent by this process in every kind
+ * of event since the previous call, and resets it.  Nested events are
+ * counted in both (mxswp is part of pfact),  and the times of the
+ * threads of an OpenMP team add up.
+ *
+ * Arguments
+ * =========
+ *
+ * TIME    (local output)                double *
+ *         On entry, TIME is an array of dimension HPLAI_TRACE_NEVENT. On
+ *         exit, TIME[e] is the time in seconds spent in the events e.
+ *
+ * ---------------------------------------------------------------------
+ */
+        int i;
+
+        for (i = 0; i < HPLAI_TRACE_NEVENT; i++)
+        {
+            TIME[i] = HPLAI_trace.phase[i];
+            HPLAI_trace.phase[i] = HPL_rzero;
+        }
+        /*
+ * End of HPLAI_trace_stat
+ */
+    }
@@ -244,7 +244,7 @@ void blas::trsv<double, double>(
 
 static blas::Queue *HPLAI_DEVICE_BLASPP_QUEUE = NULL;
 static int64_t HPLAI_DEVICE_BLASPP_BUFFER_SIZE = 0;
-static HPLAI_T_AFLOAT *HPLAI_DEVICE_BLASPP_BUFFER = NULL;
+static HPLAI_T_LFLOAT *HPLAI_DEVICE_BLASPP_BUFFER = NULL;
 
 static void HPLAI_DEVICE_BLASPP_BUFFER_RESIZE(int64_t NEW_SIZE)
 {
@@ -256,7 +256,7 @@ static void HPLAI_DEVICE_BLASPP_BUFFER_RESIZE(int64_t NEW_SIZE)
     HPLAI_DEVICE_BLASPP_BUFFER_SIZE = NEW_SIZE;
     if (HPLAI_DEVICE_BLASPP_BUFFER_SIZE > 0)
     {
-        HPLAI_DEVICE_BLASPP_BUFFER = blas::device_malloc<HPLAI_T_AFLOAT>(
+        HPLAI_DEVICE_BLASPP_BUFFER = blas::device_malloc<HPLAI_T_LFLOAT>(
             HPLAI_DEVICE_BLASPP_BUFFER_SIZE);
         if (HPLAI_DEVICE_BLASPP_BUFFER == NULL)
             HPLAI_pabort(
@@ -268,6 +268,76 @@ static void HPLAI_DEVICE_BLASPP_BUFFER_RESIZE(int64_t NEW_SIZE)
 
 #endif
 
+#if defined(HPLAI_SOFT_LFLOAT)
+
+/*
+ * HPLAI_T_LFLOAT is a software 16-bit type:  the level 3 kernels unpack
+ * their operands to float,  call the float blaspp routines,  and round the
+ * result back once.  The level 1 and 2 kernels compute in float directly.
+ * Workspaces are allocated per call, so these kernels are thread safe.
+ */
+#if !defined(HPLAI_SOFT_GEMM_MB)
+#define HPLAI_SOFT_GEMM_MB 512
+#endif
+
+#if !defined(HPLAI_SOFT_GEMM_NB)
+#define HPLAI_SOFT_GEMM_NB 512
+#endif
+
+static float *HPLAI_soft_malloc(const size_t LEN, const char *SRNAME)
+{
+    float *W = (float *)malloc((LEN > 0 ? LEN : 1) * sizeof(float));
+    if (W == NULL)
+        HPLAI_pabort(__LINE__, SRNAME, "Memory allocation failed");
+    return W;
+}
+
+/*
+ * F (M by N, leading dimension LDF) := op( A ),  where op( A ) is A or its
+ * transpose.
+ */
+static void HPLAI_soft_unpack(
+    const blas::Op TRANS,
+    const int64_t M,
+    const int64_t N,
+    const HPLAI_T_LFLOAT *A,
+    const int64_t LDA,
+    float *F,
+    const int64_t LDF)
+{
+    int64_t i, j;
+
+    if (TRANS == blas::Op::NoTrans)
+    {
+        for (j = 0; j < N; j++)
+            for (i = 0; i < M; i++)
+                F[i + j * LDF] = A[i + j * LDA];
+    }
+    else
+    {
+        for (j = 0; j < N; j++)
+            for (i = 0; i < M; i++)
+                F[i + j * LDF] = A[j + i * LDA];
+    }
+}
+
+static void HPLAI_soft_pack(
+    const int64_t M,
+    const int64_t N,
+    const float *F,
+    const int64_t LDF,
+    HPLAI_T_LFLOAT *A,
+    const int64_t LDA)
+{
+    int64_t i, j;
+
+    for (j = 0; j < N; j++)
+        for (i = 0; i < M; i++)
+            A[i + j * LDA] = F[i + j * LDF];
+}
+
+#endif
+
 template <>
 int64_t blas::iamax<float>(
     int64_t n,
@@ -324,26 +394,26 @@ static cudaDataType_t HPLAI_GET_cudaDataType_t(double t)
 #endif
 
 template <>
-void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+void blas::gemm<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
     blas::Layout layout,
     blas::Op TRANSA,
     blas::Op TRANSB,
     int64_t M,
     int64_t N,
     int64_t K,
-    blas::scalar_type<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT> ALPHA,
-    HPLAI_T_AFLOAT const *A,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> ALPHA,
+    HPLAI_T_LFLOAT const *A,
     int64_t LDA,
-    HPLAI_T_AFLOAT const *B,
+    HPLAI_T_LFLOAT const *B,
     int64_t LDB,
-    blas::scalar_type<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT> BETA,
-    HPLAI_T_AFLOAT *C,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> BETA,
+    HPLAI_T_LFLOAT *C,
     int64_t LDC)
 {
     //HPLAI_pabort( __LINE__, "blas::gemm", "Use HPLAI_DEVICE_BLASPP_GEMM" );
     if (layout != blas::Layout::ColMajor)
     {
-        blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+        blas::gemm<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
             blas::Layout::ColMajor,
             TRANSB, TRANSA, N, M, K, ALPHA, B, LDB, A, LDA, BETA, C, LDC);
         return;
@@ -351,16 +421,16 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
     int64_t i, j;
 
     if ((M == 0) || (N == 0) ||
-        (((ALPHA == HPLAI_rzero) || (K == 0)) &&
-         (BETA == HPLAI_rone)))
+        (((ALPHA == (float)HPL_rzero) || (K == 0)) &&
+         (BETA == (float)HPL_rone)))
         return;
 
-    if (ALPHA == HPLAI_rzero && BETA == HPLAI_rzero)
+    if (ALPHA == (float)HPL_rzero && BETA == (float)HPL_rzero)
     {
         for (j = 0; j < N; j++)
         {
             for (i = 0; i < M; i++)
-                *(C + i + j * LDC) = HPLAI_rzero;
+                *(C + i + j * LDC) = (float)HPL_rzero;
         }
         return;
     }
@@ -416,17 +486,17 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
     if (HPLAI_DEVICE_BLASPP_BUFFER_SIZE < dsC + dsB + dsA)
         HPLAI_DEVICE_BLASPP_BUFFER_RESIZE(dsC + dsB + dsA);
 
-    HPLAI_T_AFLOAT *dC = HPLAI_DEVICE_BLASPP_BUFFER;
-    HPLAI_T_AFLOAT *dB = dC + dsC;
-    HPLAI_T_AFLOAT *dA = dB + dsB;
+    HPLAI_T_LFLOAT *dC = HPLAI_DEVICE_BLASPP_BUFFER;
+    HPLAI_T_LFLOAT *dB = dC + dsC;
+    HPLAI_T_LFLOAT *dA = dB + dsB;
 #if defined(HPLAI_DEVICE_BLASPP_GEMM_MULTISTREAM)
     HPLAI_DEVICE_BLASPP_QUEUE->fork();
 #endif
-    blas::device_setmatrix<HPLAI_T_AFLOAT>(rA, cA, A, LDA, dA, dLDA, *HPLAI_DEVICE_BLASPP_QUEUE);
+    blas::device_setmatrix<HPLAI_T_LFLOAT>(rA, cA, A, LDA, dA, dLDA, *HPLAI_DEVICE_BLASPP_QUEUE);
 #if defined(HPLAI_DEVICE_BLASPP_GEMM_MULTISTREAM)
     HPLAI_DEVICE_BLASPP_QUEUE->revolve();
 #endif
-    blas::device_setmatrix<HPLAI_T_AFLOAT>(rB, cB, B, LDB, dB, dLDB, *HPLAI_DEVICE_BLASPP_QUEUE);
+    blas::device_setmatrix<HPLAI_T_LFLOAT>(rB, cB, B, LDB, dB, dLDB, *HPLAI_DEVICE_BLASPP_QUEUE);
 #if defined(HPLAI_DEVICE_BLASPP_GEMM_MULTISTREAM)
     HPLAI_DEVICE_BLASPP_QUEUE->revolve();
 #endif
@@ -445,13 +515,13 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
         BETA,
         C,
         LDC);
-    blas::device_setmatrix<HPLAI_T_AFLOAT>(rC, cC, C, LDC, dC, dLDC, *HPLAI_DEVICE_BLASPP_QUEUE);
+    blas::device_setmatrix<HPLAI_T_LFLOAT>(rC, cC, C, LDC, dC, dLDC, *HPLAI_DEVICE_BLASPP_QUEUE);
 #if defined(HPLAI_DEVICE_BLASPP_GEMM_MULTISTREAM)
     HPLAI_DEVICE_BLASPP_QUEUE->join();
 #endif
 
 #if defined(HPLAI_CUBLASGEMMEX_COMPUTETYPE)
-    HPLAI_T_AFLOAT rone = HPLAI_rone;
+    HPLAI_T_LFLOAT rone = (float)HPL_rone;
     cublasGemmEx(
         HPLAI_DEVICE_BLASPP_QUEUE->handle(),
         HPLAI_op2cublas(TRANSA),
@@ -461,14 +531,14 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
         K1,
         &ALPHA,
         dA,
-        HPLAI_GET_cudaDataType_t(HPLAI_rzero),
+        HPLAI_GET_cudaDataType_t((float)HPL_rzero),
         dLDA,
         dB,
-        HPLAI_GET_cudaDataType_t(HPLAI_rzero),
+        HPLAI_GET_cudaDataType_t((float)HPL_rzero),
         dLDB,
         &rone,
         dC,
-        HPLAI_GET_cudaDataType_t(HPLAI_rzero),
+        HPLAI_GET_cudaDataType_t((float)HPL_rzero),
         dLDC,
         HPLAI_CUBLASGEMMEX_COMPUTETYPE,
         CUBLAS_GEMM_DEFAULT);
@@ -485,13 +555,13 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
         dLDA,
         dB,
         dLDB,
-        HPLAI_rone,
+        (float)HPL_rone,
         dC,
         dLDC,
         *HPLAI_DEVICE_BLASPP_QUEUE);
 #endif
 
-    blas::device_getmatrix<HPLAI_T_AFLOAT>(rC, cC, dC, dLDC, C, LDC, *HPLAI_DEVICE_BLASPP_QUEUE);
+    blas::device_getmatrix<HPLAI_T_LFLOAT>(rC, cC, dC, dLDC, C, LDC, *HPLAI_DEVICE_BLASPP_QUEUE);
 
     blas::gemm(
         layout,
@@ -896,32 +966,32 @@ static void HPLAI_ACL_MatMul(
 }
 
 template <>
-void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+void blas::gemm<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
     blas::Layout layout,
     blas::Op TRANSA,
     blas::Op TRANSB,
     int64_t M,
     int64_t N,
     int64_t K,
-    blas::scalar_type<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT> ALPHA,
-    HPLAI_T_AFLOAT const *A,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> ALPHA,
+    HPLAI_T_LFLOAT const *A,
     int64_t LDA,
-    HPLAI_T_AFLOAT const *B,
+    HPLAI_T_LFLOAT const *B,
     int64_t LDB,
-    blas::scalar_type<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT> BETA,
-    HPLAI_T_AFLOAT *C,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> BETA,
+    HPLAI_T_LFLOAT *C,
     int64_t LDC)
 {
     if (layout != blas::Layout::RowMajor)
     {
-        blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+        blas::gemm<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
             blas::Layout::RowMajor,
             TRANSB, TRANSA, N, M, K, ALPHA, B, LDB, A, LDA, BETA, C, LDC);
         return;
     }
     if ((M == 0) || (N == 0) ||
-        (((ALPHA == HPLAI_rzero) || (K == 0)) &&
-         (BETA == HPLAI_rone)))
+        (((ALPHA == (float)HPL_rzero) || (K == 0)) &&
+         (BETA == (float)HPL_rone)))
         return;
 
 #if !defined(HPLAI_ACL_BLASPP_GEMM_USE_CPU)
@@ -960,7 +1030,7 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
         false,
         M1,
         K1,
-        HPLAI_GET_ACL_DataType(HPLAI_rzero),
+        HPLAI_GET_ACL_DataType((float)HPL_rzero),
         ACL_FORMAT_ND,
         ACL_FLOAT16,
         ACL_FORMAT_ND);
@@ -968,7 +1038,7 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
         false,
         K1,
         N1,
-        HPLAI_GET_ACL_DataType(HPLAI_rzero),
+        HPLAI_GET_ACL_DataType((float)HPL_rzero),
         ACL_FORMAT_ND,
         ACL_FLOAT16,
         ACL_FORMAT_ND);
@@ -990,14 +1060,14 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
         N1,
         ACL_FLOAT16,
         ACL_FORMAT_ND,
-        HPLAI_GET_ACL_DataType(HPLAI_rzero),
+        HPLAI_GET_ACL_DataType((float)HPL_rzero),
         ACL_FORMAT_ND);
 #endif
 
     const int64_t
-        sAsize = (M1 * K1 * sizeof(HPLAI_T_AFLOAT) + 63) / 32 * 32,
-        sBsize = (K1 * N1 * sizeof(HPLAI_T_AFLOAT) + 63) / 32 * 32,
-        sCsize = (M1 * N1 * sizeof(HPLAI_T_AFLOAT) + 63) / 32 * 32,
+        sAsize = (M1 * K1 * sizeof(HPLAI_T_LFLOAT) + 63) / 32 * 32,
+        sBsize = (K1 * N1 * sizeof(HPLAI_T_LFLOAT) + 63) / 32 * 32,
+        sCsize = (M1 * N1 * sizeof(HPLAI_T_LFLOAT) + 63) / 32 * 32,
         hAsize = (M1 * K1 * sizeof(aclFloat16) + 63) / 32 * 32,
         hBsize = (K1 * N1 * sizeof(aclFloat16) + 63) / 32 * 32,
         hCsize = (M1 * N1 * sizeof(aclFloat16) + 63) / 32 * 32;
@@ -1046,7 +1116,7 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
             M1,
             A,
             LDA,
-            reinterpret_cast<HPLAI_T_AFLOAT *>(sAhost),
+            reinterpret_cast<HPLAI_T_LFLOAT *>(sAhost),
             K1);
     }
     else
@@ -1056,7 +1126,7 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
             M1,
             A,
             LDA,
-            reinterpret_cast<HPLAI_T_AFLOAT *>(sAhost),
+            reinterpret_cast<HPLAI_T_LFLOAT *>(sAhost),
             K1);
     }
 
@@ -1074,7 +1144,7 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
         M1,
         K1,
         sAdevice,
-        HPLAI_GET_ACL_DataType(HPLAI_rzero),
+        HPLAI_GET_ACL_DataType((float)HPL_rzero),
         ACL_FORMAT_ND,
         hAdevice,
         ACL_FLOAT16,
@@ -1088,7 +1158,7 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
             K1,
             B,
             LDB,
-            reinterpret_cast<HPLAI_T_AFLOAT *>(sBhost),
+            reinterpret_cast<HPLAI_T_LFLOAT *>(sBhost),
             N1);
     }
     else
@@ -1098,7 +1168,7 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
             K1,
             B,
             LDB,
-            reinterpret_cast<HPLAI_T_AFLOAT *>(sBhost),
+            reinterpret_cast<HPLAI_T_LFLOAT *>(sBhost),
             N1);
     }
 
@@ -1116,7 +1186,7 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
         K1,
         N1,
         sBdevice,
-        HPLAI_GET_ACL_DataType(HPLAI_rzero),
+        HPLAI_GET_ACL_DataType((float)HPL_rzero),
         ACL_FORMAT_ND,
         hBdevice,
         ACL_FLOAT16,
@@ -1152,7 +1222,7 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
         ACL_FLOAT16,
         ACL_FORMAT_ND,
         sCdevice,
-        HPLAI_GET_ACL_DataType(HPLAI_rzero),
+        HPLAI_GET_ACL_DataType((float)HPL_rzero),
         ACL_FORMAT_ND,
         HPLAI_ACL_BLASPP_STREAM[0]);
 
@@ -1215,9 +1285,9 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
 
     ACLCHECK(aclrtSynchronizeStream(HPLAI_ACL_BLASPP_STREAM[0]));
     {
-        HPLAI_T_AFLOAT *C0 = C, *mC0 = reinterpret_cast<HPLAI_T_AFLOAT *>(sChost);
+        HPLAI_T_LFLOAT *C0 = C, *mC0 = reinterpret_cast<HPLAI_T_LFLOAT *>(sChost);
         for (int64_t j = 0; j < M1; ++j, C0 += LDC, mC0 += N1)
-            blas::axpy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(N1, ALPHA, mC0, 1, C0, 1);
+            blas::axpy<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(N1, ALPHA, mC0, 1, C0, 1);
     }
 
     /*
@@ -1229,16 +1299,86 @@ void blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
         N1,
         K1,
         ALPHA,
-        reinterpret_cast<HPLAI_T_AFLOAT *>(sAhost),
+        reinterpret_cast<HPLAI_T_LFLOAT *>(sAhost),
         K1,
-        reinterpret_cast<HPLAI_T_AFLOAT *>(sBhost),
+        reinterpret_cast<HPLAI_T_LFLOAT *>(sBhost),
         N1,
-        HPLAI_rone,
+        (float)HPL_rone,
         C,
         LDC);
 */
 }
 
+#elif defined(HPLAI_SOFT_LFLOAT)
+
+template <>
+void blas::gemm<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
+    blas::Layout layout,
+    blas::Op TRANSA,
+    blas::Op TRANSB,
+    int64_t M,
+    int64_t N,
+    int64_t K,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> ALPHA,
+    HPLAI_T_LFLOAT const *A,
+    int64_t LDA,
+    HPLAI_T_LFLOAT const *B,
+    int64_t LDB,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> BETA,
+    HPLAI_T_LFLOAT *C,
+    int64_t LDC)
+{
+    if (layout != blas::Layout::ColMajor)
+    {
+        blas::gemm<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
+            blas::Layout::ColMajor, TRANSB, TRANSA, N, M, K,
+            ALPHA, B, LDB, A, LDA, BETA, C, LDC);
+        return;
+    }
+    const float alpha = (float)ALPHA, beta = (float)BETA;
+    int64_t i, j, ib, jb;
+    float *fA, *fB, *fC;
+
+    if ((M == 0) || (N == 0) || ((alpha == 0.0f || K == 0) && beta == 1.0f))
+        return;
+
+    if ((alpha == 0.0f) || (K == 0))
+    {
+        for (j = 0; j < N; j++)
+            for (i = 0; i < M; i++)
+                C[i + j * LDC] = (beta == 0.0f ? 0.0f : beta * (float)C[i + j * LDC]);
+        return;
+    }
+    /*
+     * op( A ) and op( B ) are unpacked once,  C is unpacked and rounded back
+     * tile by tile,  so that the float workspace stays close to the size of
+     * the operands rather than of the trailing matrix.
+     */
+    fA = HPLAI_soft_malloc((size_t)M * K + (size_t)K * N +
+                               (size_t)HPLAI_SOFT_GEMM_MB * HPLAI_SOFT_GEMM_NB,
+                           "blas::gemm");
+    fB = fA + (size_t)M * K;
+    fC = fB + (size_t)K * N;
+
+    HPLAI_soft_unpack(TRANSA, M, K, A, LDA, fA, M);
+    HPLAI_soft_unpack(TRANSB, K, N, B, LDB, fB, K);
+
+    for (j = 0; j < N; j += HPLAI_SOFT_GEMM_NB)
+    {
+        jb = Mmin(N - j, HPLAI_SOFT_GEMM_NB);
+        for (i = 0; i < M; i += HPLAI_SOFT_GEMM_MB)
+        {
+            ib = Mmin(M - i, HPLAI_SOFT_GEMM_MB);
+            if (beta != 0.0f)
+                HPLAI_soft_unpack(blas::Op::NoTrans, ib, jb, C + i + j * LDC, LDC, fC, ib);
+            blas::gemm(blas::Layout::ColMajor, blas::Op::NoTrans, blas::Op::NoTrans,
+                       ib, jb, K, alpha, fA + i, M, fB + j * K, K, beta, fC, ib);
+            HPLAI_soft_pack(ib, jb, fC, ib, C + i + j * LDC, LDC);
+        }
+    }
+    free(fA);
+}
+
 #else
 
 template <>
@@ -1346,7 +1486,7 @@ void blas::scal<float>(
 #if defined(HPLAI_DEVICE_BLASPP_TRSM)
 
 template <>
-void blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+void blas::trsm<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
     blas::Layout layout,
     blas::Side SIDE,
     blas::Uplo UPLO,
@@ -1354,10 +1494,10 @@ void blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
     blas::Diag DIAG,
     int64_t M,
     int64_t N,
-    blas::scalar_type<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT> ALPHA,
-    HPLAI_T_AFLOAT const *A,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> ALPHA,
+    HPLAI_T_LFLOAT const *A,
     int64_t LDA,
-    HPLAI_T_AFLOAT *B,
+    HPLAI_T_LFLOAT *B,
     int64_t LDB)
 {
 #if !defined(HPLAI_DEVICE_BLASPP_TRSM_USE_CPU)
@@ -1385,7 +1525,7 @@ void blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
     //HPLAI_pabort( __LINE__, "blas::trsm", "Use HPLAI_DEVICE_BLASPP_TRSM" );
     if (layout != blas::Layout::ColMajor)
     {
-        blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+        blas::trsm<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
             blas::Layout::ColMajor,
             (SIDE == blas::Side::Right ? blas::Side::Left : blas::Side::Right),
             (UPLO == blas::Uplo::Lower ? blas::Uplo::Upper : blas::Uplo::Lower),
@@ -1397,17 +1537,17 @@ void blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
     if ((M == 0) || (N == 0))
         return;
 
-    if (ALPHA == HPLAI_rzero)
+    if (ALPHA == (float)HPL_rzero)
     {
         for (j = 0; j < N; j++)
         {
             for (i = 0; i < M; i++)
-                *(B + i + j * LDB) = HPLAI_rzero;
+                *(B + i + j * LDB) = (float)HPL_rzero;
         }
         return;
     }
 
-    int64_t padding_size = 128 / sizeof(HPLAI_T_AFLOAT);
+    int64_t padding_size = 128 / sizeof(HPLAI_T_LFLOAT);
     if (padding_size < 1)
         padding_size = 1;
 
@@ -1424,17 +1564,17 @@ void blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
     if (HPLAI_DEVICE_BLASPP_BUFFER_SIZE < dsB + dsA)
         HPLAI_DEVICE_BLASPP_BUFFER_RESIZE(dsB + dsA);
 
-    HPLAI_T_AFLOAT *dB = HPLAI_DEVICE_BLASPP_BUFFER;
-    HPLAI_T_AFLOAT *dA = dB + dsB;
+    HPLAI_T_LFLOAT *dB = HPLAI_DEVICE_BLASPP_BUFFER;
+    HPLAI_T_LFLOAT *dA = dB + dsB;
 
 #if defined(HPLAI_DEVICE_BLASPP_TRSM_MULTISTREAM)
     HPLAI_DEVICE_BLASPP_QUEUE->fork();
 #endif
-    blas::device_setmatrix<HPLAI_T_AFLOAT>(rB, cB, B, LDB, dB, dLDB, *HPLAI_DEVICE_BLASPP_QUEUE);
+    blas::device_setmatrix<HPLAI_T_LFLOAT>(rB, cB, B, LDB, dB, dLDB, *HPLAI_DEVICE_BLASPP_QUEUE);
 #if defined(HPLAI_DEVICE_BLASPP_TRSM_MULTISTREAM)
     HPLAI_DEVICE_BLASPP_QUEUE->revolve();
 #endif
-    blas::device_setmatrix<HPLAI_T_AFLOAT>(rA, cA, A, LDA, dA, dLDA, *HPLAI_DEVICE_BLASPP_QUEUE);
+    blas::device_setmatrix<HPLAI_T_LFLOAT>(rA, cA, A, LDA, dA, dLDA, *HPLAI_DEVICE_BLASPP_QUEUE);
 #if defined(HPLAI_DEVICE_BLASPP_TRSM_MULTISTREAM)
     HPLAI_DEVICE_BLASPP_QUEUE->join();
 #endif
@@ -1454,715 +1594,544 @@ void blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
         dLDB,
         *HPLAI_DEVICE_BLASPP_QUEUE);
 
-    blas::device_getmatrix<HPLAI_T_AFLOAT>(rB, cB, dB, dLDB, B, LDB, *HPLAI_DEVICE_BLASPP_QUEUE);
+    blas::device_getmatrix<HPLAI_T_LFLOAT>(rB, cB, dB, dLDB, B, LDB, *HPLAI_DEVICE_BLASPP_QUEUE);
 
     HPLAI_DEVICE_BLASPP_QUEUE->sync();
 }
 
 #elif defined(HPLAI_GEN_BLASPP_TRSM)
 
-template <typename T>
-static void HPLAI_trsmLLNN(
-    const int64_t M,
-    const int64_t N,
-    const T ALPHA,
-    const T *A,
-    const int64_t LDA,
-    T *B,
-    const int64_t LDB)
-{
-    int64_t i, iaik, ibij, ibkj, j, jak, jbj, k;
-
-    for (j = 0, jbj = 0; j < N; j++, jbj += LDB)
-    {
-        for (i = 0, ibij = jbj; i < M; i++, ibij += 1)
-        {
-            B[ibij] *= ALPHA;
-        }
-        for (k = 0, jak = 0, ibkj = jbj; k < M; k++, jak += LDA, ibkj += 1)
-        {
-            B[ibkj] /= A[k + jak];
-            for (i = k + 1, iaik = k + 1 + jak, ibij = k + 1 + jbj;
-                 i < M; i++, iaik += 1, ibij += 1)
-            {
-                B[ibij] -= B[ibkj] * A[iaik];
-            }
-        }
-    }
-}
+/*
+ * Size of the diagonal blocks solved by HPLAI_trsm_kernel, the rest of
+ * the work is done by blas::gemm.
+ */
+#if !defined(HPLAI_GEN_BLASPP_TRSM_NB)
+#define HPLAI_GEN_BLASPP_TRSM_NB 32
+#endif
 
 template <typename T>
-static void HPLAI_trsmLLNU(
-    const int64_t M,
+static void HPLAI_trsm_kernel(
+    const int LOWER,
+    const int TRANS,
+    const int UNIT,
+    const int64_t K,
     const int64_t N,
-    const T ALPHA,
     const T *A,
     const int64_t LDA,
     T *B,
-    const int64_t LDB)
+    const int64_t RS,
+    const int64_t CS)
 {
-    int64_t i, iaik, ibij, ibkj, j, jak, jbj, k;
-
-    for (j = 0, jbj = 0; j < N; j++, jbj += LDB)
+    /*
+     * Solves op( A ) X = B,  with op( A ) a small K by K lower (LOWER) or
+     * upper triangular matrix,  op( A )(i,k) = A[i+k*LDA] or A[k+i*LDA]
+     * when TRANS. B(i,j) = B[i*RS+j*CS] is K by N, X overwrites B.
+     *
+     * Each row of X is computed as a dot product with the rows already
+     * solved, four right-hand sides at a time,  so that every entry of A
+     * loaded is used four times from registers.
+     */
+    const int64_t SA = (TRANS ? LDA : 1), SK = (TRANS ? 1 : LDA);
+    int64_t i, ii, j, k, k0, k1;
+    T a, s0, s1, s2, s3;
+
+    for (j = 0; j < N; j += 4)
     {
-        for (i = 0, ibij = jbj; i < M; i++, ibij += 1)
-        {
-            B[ibij] *= ALPHA;
-        }
-        for (k = 0, jak = 0, ibkj = jbj; k < M; k++, jak += LDA, ibkj += 1)
+        T *b0 = B + j * CS;
+        const int64_t nr = (N - j < 4 ? N - j : 4);
+        for (ii = 0; ii < K; ii++)
         {
-            for (i = k + 1, iaik = k + 1 + jak, ibij = k + 1 + jbj;
-                 i < M; i++, iaik += 1, ibij += 1)
+            i = (LOWER ? ii : K - 1 - ii);
+            k0 = (LOWER ? 0 : i + 1);
+            k1 = (LOWER ? i : K);
+            if (nr == 4)
             {
-                B[ibij] -= B[ibkj] * A[iaik];
+                s0 = b0[i * RS];
+                s1 = b0[i * RS + CS];
+                s2 = b0[i * RS + 2 * CS];
+                s3 = b0[i * RS + 3 * CS];
+                for (k = k0; k < k1; k++)
+                {
+                    a = A[i * SA + k * SK];
+                    s0 -= a * b0[k * RS];
+                    s1 -= a * b0[k * RS + CS];
+                    s2 -= a * b0[k * RS + 2 * CS];
+                    s3 -= a * b0[k * RS + 3 * CS];
+                }
+                if (!UNIT)
+                {
+                    a = A[i * SA + i * SK];
+                    s0 /= a;
+                    s1 /= a;
+                    s2 /= a;
+                    s3 /= a;
+                }
+                b0[i * RS] = s0;
+                b0[i * RS + CS] = s1;
+                b0[i * RS + 2 * CS] = s2;
+                b0[i * RS + 3 * CS] = s3;
             }
-        }
-    }
-}
-
-template <typename T>
-static void HPLAI_trsmLLTN(
-    const int64_t M,
-    const int64_t N,
-    const T ALPHA,
-    const T *A,
-    const int64_t LDA,
-    T *B,
-    const int64_t LDB)
-{
-    register T t0;
-    int64_t i, iaki, ibij, ibkj, j, jai, jbj, k;
-
-    for (j = 0, jbj = 0; j < N; j++, jbj += LDB)
-    {
-        for (i = M - 1, jai = (M - 1) * LDA, ibij = M - 1 + jbj;
-             i >= 0; i--, jai -= LDA, ibij -= 1)
-        {
-            t0 = ALPHA * B[ibij];
-            for (k = i + 1, iaki = i + 1 + jai, ibkj = i + 1 + jbj;
-                 k < M; k++, iaki += 1, ibkj += 1)
+            else
             {
-                t0 -= A[iaki] * B[ibkj];
+                int64_t c;
+                for (c = 0; c < nr; c++)
+                {
+                    s0 = b0[i * RS + c * CS];
+                    for (k = k0; k < k1; k++)
+                        s0 -= A[i * SA + k * SK] * b0[k * RS + c * CS];
+                    if (!UNIT)
+                        s0 /= A[i * SA + i * SK];
+                    b0[i * RS + c * CS] = s0;
+                }
             }
-            t0 /= A[i + jai];
-            B[ibij] = t0;
         }
     }
 }
 
 template <typename T>
-static void HPLAI_trsmLLTU(
+static void HPLAI_trsm_rec(
+    const blas::Side SIDE,
+    const blas::Uplo UPLO,
+    const blas::Op TRANS,
+    const blas::Diag DIAG,
     const int64_t M,
     const int64_t N,
-    const T ALPHA,
     const T *A,
     const int64_t LDA,
     T *B,
     const int64_t LDB)
 {
-    register T t0;
-    int64_t i, iaki, ibij, ibkj, j, jai, jbj, k;
+    /*
+     * Column-major trsm with ALPHA = 1.  The triangular dimension is split
+     * in two halves until it fits in HPLAI_GEN_BLASPP_TRSM_NB:  the two
+     * diagonal halves are solved recursively,  and the off-diagonal block
+     * is applied with one blas::gemm.
+     */
+    const int trans = (TRANS != blas::Op::NoTrans);
+    const int lower = ((UPLO == blas::Uplo::Lower) != trans); /* op( A ) */
+    const int unit = (DIAG == blas::Diag::Unit);
+    const int64_t K = (SIDE == blas::Side::Left ? M : N);
+    const T rone = (T)HPL_rone;
+    int64_t k1, k2;
+    const T *A21, *A12; /* blocks of op( A ), as stored in A */
+
+    if ((M == 0) || (N == 0))
+        return;
 
-    for (j = 0, jbj = 0; j < N; j++, jbj += LDB)
+    if (K <= HPLAI_GEN_BLASPP_TRSM_NB)
     {
-        for (i = M - 1, jai = (M - 1) * LDA, ibij = M - 1 + jbj;
-             i >= 0; i--, jai -= LDA, ibij -= 1)
-        {
-            t0 = ALPHA * B[ibij];
-            for (k = i + 1, iaki = i + 1 + jai, ibkj = i + 1 + jbj;
-                 k < M; k++, iaki += 1, ibkj += 1)
-            {
-                t0 -= A[iaki] * B[ibkj];
-            }
-            B[ibij] = t0;
-        }
+        if (SIDE == blas::Side::Left)
+            HPLAI_trsm_kernel(lower, trans, unit, M, N, A, LDA, B, 1, LDB);
+        else /* X op( A ) = B is op( A )^T X^T = B^T */
+            HPLAI_trsm_kernel(!lower, !trans, unit, N, M, A, LDA, B, LDB, 1);
+        return;
     }
-}
 
-template <typename T>
-static void HPLAI_trsmLUNN(
-    const int64_t M,
-    const int64_t N,
-    const T ALPHA,
-    const T *A,
-    const int64_t LDA,
-    T *B,
-    const int64_t LDB)
-{
-    int64_t i, iaik, ibij, ibkj, j, jak, jbj, k;
+    k1 = ((K >> 1) >> 3) << 3;
+    if (k1 == 0)
+        k1 = K >> 1;
+    k2 = K - k1;
+    A21 = (trans ? A + k1 * LDA : A + k1);
+    A12 = (trans ? A + k1 : A + k1 * LDA);
 
-    for (j = 0, jbj = 0; j < N; j++, jbj += LDB)
+    if (SIDE == blas::Side::Left)
     {
-        for (i = 0, ibij = jbj; i < M; i++, ibij += 1)
+        if (lower)
         {
-            B[ibij] *= ALPHA;
+            HPLAI_trsm_rec(SIDE, UPLO, TRANS, DIAG, k1, N, A, LDA, B, LDB);
+            blas::gemm<T, T, T>(blas::Layout::ColMajor, TRANS, blas::Op::NoTrans, k2, N, k1,
+                                -rone, A21, LDA, B, LDB, rone, B + k1, LDB);
+            HPLAI_trsm_rec(SIDE, UPLO, TRANS, DIAG, k2, N, A + k1 + k1 * LDA, LDA, B + k1, LDB);
         }
-        for (k = M - 1, jak = (M - 1) * LDA, ibkj = M - 1 + jbj;
-             k >= 0; k--, jak -= LDA, ibkj -= 1)
+        else
         {
-            B[ibkj] /= A[k + jak];
-            for (i = 0, iaik = jak, ibij = jbj;
-                 i < k; i++, iaik += 1, ibij += 1)
-            {
-                B[ibij] -= B[ibkj] * A[iaik];
-            }
+            HPLAI_trsm_rec(SIDE, UPLO, TRANS, DIAG, k2, N, A + k1 + k1 * LDA, LDA, B + k1, LDB);
+            blas::gemm<T, T, T>(blas::Layout::ColMajor, TRANS, blas::Op::NoTrans, k1, N, k2,
+                                -rone, A12, LDA, B + k1, LDB, rone, B, LDB);
+            HPLAI_trsm_rec(SIDE, UPLO, TRANS, DIAG, k1, N, A, LDA, B, LDB);
         }
     }
-}
-
-template <typename T>
-static void HPLAI_trsmLUNU(
-    const int64_t M,
-    const int64_t N,
-    const T ALPHA,
-    const T *A,
-    const int64_t LDA,
-    T *B,
-    const int64_t LDB)
-{
-    int64_t i, iaik, ibij, ibkj, j, jak, jbj, k;
-
-    for (j = 0, jbj = 0; j < N; j++, jbj += LDB)
+    else
     {
-        for (i = 0, ibij = jbj; i < M; i++, ibij += 1)
+        if (lower)
         {
-            B[ibij] *= ALPHA;
+            HPLAI_trsm_rec(SIDE, UPLO, TRANS, DIAG, M, k2, A + k1 + k1 * LDA, LDA, B + k1 * LDB, LDB);
+            blas::gemm<T, T, T>(blas::Layout::ColMajor, blas::Op::NoTrans, TRANS, M, k1, k2,
+                                -rone, B + k1 * LDB, LDB, A21, LDA, rone, B, LDB);
+            HPLAI_trsm_rec(SIDE, UPLO, TRANS, DIAG, M, k1, A, LDA, B, LDB);
         }
-        for (k = M - 1, jak = (M - 1) * LDA, ibkj = M - 1 + jbj;
-             k >= 0; k--, jak -= LDA, ibkj -= 1)
+        else
         {
-            for (i = 0, iaik = jak, ibij = jbj;
-                 i < k; i++, iaik += 1, ibij += 1)
-            {
-                B[ibij] -= B[ibkj] * A[iaik];
-            }
+            HPLAI_trsm_rec(SIDE, UPLO, TRANS, DIAG, M, k1, A, LDA, B, LDB);
+            blas::gemm<T, T, T>(blas::Layout::ColMajor, blas::Op::NoTrans, TRANS, M, k2, k1,
+                                -rone, B, LDB, A12, LDA, rone, B + k1 * LDB, LDB);
+            HPLAI_trsm_rec(SIDE, UPLO, TRANS, DIAG, M, k2, A + k1 + k1 * LDA, LDA, B + k1 * LDB, LDB);
         }
     }
 }
 
-template <typename T>
-static void HPLAI_trsmLUTN(
-    const int64_t M,
-    const int64_t N,
-    const T ALPHA,
-    const T *A,
-    const int64_t LDA,
-    T *B,
-    const int64_t LDB)
+template <>
+void blas::trsm<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
+    blas::Layout layout,
+    blas::Side SIDE,
+    blas::Uplo UPLO,
+    blas::Op TRANS,
+    blas::Diag DIAG,
+    int64_t M,
+    int64_t N,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> ALPHA,
+    HPLAI_T_LFLOAT const *A,
+    int64_t LDA,
+    HPLAI_T_LFLOAT *B,
+    int64_t LDB)
 {
-    int64_t i, iaki, ibij, ibkj, j, jai, jbj, k;
-    register T t0;
-
-    for (j = 0, jbj = 0; j < N; j++, jbj += LDB)
+    //HPLAI_pabort( __LINE__, "blas::trsm", "Use HPLAI_GEN_BLASPP_TRSM" );
+    if (layout != blas::Layout::ColMajor)
     {
-        for (i = 0, jai = 0, ibij = jbj; i < M; i++, jai += LDA, ibij += 1)
-        {
-            t0 = ALPHA * B[ibij];
-            for (k = 0, iaki = jai, ibkj = jbj; k < i; k++, iaki += 1, ibkj += 1)
-            {
-                t0 -= A[iaki] * B[ibkj];
-            }
-            t0 /= A[i + jai];
-            B[ibij] = t0;
-        }
+        blas::trsm<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
+            blas::Layout::ColMajor,
+            (SIDE == blas::Side::Right ? blas::Side::Left : blas::Side::Right),
+            (UPLO == blas::Uplo::Lower ? blas::Uplo::Upper : blas::Uplo::Lower),
+            TRANS, DIAG, N, M, ALPHA, A, LDA, B, LDB);
+        return;
     }
-}
+    int64_t i, j;
 
-template <typename T>
-static void HPLAI_trsmLUTU(
-    const int64_t M,
-    const int64_t N,
-    const T ALPHA,
-    const T *A,
-    const int64_t LDA,
-    T *B,
-    const int64_t LDB)
-{
-    register T t0;
-    int64_t i, iaki, ibij, ibkj, j, jai, jbj, k;
+    if ((M == 0) || (N == 0))
+        return;
 
-    for (j = 0, jbj = 0; j < N; j++, jbj += LDB)
+    if (ALPHA == (float)HPL_rzero)
     {
-        for (i = 0, jai = 0, ibij = jbj; i < M; i++, jai += LDA, ibij += 1)
+        for (j = 0; j < N; j++)
         {
-            t0 = ALPHA * B[ibij];
-            for (k = 0, iaki = jai, ibkj = jbj; k < i; k++, iaki += 1, ibkj += 1)
-            {
-                t0 -= A[iaki] * B[ibkj];
-            }
-            B[ibij] = t0;
+            for (i = 0; i < M; i++)
+                *(B + i + j * LDB) = (float)HPL_rzero;
         }
+        return;
     }
-}
-
-template <typename T>
-static void HPLAI_trsmRLNN(
-    const int64_t M,
-    const int64_t N,
-    const T ALPHA,
-    const T *A,
-    const int64_t LDA,
-    T *B,
-    const int64_t LDB)
-{
-    int64_t i, iakj, ibij, ibik, j, jaj, jbj, jbk, k;
 
-    for (j = N - 1, jaj = (N - 1) * LDA, jbj = (N - 1) * LDB;
-         j >= 0; j--, jaj -= LDA, jbj -= LDB)
+    if (ALPHA != (float)HPL_rone)
     {
-        for (i = 0, ibij = jbj; i < M; i++, ibij += 1)
-        {
-            B[ibij] *= ALPHA;
-        }
-        for (k = j + 1, iakj = j + 1 + jaj, jbk = (j + 1) * LDB;
-             k < N; k++, iakj += 1, jbk += LDB)
-        {
-            for (i = 0, ibij = jbj, ibik = jbk; i < M; i++, ibij += 1, ibik += 1)
-            {
-                B[ibij] -= A[iakj] * B[ibik];
-            }
-        }
-        for (i = 0, ibij = jbj; i < M; i++, ibij += 1)
+        for (j = 0; j < N; j++)
         {
-            B[ibij] /= A[j + jaj];
+            for (i = 0; i < M; i++)
+                *(B + i + j * LDB) *= (HPLAI_T_LFLOAT)ALPHA;
         }
     }
+
+    HPLAI_trsm_rec<HPLAI_T_LFLOAT>(SIDE, UPLO, TRANS, DIAG, M, N, A, LDA, B, LDB);
 }
 
-template <typename T>
-static void HPLAI_trsmRLNU(
-    const int64_t M,
-    const int64_t N,
-    const T ALPHA,
-    const T *A,
-    const int64_t LDA,
-    T *B,
-    const int64_t LDB)
-{
-    int64_t i, iakj, ibij, ibik, j, jaj, jbj, jbk, k;
+#elif defined(HPLAI_SOFT_LFLOAT)
 
-    for (j = N - 1, jaj = (N - 1) * LDA, jbj = (N - 1) * LDB;
-         j >= 0; j--, jaj -= LDA, jbj -= LDB)
+template <>
+void blas::trsm<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
+    blas::Layout layout,
+    blas::Side SIDE,
+    blas::Uplo UPLO,
+    blas::Op TRANS,
+    blas::Diag DIAG,
+    int64_t M,
+    int64_t N,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> ALPHA,
+    HPLAI_T_LFLOAT const *A,
+    int64_t LDA,
+    HPLAI_T_LFLOAT *B,
+    int64_t LDB)
+{
+    if (layout != blas::Layout::ColMajor)
     {
-        for (i = 0, ibij = jbj; i < M; i++, ibij += 1)
-        {
-            B[ibij] *= ALPHA;
-        }
-        for (k = j + 1, iakj = j + 1 + jaj, jbk = (j + 1) * LDB;
-             k < N; k++, iakj += 1, jbk += LDB)
-        {
-            for (i = 0, ibij = jbj, ibik = jbk; i < M; i++, ibij += 1, ibik += 1)
-            {
-                B[ibij] -= A[iakj] * B[ibik];
-            }
-        }
+        blas::trsm<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
+            blas::Layout::ColMajor,
+            (SIDE == blas::Side::Right ? blas::Side::Left : blas::Side::Right),
+            (UPLO == blas::Uplo::Lower ? blas::Uplo::Upper : blas::Uplo::Lower),
+            TRANS, DIAG, N, M, ALPHA, A, LDA, B, LDB);
+        return;
     }
+    const int64_t K = (SIDE == blas::Side::Left ? M : N);
+    float *fA, *fB;
+
+    if ((M == 0) || (N == 0))
+        return;
+
+    fA = HPLAI_soft_malloc((size_t)K * K + (size_t)M * N, "blas::trsm");
+    fB = fA + (size_t)K * K;
+
+    HPLAI_soft_unpack(blas::Op::NoTrans, K, K, A, LDA, fA, K);
+    HPLAI_soft_unpack(blas::Op::NoTrans, M, N, B, LDB, fB, M);
+    blas::trsm(blas::Layout::ColMajor, SIDE, UPLO, TRANS, DIAG, M, N,
+               (float)ALPHA, fA, K, fB, M);
+    HPLAI_soft_pack(M, N, fB, M, B, LDB);
+    free(fA);
 }
 
-template <typename T>
-static void HPLAI_trsmRLTN(
-    const int64_t M,
-    const int64_t N,
-    const T ALPHA,
-    const T *A,
-    const int64_t LDA,
-    T *B,
-    const int64_t LDB)
-{
-    register T t0;
-    int64_t i, iajk, ibij, ibik, j, jak, jbj, jbk, k;
-
-    for (k = 0, jak = 0, jbk = 0; k < N; k++, jak += LDA, jbk += LDB)
-    {
-        for (i = 0, ibik = jbk; i < M; i++, ibik += 1)
-        {
-            B[ibik] /= A[k + jak];
-        }
-        for (j = k + 1, iajk = (k + 1) + jak, jbj = (k + 1) * LDB;
-             j < N; j++, iajk += 1, jbj += LDB)
-        {
-            t0 = A[iajk];
-            for (i = 0, ibij = jbj, ibik = jbk; i < M; i++, ibij += 1, ibik += 1)
-            {
-                B[ibij] -= t0 * B[ibik];
-            }
-        }
-        for (i = 0, ibik = jbk; i < M; i++, ibik += 1)
-        {
-            B[ibik] *= ALPHA;
-        }
-    }
-}
+#else
 
-template <typename T>
-static void HPLAI_trsmRLTU(
-    const int64_t M,
-    const int64_t N,
-    const T ALPHA,
-    const T *A,
-    const int64_t LDA,
-    T *B,
-    const int64_t LDB)
+template <>
+void blas::trsm<float, float>(
+    blas::Layout layout,
+    blas::Side side,
+    blas::Uplo uplo,
+    blas::Op trans,
+    blas::Diag diag,
+    int64_t m,
+    int64_t n,
+    blas::scalar_type<float, float> alpha,
+    float const *A,
+    int64_t lda,
+    float *B,
+    int64_t ldb)
 {
-    register T t0;
-    int64_t i, iajk, ibij, ibik, j, jak, jbj, jbk, k;
-
-    for (k = 0, jak = 0, jbk = 0; k < N; k++, jak += LDA, jbk += LDB)
-    {
-        for (j = k + 1, iajk = (k + 1) + jak, jbj = (k + 1) * LDB;
-             j < N; j++, iajk += 1, jbj += LDB)
-        {
-            t0 = A[iajk];
-            for (i = 0, ibij = jbj, ibik = jbk; i < M; i++, ibij += 1, ibik += 1)
-            {
-                B[ibij] -= t0 * B[ibik];
-            }
-        }
-        for (i = 0, ibik = jbk; i < M; i++, ibik += 1)
-        {
-            B[ibik] *= ALPHA;
-        }
-    }
+    blas::trsm(
+        layout,
+        side,
+        uplo,
+        trans,
+        diag,
+        m,
+        n,
+        alpha,
+        A,
+        lda,
+        B,
+        ldb);
 }
 
-template <typename T>
-static void HPLAI_trsmRUNN(
-    const int64_t M,
-    const int64_t N,
-    const T ALPHA,
-    const T *A,
-    const int64_t LDA,
-    T *B,
-    const int64_t LDB)
-{
-    int64_t i, iakj, ibij, ibik, j, jaj, jbj, jbk, k;
+#endif
 
-    for (j = 0, jaj = 0, jbj = 0; j < N; j++, jaj += LDA, jbj += LDB)
-    {
-        for (i = 0, ibij = jbj; i < M; i++, ibij += 1)
-        {
-            B[ibij] *= ALPHA;
-        }
-        for (k = 0, iakj = jaj, jbk = 0; k < j; k++, iakj += 1, jbk += LDB)
-        {
-            for (i = 0, ibij = jbj, ibik = jbk; i < M; i++, ibij += 1, ibik += 1)
-            {
-                B[ibij] -= A[iakj] * B[ibik];
-            }
-        }
-        for (i = 0, ibij = jbj; i < M; i++, ibij += 1)
-        {
-            B[ibij] /= A[j + jaj];
-        }
-    }
+template <>
+void blas::trsv<float, float>(
+    blas::Layout layout,
+    blas::Uplo uplo,
+    blas::Op trans,
+    blas::Diag diag,
+    int64_t n,
+    float const *A,
+    int64_t lda,
+    float *x,
+    int64_t incx)
+{
+    blas::trsv(
+        layout,
+        uplo,
+        trans,
+        diag,
+        n,
+        A,
+        lda,
+        x,
+        incx);
 }
 
-template <typename T>
-static void HPLAI_trsmRUNU(
-    const int64_t M,
-    const int64_t N,
-    const T ALPHA,
-    const T *A,
-    const int64_t LDA,
-    T *B,
-    const int64_t LDB)
+#if defined(HPLAI_SOFT_LFLOAT)
+
+template <>
+int64_t blas::iamax<HPLAI_T_LFLOAT>(
+    int64_t n,
+    HPLAI_T_LFLOAT const *x,
+    int64_t incx)
 {
-    int64_t i, iakj, ibij, ibik, j, jaj, jbj, jbk, k;
+    int64_t i, imax = 0;
+    float t, tmax = -1.0f;
 
-    for (j = 0, jaj = 0, jbj = 0; j < N; j++, jaj += LDA, jbj += LDB)
+    for (i = 0; i < n; i++)
     {
-        for (i = 0, ibij = jbj; i < M; i++, ibij += 1)
-        {
-            B[ibij] *= ALPHA;
-        }
-        for (k = 0, iakj = jaj, jbk = 0; k < j; k++, iakj += 1, jbk += LDB)
+        t = fabsf((float)x[i * incx]);
+        if (t > tmax)
         {
-            for (i = 0, ibij = jbj, ibik = jbk; i < M; i++, ibij += 1, ibik += 1)
-            {
-                B[ibij] -= A[iakj] * B[ibik];
-            }
+            tmax = t;
+            imax = i;
         }
     }
+    return imax;
 }
 
-template <typename T>
-static void HPLAI_trsmRUTN(
-    const int64_t M,
-    const int64_t N,
-    const T ALPHA,
-    const T *A,
-    const int64_t LDA,
-    T *B,
-    const int64_t LDB)
+template <>
+void blas::axpy<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
+    int64_t n,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> alpha,
+    HPLAI_T_LFLOAT const *x,
+    int64_t incx,
+    HPLAI_T_LFLOAT *y,
+    int64_t incy)
 {
-    register T t0;
-    int64_t i, iajk, ibij, ibik, j, jak, jbj, jbk, k;
+    const float a = (float)alpha;
+    int64_t i;
 
-    for (k = N - 1, jak = (N - 1) * LDA, jbk = (N - 1) * LDB;
-         k >= 0; k--, jak -= LDA, jbk -= LDB)
-    {
-        for (i = 0, ibik = jbk; i < M; i++, ibik += 1)
-        {
-            B[ibik] /= A[k + jak];
-        }
-        for (j = 0, iajk = jak, jbj = 0; j < k; j++, iajk += 1, jbj += LDB)
-        {
-            t0 = A[iajk];
-            for (i = 0, ibij = jbj, ibik = jbk; i < M; i++, ibij += 1, ibik += 1)
-            {
-                B[ibij] -= t0 * B[ibik];
-            }
-        }
-        for (i = 0, ibik = jbk; i < M; i++, ibik += 1)
-        {
-            B[ibik] *= ALPHA;
-        }
-    }
+    for (i = 0; i < n; i++)
+        y[i * incy] = (float)y[i * incy] + a * (float)x[i * incx];
 }
 
-template <typename T>
-static void HPLAI_trsmRUTU(
-    const int64_t M,
-    const int64_t N,
-    const T ALPHA,
-    const T *A,
-    const int64_t LDA,
-    T *B,
-    const int64_t LDB)
+template <>
+void blas::copy<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
+    int64_t n,
+    HPLAI_T_LFLOAT const *x,
+    int64_t incx,
+    HPLAI_T_LFLOAT *y,
+    int64_t incy)
 {
-    register T t0;
-    int64_t i, iajk, ibij, ibik, j, jak, jbj, jbk, k;
+    int64_t i;
 
-    for (k = N - 1, jak = (N - 1) * LDA, jbk = (N - 1) * LDB;
-         k >= 0; k--, jak -= LDA, jbk -= LDB)
+    if ((incx == 1) && (incy == 1))
     {
-        for (j = 0, iajk = jak, jbj = 0; j < k; j++, iajk += 1, jbj += LDB)
-        {
-            t0 = A[iajk];
-            for (i = 0, ibij = jbj, ibik = jbk; i < M; i++, ibij += 1, ibik += 1)
-            {
-                B[ibij] -= t0 * B[ibik];
-            }
-        }
-        for (i = 0, ibik = jbk; i < M; i++, ibik += 1)
-        {
-            B[ibik] *= ALPHA;
-        }
+        memcpy(y, x, (size_t)n * sizeof(HPLAI_T_LFLOAT));
+        return;
     }
+    for (i = 0; i < n; i++)
+        y[i * incy] = x[i * incx];
 }
 
 template <>
-void blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+void blas::gemv<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
     blas::Layout layout,
-    blas::Side SIDE,
-    blas::Uplo UPLO,
-    blas::Op TRANS,
-    blas::Diag DIAG,
-    int64_t M,
-    int64_t N,
-    blas::scalar_type<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT> ALPHA,
-    HPLAI_T_AFLOAT const *A,
-    int64_t LDA,
-    HPLAI_T_AFLOAT *B,
-    int64_t LDB)
+    blas::Op trans,
+    int64_t m,
+    int64_t n,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> alpha,
+    HPLAI_T_LFLOAT const *A,
+    int64_t lda,
+    HPLAI_T_LFLOAT const *x,
+    int64_t incx,
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> beta,
+    HPLAI_T_LFLOAT *y,
+    int64_t incy)
 {
-    //HPLAI_pabort( __LINE__, "blas::trsm", "Use HPLAI_GEN_BLASPP_TRSM" );
     if (layout != blas::Layout::ColMajor)
     {
-        blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+        blas::gemv<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
             blas::Layout::ColMajor,
-            (SIDE == blas::Side::Right ? blas::Side::Left : blas::Side::Right),
-            (UPLO == blas::Uplo::Lower ? blas::Uplo::Upper : blas::Uplo::Lower),
-            TRANS, DIAG, N, M, ALPHA, A, LDA, B, LDB);
+            (trans == blas::Op::NoTrans ? blas::Op::Trans : blas::Op::NoTrans),
+            n, m, alpha, A, lda, x, incx, beta, y, incy);
         return;
     }
+    const float a = (float)alpha, b = (float)beta;
     int64_t i, j;
+    float t, *fy;
 
-    if ((M == 0) || (N == 0))
+    if ((m == 0) || (n == 0))
         return;
 
-    if (ALPHA == HPLAI_rzero)
+    if (trans == blas::Op::NoTrans)
     {
-        for (j = 0; j < N; j++)
+        /*
+         * y := beta * y + alpha * A * x,  accumulated column by column in
+         * a float copy of y.
+         */
+        fy = HPLAI_soft_malloc((size_t)m, "blas::gemv");
+        for (i = 0; i < m; i++)
+            fy[i] = 0.0f;
+        for (j = 0; j < n; j++)
         {
-            for (i = 0; i < M; i++)
-                *(B + i + j * LDB) = HPLAI_rzero;
-        }
-        return;
-    }
-
-    if (SIDE == blas::Side::Left)
-    {
-        if (UPLO == blas::Uplo::Upper)
-        {
-            if (TRANS == blas::Op::NoTrans)
-            {
-                if (DIAG == blas::Diag::NonUnit)
-                {
-                    HPLAI_trsmLUNN(M, N, ALPHA, A, LDA, B, LDB);
-                }
-                else
-                {
-                    HPLAI_trsmLUNU(M, N, ALPHA, A, LDA, B, LDB);
-                }
-            }
-            else
-            {
-                if (DIAG == blas::Diag::NonUnit)
-                {
-                    HPLAI_trsmLUTN(M, N, ALPHA, A, LDA, B, LDB);
-                }
-                else
-                {
-                    HPLAI_trsmLUTU(M, N, ALPHA, A, LDA, B, LDB);
-                }
-            }
-        }
-        else
-        {
-            if (TRANS == blas::Op::NoTrans)
-            {
-                if (DIAG == blas::Diag::NonUnit)
-                {
-                    HPLAI_trsmLLNN(M, N, ALPHA, A, LDA, B, LDB);
-                }
-                else
-                {
-                    HPLAI_trsmLLNU(M, N, ALPHA, A, LDA, B, LDB);
-                }
-            }
-            else
-            {
-                if (DIAG == blas::Diag::NonUnit)
-                {
-                    HPLAI_trsmLLTN(M, N, ALPHA, A, LDA, B, LDB);
-                }
-                else
-                {
-                    HPLAI_trsmLLTU(M, N, ALPHA, A, LDA, B, LDB);
-                }
-            }
+            t = (float)x[j * incx];
+            for (i = 0; i < m; i++)
+                fy[i] += (float)A[i + j * lda] * t;
         }
+        for (i = 0; i < m; i++)
+            y[i * incy] = a * fy[i] + (b == 0.0f ? 0.0f : b * (float)y[i * incy]);
+        free(fy);
     }
     else
     {
-        if (UPLO == blas::Uplo::Upper)
+        for (j = 0; j < n; j++)
         {
-            if (TRANS == blas::Op::NoTrans)
-            {
-                if (DIAG == blas::Diag::NonUnit)
-                {
-                    HPLAI_trsmRUNN(M, N, ALPHA, A, LDA, B, LDB);
-                }
-                else
-                {
-                    HPLAI_trsmRUNU(M, N, ALPHA, A, LDA, B, LDB);
-                }
-            }
-            else
-            {
-                if (DIAG == blas::Diag::NonUnit)
-                {
-                    HPLAI_trsmRUTN(M, N, ALPHA, A, LDA, B, LDB);
-                }
-                else
-                {
-                    HPLAI_trsmRUTU(M, N, ALPHA, A, LDA, B, LDB);
-                }
-            }
-        }
-        else
-        {
-            if (TRANS == blas::Op::NoTrans)
-            {
-                if (DIAG == blas::Diag::NonUnit)
-                {
-                    HPLAI_trsmRLNN(M, N, ALPHA, A, LDA, B, LDB);
-                }
-                else
-                {
-                    HPLAI_trsmRLNU(M, N, ALPHA, A, LDA, B, LDB);
-                }
-            }
-            else
-            {
-                if (DIAG == blas::Diag::NonUnit)
-                {
-                    HPLAI_trsmRLTN(M, N, ALPHA, A, LDA, B, LDB);
-                }
-                else
-                {
-                    HPLAI_trsmRLTU(M, N, ALPHA, A, LDA, B, LDB);
-                }
-            }
+            t = 0.0f;
+            for (i = 0; i < m; i++)
+                t += (float)A[i + j * lda] * (float)x[i * incx];
+            y[j * incy] = a * t + (b == 0.0f ? 0.0f : b * (float)y[j * incy]);
         }
     }
 }
 
-#else
-
 template <>
-void blas::trsm<float, float>(
+void blas::ger<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
     blas::Layout layout,
-    blas::Side side,
-    blas::Uplo uplo,
-    blas::Op trans,
-    blas::Diag diag,
     int64_t m,
     int64_t n,
-    blas::scalar_type<float, float> alpha,
-    float const *A,
-    int64_t lda,
-    float *B,
-    int64_t ldb)
+    blas::scalar_type<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT> alpha,
+    HPLAI_T_LFLOAT const *x,
+    int64_t incx,
+    HPLAI_T_LFLOAT const *y,
+    int64_t incy,
+    HPLAI_T_LFLOAT *A,
+    int64_t lda)
 {
-    blas::trsm(
-        layout,
-        side,
-        uplo,
-        trans,
-        diag,
-        m,
-        n,
-        alpha,
-        A,
-        lda,
-        B,
-        ldb);
+    if (layout != blas::Layout::ColMajor)
+    {
+        blas::ger<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
+            blas::Layout::ColMajor, n, m, alpha, y, incy, x, incx, A, lda);
+        return;
+    }
+    int64_t i, j;
+    float t;
+
+    for (j = 0; j < n; j++)
+    {
+        t = (float)alpha * (float)y[j * incy];
+        for (i = 0; i < m; i++)
+            A[i + j * lda] = (float)A[i + j * lda] + (float)x[i * incx] * t;
+    }
 }
 
-#endif
+template <>
+void blas::scal<HPLAI_T_LFLOAT>(
+    int64_t n,
+    HPLAI_T_LFLOAT alpha,
+    HPLAI_T_LFLOAT *x,
+    int64_t incx)
+{
+    const float a = (float)alpha;
+    int64_t i;
+
+    for (i = 0; i < n; i++)
+        x[i * incx] = a * (float)x[i * incx];
+}
 
 template <>
-void blas::trsv<float, float>(
+void blas::trsv<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
     blas::Layout layout,
     blas::Uplo uplo,
     blas::Op trans,
     blas::Diag diag,
     int64_t n,
-    float const *A,
+    HPLAI_T_LFLOAT const *A,
     int64_t lda,
-    float *x,
+    HPLAI_T_LFLOAT *x,
     int64_t incx)
 {
-    blas::trsv(
-        layout,
-        uplo,
-        trans,
-        diag,
-        n,
-        A,
-        lda,
-        x,
-        incx);
+    if (layout != blas::Layout::ColMajor)
+    {
+        blas::trsv<HPLAI_T_LFLOAT, HPLAI_T_LFLOAT>(
+            blas::Layout::ColMajor,
+            (uplo == blas::Uplo::Lower ? blas::Uplo::Upper : blas::Uplo::Lower),
+            (trans == blas::Op::NoTrans ? blas::Op::Trans : blas::Op::NoTrans),
+            diag, n, A, lda, x, incx);
+        return;
+    }
+    float *fA, *fx;
+    int64_t i;
+
+    if (n == 0)
+        return;
+
+    fA = HPLAI_soft_malloc((size_t)n * n + (size_t)n, "blas::trsv");
+    fx = fA + (size_t)n * n;
+
+    HPLAI_soft_unpack(blas::Op::NoTrans, n, n, A, lda, fA, n);
+    for (i = 0; i < n; i++)
+        fx[i] = x[i * incx];
+    blas::trsv(blas::Layout::ColMajor, uplo, trans, diag, n, fA, n, fx, 1);
+    for (i = 0; i < n; i++)
+        x[i * incx] = fx[i];
+    free(fA);
 }
 
-#ifdef __cplusplus
-extern "C"
-{
 #endif
 
-    MPI_Datatype HPLAI_MPI_AFLOAT;
+template <>
+MPI_Datatype HPLAI_S_mpi<HPLAI_T_LFLOAT>::afloat = MPI_DATATYPE_NULL;
+
+template <>
+MPI_Datatype HPLAI_S_mpi<double>::afloat = MPI_DATATYPE_NULL;
 
 #ifdef STDC_HEADERS
     void HPLAI_blas_init(
@@ -2174,8 +2143,10 @@ void HPLAI_blas_init(RANK, SIZE)
     SIZE;
 #endif
     {
-        MPI_Type_contiguous(sizeof(HPLAI_T_AFLOAT), MPI_BYTE, &HPLAI_MPI_AFLOAT);
-        MPI_Type_commit(&HPLAI_MPI_AFLOAT);
+        MPI_Type_contiguous(sizeof(HPLAI_T_LFLOAT), MPI_BYTE, &HPLAI_S_mpi<HPLAI_T_LFLOAT>::afloat);
+        MPI_Type_commit(&HPLAI_S_mpi<HPLAI_T_LFLOAT>::afloat);
+        MPI_Type_contiguous(sizeof(double), MPI_BYTE, &HPLAI_S_mpi<double>::afloat);
+        MPI_Type_commit(&HPLAI_S_mpi<double>::afloat);
 
 #if defined(HPLAI_DEVICE_BLASPP_GEMM) || defined(HPLAI_DEVICE_BLASPP_TRSM)
         // https://github.com/NVIDIA/multi-gpu-programming-models/blob/master/mpi/jacobi.cpp
@@ -2237,9 +2208,6 @@ void HPLAI_blas_init(RANK, SIZE)
     ACLCHECK(aclrtDestroyContext(HPLAI_ACL_BLASPP_CONTEXT));
     ACLCHECK(aclFinalize());
 #endif
-        MPI_Type_free(&HPLAI_MPI_AFLOAT);
+        MPI_Type_free(&HPLAI_S_mpi<double>::afloat);
+        MPI_Type_free(&HPLAI_S_mpi<HPLAI_T_LFLOAT>::afloat);
     }
-
-#ifdef __cplusplus
-}
-#endif
@@ -0,0 +1,226 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+
+#ifdef HPL_NO_MPI_DATATYPE /* The user insists to not use MPI types */
+#ifndef HPL_COPY_L         /* and also want to avoid the copy of L ... */
+#define HPL_COPY_L         /* well, sorry, can not do that: force the copy */
+#endif
+#endif
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    int HPLAI_binit_1rinS(
+        HPLAI_T_panel *PANEL)
+#else
+int HPLAI_binit_1rinS(PANEL)
+    HPLAI_T_panel *PANEL;
+#endif
+    {
+        /*
+ * .. Local Variables ..
+ */
+        MPI_Comm comm;
+        int i, ibuf, ierr = MPI_SUCCESS, lbuf, prev, rank, root,
+                     seg, size;
+        /* ..
+ * .. Executable Statements ..
+ */
+        if (PANEL == NULL)
+        {
+            return (HPL_SUCCESS);
+        }
+        if ((size = PANEL->grid->npcol) <= 1)
+        {
+            return (HPL_SUCCESS);
+        }
+        /*
+ * Split the panel into segments of at most PANEL->algo->bseg entries
+ */
+        seg = Mmax(1, PANEL->algo->bseg);
+        PANEL->nseg = (PANEL->len + seg - 1) / seg;
+        PANEL->iseg = 0;
+        PANEL->sreq = NULL;
+
+        rank = PANEL->grid->mycol;
+        root = PANEL->pcol;
+
+        if (rank == root)
+        {
+#if defined(HPL_COPY_L) || !defined(HPL_USE_MPI_DATATYPE)
+            /*
+ * Copy the panel into a contiguous buffer
+ */
+            HPLAI_copyL(PANEL);
+#endif
+            return (HPL_SUCCESS);
+        }
+        /*
+ * Prepost the receives of all the segments from my predecessor, in the
+ * order they are sent, directly into L2, L1 and IPIV which are contigu-
+ * ous in the processes not owning the panel.
+ */
+        PANEL->sreq = (MPI_Request *)malloc((size_t)(PANEL->nseg) *
+                                            sizeof(MPI_Request));
+        if (PANEL->sreq == NULL)
+        {
+            HPLAI_pabort(__LINE__, "HPLAI_binit_1rinS",
+                         "Memory allocation failed");
+        }
+        comm = PANEL->grid->row_comm;
+        prev = MModSub1(rank, size);
+
+        for (i = 0; (i < PANEL->nseg) && (ierr == MPI_SUCCESS); i++)
+        {
+            ibuf = i * seg;
+            lbuf = Mmin(seg, PANEL->len - ibuf);
+            ierr = MPI_Irecv((void *)(PANEL->L2 + ibuf), lbuf, HPLAI_MPI_AFLOAT,
+                             prev, PANEL->msgid, comm, &PANEL->sreq[i]);
+        }
+        return ((ierr == MPI_SUCCESS ? HPL_SUCCESS : HPL_FAILURE));
+    }
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    int HPLAI_bcast_1rinS(
+        HPLAI_T_panel *PANEL,
+        int *IFLAG)
+#else
+int HPLAI_bcast_1rinS(PANEL, IFLAG)
+    HPLAI_T_panel *PANEL;
+int *IFLAG;
+#endif
+    {
+        /*
+ * .. Local Variables ..
+ */
+        MPI_Comm comm;
+        int ibuf, ierr = MPI_SUCCESS, go, lbuf, msgid, next, rank, root,
+                  seg, size;
+        /* ..
+ * .. Executable Statements ..
+ */
+        if (PANEL == NULL)
+        {
+            *IFLAG = HPL_SUCCESS;
+            return (HPL_SUCCESS);
+        }
+        if ((size = PANEL->grid->npcol) <= 1)
+        {
+            *IFLAG = HPL_SUCCESS;
+            return (HPL_SUCCESS);
+        }
+        /*
+ * Cast phase:  If I am the root process, send all the segments to my
+ * successor.  Otherwise,  forward every segment as soon as it is here,
+ * unless I am the last process of the ring.  Return when a segment has
+ * still not been received,  to let the caller update in the meantime.
+ */
+        rank = PANEL->grid->mycol;
+        comm = PANEL->grid->row_comm;
+        root = PANEL->pcol;
+        msgid = PANEL->msgid;
+        next = MModAdd1(rank, size);
+        seg = Mmax(1, PANEL->algo->bseg);
+
+        while ((PANEL->iseg < PANEL->nseg) && (ierr == MPI_SUCCESS))
+        {
+            ibuf = PANEL->iseg * seg;
+            lbuf = Mmin(seg, PANEL->len - ibuf);
+
+            if (rank == root)
+            {
+#ifdef HPL_USE_MPI_DATATYPE
+                ierr = HPLAI_packL(PANEL, ibuf, lbuf, 0);
+                if (ierr == MPI_SUCCESS)
+                    ierr = MPI_Send(PANEL->buffers[0], PANEL->counts[0],
+                                    PANEL->dtypes[0], next, msgid, comm);
+                if (ierr == MPI_SUCCESS)
+                    ierr = MPI_Type_free(&PANEL->dtypes[0]);
+#else
+                ierr = MPI_Send((void *)(PANEL->L2 + ibuf), lbuf,
+                                HPLAI_MPI_AFLOAT, next, msgid, comm);
+#endif
+            }
+            else
+            {
+                ierr = MPI_Test(&PANEL->sreq[PANEL->iseg], &go,
+                                &PANEL->status[0]);
+                if ((ierr == MPI_SUCCESS) && (go == 0))
+                {
+                    *IFLAG = HPLAI_KEEP_TESTING;
+                    return (*IFLAG);
+                }
+                if ((ierr == MPI_SUCCESS) && (next != root))
+                    ierr = MPI_Send((void *)(PANEL->L2 + ibuf), lbuf,
+                                    HPLAI_MPI_AFLOAT, next, msgid, comm);
+            }
+            PANEL->iseg++;
+        }
+        /*
+ * If all the segments were received and forwarded, return HPL_SUCCESS.
+ * If an error occured in an MPI call, return HPL_FAILURE.
+ */
+        *IFLAG = (ierr == MPI_SUCCESS ? HPL_SUCCESS : HPL_FAILURE);
+
+        return (*IFLAG);
+    }
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    int HPLAI_bwait_1rinS(
+        HPLAI_T_panel *PANEL)
+#else
+int HPLAI_bwait_1rinS(PANEL)
+    HPLAI_T_panel *PANEL;
+#endif
+    {
+        /* ..
+ * .. Executable Statements ..
+ */
+        if (PANEL == NULL)
+        {
+            return (HPL_SUCCESS);
+        }
+        if (PANEL->grid->npcol <= 1)
+        {
+            return (HPL_SUCCESS);
+        }
+        /*
+ * Release the array of requests
+ */
+        if (PANEL->sreq != NULL)
+        {
+            free(PANEL->sreq);
+            PANEL->sreq = NULL;
+        }
+        return (HPL_SUCCESS);
+    }
+
+HPLAI_INSTANTIATE(HPLAI_binit_1rinS);
+HPLAI_INSTANTIATE(HPLAI_bcast_1rinS);
+HPLAI_INSTANTIATE(HPLAI_bwait_1rinS);
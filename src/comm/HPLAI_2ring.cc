@@ -26,17 +26,13 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
 #ifdef HPL_NO_MPI_DATATYPE /* The user insists to not use MPI types */
 #ifndef HPL_COPY_L         /* and also want to avoid the copy of L ... */
 #define HPL_COPY_L         /* well, sorry, can not do that: force the copy */
 #endif
 #endif
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_binit_2ring(
         HPLAI_T_panel *PANEL)
@@ -45,12 +41,10 @@ int HPLAI_binit_2ring(PANEL)
     HPLAI_T_panel *PANEL;
 #endif
     {
-#ifdef HPL_USE_MPI_DATATYPE
         /*
  * .. Local Variables ..
  */
-        int ierr;
-#endif
+        int ierr, partner, rank, roo2, root, size;
         /* ..
  * .. Executable Statements ..
  */
@@ -58,10 +52,29 @@ int HPLAI_binit_2ring(PANEL)
         {
             return (HPL_SUCCESS);
         }
-        if (PANEL->grid->npcol <= 1)
+        if ((size = PANEL->grid->npcol) <= 1)
         {
             return (HPL_SUCCESS);
         }
+        /*
+ * Prepost the receive of the panel from my predecessor in the ring.  In
+ * the processes not owning the panel,  L2, L1 and IPIV are contiguous,
+ * so that the message lands directly in place.
+ */
+        rank = PANEL->grid->mycol;
+        root = PANEL->pcol;
+
+        if (rank != root)
+        {
+            roo2 = MModAdd(root, ((size + 1) >> 1), size);
+            partner = MModSub1(rank, size);
+            if ((partner == root) || (rank == roo2))
+                partner = root;
+            ierr = MPI_Irecv((void *)(PANEL->L2), PANEL->len, HPLAI_MPI_AFLOAT,
+                             partner, PANEL->msgid, PANEL->grid->row_comm,
+                             &PANEL->request[0]);
+            return ((ierr == MPI_SUCCESS ? HPL_SUCCESS : HPL_FAILURE));
+        }
 #ifdef HPL_USE_MPI_DATATYPE
 #ifdef HPL_COPY_L
         /*
@@ -99,6 +112,7 @@ int HPLAI_binit_2ring(PANEL)
 
 #endif
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_bcast_2ring(
         HPLAI_T_panel *PANEL,
@@ -113,7 +127,7 @@ int *IFLAG;
  * .. Local Variables ..
  */
         MPI_Comm comm;
-        int ierr, go, next, msgid, partner, rank,
+        int ierr, go, next, msgid, rank,
             roo2, root, size;
         /* ..
  * .. Executable Statements ..
@@ -130,9 +144,9 @@ int *IFLAG;
         }
         /*
  * Cast phase: root process  send to its right neighbor and mid-process.
- * If I am not the root process,  probe for message.   If the message is
- * there,  then receive it,  and  if I am not the last process  of  both
- * rings, then forward it to the next. Otherwise, inform the caller that
+ * If I am not the root process, test the receive preposted by binit. If
+ * the message is there,  and  if I am not the last process of both rings,
+ * then forward it to the next. Otherwise, inform the caller that
  * the panel has still not been received.
  */
         rank = PANEL->grid->mycol;
@@ -154,23 +168,17 @@ int *IFLAG;
         }
         else
         {
-            partner = MModSub1(rank, size);
-            if ((partner == root) || (rank == roo2))
-                partner = root;
-
-            ierr = MPI_Iprobe(partner, msgid, comm, &go, &PANEL->status[0]);
+            ierr = MPI_Test(&PANEL->request[0], &go, &PANEL->status[0]);
 
             if (ierr == MPI_SUCCESS)
             {
                 if (go != 0)
                 {
-                    ierr = MPI_Recv(_M_BUFF, _M_COUNT, _M_TYPE, partner, msgid,
-                                    comm, &PANEL->status[0]);
                     if ((ierr == MPI_SUCCESS) &&
                         (next != roo2) && (next != root))
                     {
-                        ierr = MPI_Send(_M_BUFF, _M_COUNT, _M_TYPE, next, msgid,
-                                        comm);
+                        ierr = MPI_Send((void *)(PANEL->L2), PANEL->len,
+                                        HPLAI_MPI_AFLOAT, next, msgid, comm);
                     }
                 }
                 else
@@ -189,6 +197,7 @@ int *IFLAG;
         return (*IFLAG);
     }
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_bwait_2ring(
         HPLAI_T_panel *PANEL)
@@ -218,6 +227,10 @@ int HPLAI_bwait_2ring(PANEL)
  * Release the arrays of request / status / data-types and buffers
  */
 #ifdef HPL_USE_MPI_DATATYPE
+        if (PANEL->grid->mycol != PANEL->pcol)
+        {
+            return (HPL_SUCCESS);
+        }
         ierr = MPI_Type_free(&PANEL->dtypes[0]);
 
         return ((ierr == MPI_SUCCESS ? HPL_SUCCESS : HPL_FAILURE));
@@ -226,6 +239,6 @@ int HPLAI_bwait_2ring(PANEL)
 #endif
     }
 
-#ifdef __cplusplus
-}
-#endif
\ No newline at end of file
+HPLAI_INSTANTIATE(HPLAI_binit_2ring);
+HPLAI_INSTANTIATE(HPLAI_bcast_2ring);
+HPLAI_INSTANTIATE(HPLAI_bwait_2ring);
@@ -26,17 +26,13 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
-    int HPLAI_bcast(
+    int HPLAI_bcast_topo(
         HPLAI_T_panel *PANEL,
         int *IFLAG)
 #else
-int HPLAI_bcast(PANEL, IFLAG)
+int HPLAI_bcast_topo(PANEL, IFLAG)
     HPLAI_T_panel *PANEL;
 int *IFLAG;
 #endif
@@ -49,16 +45,6 @@ int *IFLAG;
         /* ..
  * .. Executable Statements ..
  */
-        if (PANEL == NULL)
-        {
-            *IFLAG = HPL_SUCCESS;
-            return (HPL_SUCCESS);
-        }
-        if (PANEL->grid->npcol <= 1)
-        {
-            *IFLAG = HPL_SUCCESS;
-            return (HPL_SUCCESS);
-        }
         /*
  * Retrieve the selected virtual broadcast topology
  */
@@ -85,15 +71,82 @@ int *IFLAG;
             ierr = HPLAI_bcast_blong(PANEL, IFLAG);
             break;
         default:
-            ierr = HPL_SUCCESS;
+            /*
+ * The HPL-AI topologies are not enumerators of HPL_T_TOP
+ */
+            switch ((int)top)
+            {
+            case HPLAI_IBCAST:
+                ierr = HPLAI_bcast_ibcst(PANEL, IFLAG);
+                break;
+            case HPLAI_1RING_S:
+                ierr = HPLAI_bcast_1rinS(PANEL, IFLAG);
+                break;
+            case HPLAI_HIER:
+            case HPLAI_HIER_SHM:
+                ierr = HPLAI_bcast_hier(PANEL, IFLAG);
+                break;
+            default:
+                ierr = HPL_SUCCESS;
+            }
         }
 
         return (ierr);
         /*
- * End of HPLAI_bcast
+ * End of HPLAI_bcast_topo
  */
     }
 
-#ifdef __cplusplus
-}
+HPLAI_INSTANTIATE(HPLAI_bcast_topo);
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    int HPLAI_bcast(
+        HPLAI_T_panel *PANEL,
+        int *IFLAG)
+#else
+int HPLAI_bcast(PANEL, IFLAG)
+    HPLAI_T_panel *PANEL;
+int *IFLAG;
 #endif
+    {
+        /*
+ * .. Local Variables ..
+ */
+        double t0 = HPL_rzero;
+        int ierr, timed;
+        /* ..
+ * .. Executable Statements ..
+ */
+        if (PANEL == NULL)
+        {
+            *IFLAG = HPL_SUCCESS;
+            return (HPL_SUCCESS);
+        }
+        if (PANEL->grid->npcol <= 1)
+        {
+            *IFLAG = HPL_SUCCESS;
+            return (HPL_SUCCESS);
+        }
+        /*
+ * When the progress thread owns the broadcast,  only check whether it
+ * has completed. Otherwise progress it from here, as HPL does. The poll
+ * is only timed when the broadcast counters are wanted.
+ */
+        timed = HPLAI_bprog_timed();
+        if (timed)
+            t0 = HPL_ptimer_walltime();
+        if (HPLAI_bprog_test((void *)(PANEL), IFLAG))
+            ierr = *IFLAG;
+        else
+            ierr = HPLAI_bcast_topo(PANEL, IFLAG);
+        if (timed)
+            HPLAI_bprog_count(HPL_ptimer_walltime() - t0, 0);
+
+        return (ierr);
+        /*
+ * End of HPLAI_bcast
+ */
+    }
+
+HPLAI_INSTANTIATE(HPLAI_bcast);
@@ -0,0 +1,381 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+
+#ifdef HPL_NO_MPI_DATATYPE /* The user insists to not use MPI types */
+#ifndef HPL_COPY_L         /* and also want to avoid the copy of L ... */
+#define HPL_COPY_L         /* well, sorry, can not do that: force the copy */
+#endif
+#endif
+
+#ifdef HPL_USE_MPI_DATATYPE
+
+#define _M_BUFF PANEL->buffers[0]
+#define _M_COUNT PANEL->counts[0]
+#define _M_TYPE PANEL->dtypes[0]
+
+#else
+
+#define _M_BUFF (void *)(PANEL->L2)
+#define _M_COUNT PANEL->len
+#define _M_TYPE HPLAI_MPI_AFLOAT
+
+#endif
+
+template <typename HPLAI_T_AFLOAT>
+static int HPLAI_bhier_tree(
+    HPLAI_T_panel *PANEL,
+    int *LEAD,
+    int *NLEAD,
+    int *MYPOS)
+{
+    /*
+ * Purpose
+ * =======
+ *
+ * HPLAI_bhier_tree  lists in LEAD[0:NLEAD-1]  the columns of the node
+ * leaders of the process row,  starting with the root  PANEL->pcol and
+ * going around the row.  The leader of the node of the root is the root
+ * itself,  the leader of any other node is its first column.  On exit,
+ * MYPOS is the position of my column in LEAD,  or -1 if I am not a node
+ * leader. The function returns the column from which I receive the panel
+ * (-1 for the root): the leader at MYPOS minus its highest bit  in the
+ * binomial tree of the leaders, or the leader of my node.
+ *
+ * ---------------------------------------------------------------------
+ */
+    const int *node = PANEL->grid->row_node;
+    int c, i, k, mycol, mynode, parent = -1, root, size;
+
+    size = PANEL->grid->npcol;
+    mycol = PANEL->grid->mycol;
+    root = PANEL->pcol;
+    mynode = node[mycol];
+
+    *NLEAD = 0;
+    *MYPOS = -1;
+    for (k = 0; k < size; k++)
+    {
+        c = MModAdd(root, k, size);
+        for (i = 0; i < *NLEAD; i++)
+        {
+            if (node[LEAD[i]] == node[c])
+                break;
+        }
+        if (i == *NLEAD)
+        {
+            LEAD[i] = (node[c] == node[root] ? root : node[c]);
+            if (LEAD[i] == mycol)
+                *MYPOS = i;
+            (*NLEAD)++;
+        }
+        if ((node[c] == mynode) && (parent < 0))
+            parent = LEAD[i];
+    }
+
+    if (*MYPOS == 0)
+        return (-1);
+    if (*MYPOS < 0)
+        return (parent);
+
+    for (k = 1; (k << 1) <= *MYPOS; k <<= 1)
+        ;
+    return (LEAD[*MYPOS - k]);
+}
+
+template <typename HPLAI_T_AFLOAT>
+static void HPLAI_bhier_copy(
+    HPLAI_T_panel *PANEL)
+{
+    /*
+ * Purpose
+ * =======
+ *
+ * HPLAI_bhier_copy  copies the panel of the root,  i.e. L2,  L1 and IPIV,
+ * into the buffer SHM shared by the processes of its node,  with the same
+ * layout as in the processes not owning the panel.
+ *
+ * ---------------------------------------------------------------------
+ */
+    int itmp, jb, ml2;
+
+    jb = PANEL->jb;
+    itmp = jb * jb + HPLAI_IPIV_LEN(jb);
+    ml2 = PANEL->mp - (PANEL->grid->myrow == PANEL->prow ? jb : 0);
+    ml2 = Mmax(0, ml2);
+
+    HPLAI_alacpy(ml2, jb, PANEL->L2, PANEL->ldl2, PANEL->SHM, Mmax(1, ml2));
+    memcpy((void *)(PANEL->SHM + HPLAI_IALIGN(ml2 * jb)), (const void *)(PANEL->L1),
+           (size_t)(itmp) * sizeof(HPLAI_T_AFLOAT));
+}
+
+template <typename HPLAI_T_AFLOAT>
+static int HPLAI_bhier_send(
+    HPLAI_T_panel *PANEL,
+    void *BUFF,
+    int COUNT,
+    MPI_Datatype TYPE)
+{
+    /*
+ * Purpose
+ * =======
+ *
+ * HPLAI_bhier_send  sends the panel to my children: the node leaders of
+ * my binomial subtree, farthest first, then the other processes of my
+ * node if I am its leader.  When my node shares the panel in SHM, those
+ * are only sent an empty message telling that SHM is filled.
+ *
+ * ---------------------------------------------------------------------
+ */
+    const int *node = PANEL->grid->row_node;
+    int *lead;
+    int c, ierr = MPI_SUCCESS, k, mycol, mypos, nlead, size;
+
+    size = PANEL->grid->npcol;
+    mycol = PANEL->grid->mycol;
+
+    lead = (int *)malloc((size_t)(size) * sizeof(int));
+    if (lead == NULL)
+    {
+        HPLAI_pabort(__LINE__, "HPLAI_bhier_send", "Memory allocation failed");
+    }
+    (void)HPLAI_bhier_tree(PANEL, lead, &nlead, &mypos);
+
+    if (mypos >= 0)
+    {
+        for (k = 1; k < nlead; k <<= 1)
+            ;
+        for (k >>= 1; (k > mypos) && (ierr == MPI_SUCCESS); k >>= 1)
+        {
+            if (mypos + k < nlead)
+                ierr = MPI_Send(BUFF, COUNT, TYPE, lead[mypos + k],
+                                PANEL->msgid, PANEL->grid->row_comm);
+        }
+        if (PANEL->SHM != NULL)
+            (void)MPI_Win_sync(PANEL->wshm);
+        for (c = 0; (c < size) && (ierr == MPI_SUCCESS); c++)
+        {
+            if ((c == mycol) || (c == PANEL->pcol) ||
+                (node[c] != node[mycol]))
+                continue;
+            if (PANEL->SHM != NULL)
+                ierr = MPI_Send(NULL, 0, MPI_BYTE, c, PANEL->msgid,
+                                PANEL->grid->row_comm);
+            else
+                ierr = MPI_Send(BUFF, COUNT, TYPE, c, PANEL->msgid,
+                                PANEL->grid->row_comm);
+        }
+    }
+    free(lead);
+
+    return (ierr);
+}
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    int HPLAI_binit_hier(
+        HPLAI_T_panel *PANEL)
+#else
+int HPLAI_binit_hier(PANEL)
+    HPLAI_T_panel *PANEL;
+#endif
+    {
+        /*
+ * .. Local Variables ..
+ */
+        int *lead;
+        int ierr, mypos, nlead, parent;
+        /* ..
+ * .. Executable Statements ..
+ */
+        if (PANEL == NULL)
+        {
+            return (HPL_SUCCESS);
+        }
+        if (PANEL->grid->npcol <= 1)
+        {
+            return (HPL_SUCCESS);
+        }
+
+        if (PANEL->grid->mycol != PANEL->pcol)
+        {
+            /*
+ * Prepost the receive of the panel from my parent in the two-level tree
+ * directly into L2, L1 and IPIV,  which are contiguous in the processes
+ * not owning the panel.  When my node shares the panel,  only its leader
+ * receives it,  the other processes wait for the leader's notice.
+ */
+            lead = (int *)malloc((size_t)(PANEL->grid->npcol) * sizeof(int));
+            if (lead == NULL)
+            {
+                HPLAI_pabort(__LINE__, "HPLAI_binit_hier",
+                             "Memory allocation failed");
+            }
+            parent = HPLAI_bhier_tree(PANEL, lead, &nlead, &mypos);
+            free(lead);
+
+            if ((PANEL->SHM != NULL) && (mypos < 0))
+                ierr = MPI_Irecv(NULL, 0, MPI_BYTE, parent, PANEL->msgid,
+                                 PANEL->grid->row_comm, &PANEL->request[0]);
+            else
+                ierr = MPI_Irecv((void *)(PANEL->L2), PANEL->len,
+                                 HPLAI_MPI_AFLOAT, parent, PANEL->msgid,
+                                 PANEL->grid->row_comm, &PANEL->request[0]);
+            return ((ierr == MPI_SUCCESS ? HPL_SUCCESS : HPL_FAILURE));
+        }
+#ifdef HPL_USE_MPI_DATATYPE
+#ifdef HPL_COPY_L
+        /*
+ * Copy the panel into a contiguous buffer
+ */
+        HPLAI_copyL(PANEL);
+#endif
+        /*
+ * Create the MPI user-defined data type
+ */
+        ierr = HPLAI_packL(PANEL, 0, PANEL->len, 0);
+
+        return ((ierr == MPI_SUCCESS ? HPL_SUCCESS : HPL_FAILURE));
+#else
+    /*
+ * Force the copy of the panel into a contiguous buffer
+ */
+    HPLAI_copyL(PANEL);
+
+    return (HPL_SUCCESS);
+#endif
+    }
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    int HPLAI_bcast_hier(
+        HPLAI_T_panel *PANEL,
+        int *IFLAG)
+#else
+int HPLAI_bcast_hier(PANEL, IFLAG)
+    HPLAI_T_panel *PANEL;
+int *IFLAG;
+#endif
+    {
+        /*
+ * .. Local Variables ..
+ */
+        int ierr, go;
+        /* ..
+ * .. Executable Statements ..
+ */
+        if (PANEL == NULL)
+        {
+            *IFLAG = HPL_SUCCESS;
+            return (HPL_SUCCESS);
+        }
+        if (PANEL->grid->npcol <= 1)
+        {
+            *IFLAG = HPL_SUCCESS;
+            return (HPL_SUCCESS);
+        }
+        /*
+ * Cast phase:  If I am the root process,  send the panel to the leaders
+ * of my subtree and to my node,  or copy it into the buffer shared with
+ * my node.  Otherwise,  test the receive preposted by binit.  If the
+ * message is here, forward it the same way.  Otherwise, inform the caller
+ * that the panel has still not been received.
+ */
+        if (PANEL->grid->mycol == PANEL->pcol)
+        {
+            if (PANEL->SHM != NULL)
+                HPLAI_bhier_copy(PANEL);
+            ierr = HPLAI_bhier_send(PANEL, _M_BUFF, _M_COUNT, _M_TYPE);
+        }
+        else
+        {
+            ierr = MPI_Test(&PANEL->request[0], &go, &PANEL->status[0]);
+
+            if ((ierr == MPI_SUCCESS) && (go == 0))
+            {
+                *IFLAG = HPLAI_KEEP_TESTING;
+                return (*IFLAG);
+            }
+            if ((ierr == MPI_SUCCESS) && (PANEL->SHM != NULL))
+                (void)MPI_Win_sync(PANEL->wshm);
+            if (ierr == MPI_SUCCESS)
+                ierr = HPLAI_bhier_send(PANEL, (void *)(PANEL->L2), PANEL->len,
+                                        HPLAI_MPI_AFLOAT);
+        }
+        /*
+ * If the message was received and being forwarded,  return HPL_SUCCESS.
+ * If an error occured in an MPI call, return HPL_FAILURE.
+ */
+        *IFLAG = (ierr == MPI_SUCCESS ? HPL_SUCCESS : HPL_FAILURE);
+
+        return (*IFLAG);
+    }
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    int HPLAI_bwait_hier(
+        HPLAI_T_panel *PANEL)
+#else
+int HPLAI_bwait_hier(PANEL)
+    HPLAI_T_panel *PANEL;
+#endif
+    {
+#ifdef HPL_USE_MPI_DATATYPE
+        /*
+ * .. Local Variables ..
+ */
+        int ierr;
+#endif
+        /* ..
+ * .. Executable Statements ..
+ */
+        if (PANEL == NULL)
+        {
+            return (HPL_SUCCESS);
+        }
+        if (PANEL->grid->npcol <= 1)
+        {
+            return (HPL_SUCCESS);
+        }
+        /*
+ * Release the data type of the root
+ */
+#ifdef HPL_USE_MPI_DATATYPE
+        if (PANEL->grid->mycol != PANEL->pcol)
+        {
+            return (HPL_SUCCESS);
+        }
+        ierr = MPI_Type_free(&PANEL->dtypes[0]);
+        return ((ierr == MPI_SUCCESS ? HPL_SUCCESS : HPL_FAILURE));
+#else
+    return (HPL_SUCCESS);
+#endif
+    }
+
+HPLAI_INSTANTIATE(HPLAI_binit_hier);
+HPLAI_INSTANTIATE(HPLAI_bcast_hier);
+HPLAI_INSTANTIATE(HPLAI_bwait_hier);
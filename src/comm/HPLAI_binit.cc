@@ -26,11 +26,18 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
+/*
+ * Entry point of the progress thread, see HPLAI_bprog_post
+ */
+template <typename HPLAI_T_AFLOAT>
+static int HPLAI_bcast_bprog(
+    void *PANEL,
+    int *IFLAG)
 {
-#endif
+    return (HPLAI_bcast_topo((HPLAI_T_panel *)(PANEL), IFLAG));
+}
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_binit(
         HPLAI_T_panel *PANEL)
@@ -75,8 +82,30 @@ int HPLAI_binit(PANEL)
             ierr = HPLAI_binit_blong(PANEL);
             break;
         default:
-            ierr = HPL_SUCCESS;
+            /*
+ * The HPL-AI topologies are not enumerators of HPL_T_TOP
+ */
+            switch ((int)top)
+            {
+            case HPLAI_IBCAST:
+                ierr = HPLAI_binit_ibcst(PANEL);
+                break;
+            case HPLAI_1RING_S:
+                ierr = HPLAI_binit_1rinS(PANEL);
+                break;
+            case HPLAI_HIER:
+            case HPLAI_HIER_SHM:
+                ierr = HPLAI_binit_hier(PANEL);
+                break;
+            default:
+                ierr = HPL_SUCCESS;
+            }
         }
+        /*
+ * Hand the broadcast over to the progress thread, if there is one
+ */
+        if (ierr == HPL_SUCCESS)
+            (void)HPLAI_bprog_post(HPLAI_bcast_bprog<HPLAI_T_AFLOAT>, (void *)(PANEL));
 
         return (ierr);
         /*
@@ -84,6 +113,4 @@ int HPLAI_binit(PANEL)
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_binit);
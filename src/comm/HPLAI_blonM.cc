@@ -26,11 +26,6 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
 #ifdef HPL_NO_MPI_DATATYPE /* The user insists to not use MPI types */
 #ifndef HPL_COPY_L         /* and also want to avoid the copy of L ... */
 #define HPL_COPY_L         /* well, sorry, can not do that: force the copy */
@@ -40,6 +35,7 @@ extern "C"
 #define I_SEND 0
 #define I_RECV 1
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_binit_blonM(
         HPLAI_T_panel *PANEL)
@@ -128,6 +124,7 @@ int HPLAI_binit_blonM(PANEL)
 
 #endif
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_bcast_blonM(
         HPLAI_T_panel *PANEL,
@@ -455,6 +452,7 @@ int *IFLAG;
         return (*IFLAG);
     }
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_bwait_blonM(
         HPLAI_T_panel *PANEL)
@@ -478,6 +476,6 @@ int HPLAI_bwait_blonM(PANEL)
         return (HPL_SUCCESS);
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_binit_blonM);
+HPLAI_INSTANTIATE(HPLAI_bcast_blonM);
+HPLAI_INSTANTIATE(HPLAI_bwait_blonM);
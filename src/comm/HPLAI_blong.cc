@@ -26,11 +26,6 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
 #ifdef HPL_NO_MPI_DATATYPE /* The user insists to not use MPI types */
 #ifndef HPL_COPY_L         /* and also want to avoid the copy of L ... */
 #define HPL_COPY_L         /* well, sorry, can not do that: force the copy */
@@ -40,6 +35,7 @@ extern "C"
 #define I_SEND 0
 #define I_RECV 1
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_binit_blong(
         HPLAI_T_panel *PANEL)
@@ -113,6 +109,7 @@ int HPLAI_binit_blong(PANEL)
 
 #endif
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_bcast_blong(
         HPLAI_T_panel *PANEL,
@@ -358,6 +355,7 @@ int *IFLAG;
         return (*IFLAG);
     }
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_bwait_blong(
         HPLAI_T_panel *PANEL)
@@ -381,6 +379,6 @@ int HPLAI_bwait_blong(PANEL)
         return (HPL_SUCCESS);
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_binit_blong);
+HPLAI_INSTANTIATE(HPLAI_bcast_blong);
+HPLAI_INSTANTIATE(HPLAI_bwait_blong);
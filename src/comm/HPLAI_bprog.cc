@@ -0,0 +1,424 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "hplai.hh"
+
+#ifdef HPLAI_PROGRESS_THREAD
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+/*
+ * Number of unfinished polls of a broadcast between which the progress
+ * thread only yields, before it starts sleeping
+ */
+#if !defined(HPLAI_BPROG_SPIN)
+#define HPLAI_BPROG_SPIN 16
+#endif
+#endif
+
+    /*
+ * Broadcast counters, accumulated since the last call to
+ * HPLAI_bprog_stat.
+ */
+    static HPLAI_T_bstat HPLAI_bstat = {0.0, 0.0, 0};
+    /*
+ * Whether the main thread times its broadcast calls for the counters.
+ */
+    static int HPLAI_bprog_time = 0;
+
+#ifdef HPLAI_PROGRESS_THREAD
+    /*
+ * The progress thread owns at most one broadcast at a time:  the panel
+ * of the next iteration is always waited for before the following one
+ * is initiated.  FUN  and  PANEL describe the broadcast, DONE is set by
+ * the thread when it has completed, FLAG is its return value.
+ */
+    static struct
+    {
+        pthread_t thread;
+        pthread_mutex_t lock;
+        pthread_cond_t cond;
+        HPLAI_T_BPROG_FUN fun;
+        void *panel;
+        int done;
+        int flag;
+        int stop;
+        int on;
+    } HPLAI_bprog = {};
+
+    static void *HPLAI_bprog_main(void *ARG)
+    {
+        HPLAI_T_BPROG_FUN fun;
+        struct timespec ts;
+        void *panel;
+        int flag, npoll;
+
+        (void)ARG;
+        pthread_mutex_lock(&HPLAI_bprog.lock);
+        while (1)
+        {
+            while ((HPLAI_bprog.stop == 0) &&
+                   ((HPLAI_bprog.panel == NULL) || (HPLAI_bprog.done != 0)))
+                pthread_cond_wait(&HPLAI_bprog.cond, &HPLAI_bprog.lock);
+            if (HPLAI_bprog.stop != 0)
+                break;
+            fun = HPLAI_bprog.fun;
+            panel = HPLAI_bprog.panel;
+            pthread_mutex_unlock(&HPLAI_bprog.lock);
+            /*
+ * Receive and forward the panel as soon as it arrives, independently
+ * of the update running in the main thread.
+ */
+            npoll = 0;
+            while (fun(panel, &flag) == HPLAI_KEEP_TESTING)
+            {
+                /*
+ * Nothing completed: yield for the first polls, then sleep 1, 2, ... up
+ * to 64 microseconds between them, so as not to take a core away from
+ * the processes sharing it.
+ */
+                if (npoll < HPLAI_BPROG_SPIN)
+                {
+                    sched_yield();
+                }
+                else
+                {
+                    ts.tv_sec = 0;
+                    ts.tv_nsec = 1000L << (npoll - HPLAI_BPROG_SPIN);
+                    nanosleep(&ts, NULL);
+                }
+                if (npoll < HPLAI_BPROG_SPIN + 6)
+                    npoll++;
+            }
+
+            pthread_mutex_lock(&HPLAI_bprog.lock);
+            HPLAI_bprog.flag = flag;
+            HPLAI_bprog.done = 1;
+            pthread_cond_broadcast(&HPLAI_bprog.cond);
+        }
+        pthread_mutex_unlock(&HPLAI_bprog.lock);
+        return (NULL);
+    }
+#endif
+
+#ifdef STDC_HEADERS
+    int HPLAI_bprog_init(
+        const int THREAD,
+        const int TIME)
+#else
+int HPLAI_bprog_init(THREAD, TIME)
+    const int THREAD;
+const int TIME;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_bprog_init starts the  communication  progress thread, when it
+ * is compiled in (HPLAI_PROGRESS_THREAD) and the MPI library provides
+ * MPI_THREAD_MULTIPLE. Otherwise, the panel broadcasts are progressed
+ * by the polling of the update, as in HPL. It returns 1 if the thread
+ * is running, 0 otherwise.
+ *
+ * Arguments
+ * =========
+ *
+ * THREAD  (local input)                 const int
+ *         On entry, THREAD is the level of thread support provided by
+ *         MPI_Init_thread.
+ *
+ * TIME    (local input)                 const int
+ *         On entry, TIME specifies whether the main thread times its
+ *         broadcast calls for  HPLAI_bprog_stat  (non zero)  or not.
+ *         They are always timed when the progress thread is running.
+ *
+ * ---------------------------------------------------------------------
+ */
+        HPLAI_bprog_time = (TIME != 0);
+#ifdef HPLAI_PROGRESS_THREAD
+        if ((THREAD < MPI_THREAD_MULTIPLE) || (HPLAI_bprog.on != 0))
+            return (HPLAI_bprog.on);
+
+        pthread_mutex_init(&HPLAI_bprog.lock, NULL);
+        pthread_cond_init(&HPLAI_bprog.cond, NULL);
+        HPLAI_bprog.panel = NULL;
+        HPLAI_bprog.stop = 0;
+        if (pthread_create(&HPLAI_bprog.thread, NULL, HPLAI_bprog_main, NULL) == 0)
+            HPLAI_bprog.on = HPLAI_bprog_time = 1;
+        return (HPLAI_bprog.on);
+#else
+    (void)THREAD;
+    return (0);
+#endif
+        /*
+ * End of HPLAI_bprog_init
+ */
+    }
+
+#ifdef STDC_HEADERS
+    void HPLAI_bprog_finalize(void)
+#else
+void HPLAI_bprog_finalize()
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_bprog_finalize stops the communication progress thread, if any.
+ *
+ * ---------------------------------------------------------------------
+ */
+#ifdef HPLAI_PROGRESS_THREAD
+        if (HPLAI_bprog.on == 0)
+            return;
+
+        pthread_mutex_lock(&HPLAI_bprog.lock);
+        HPLAI_bprog.stop = 1;
+        pthread_cond_broadcast(&HPLAI_bprog.cond);
+        pthread_mutex_unlock(&HPLAI_bprog.lock);
+        pthread_join(HPLAI_bprog.thread, NULL);
+        pthread_cond_destroy(&HPLAI_bprog.cond);
+        pthread_mutex_destroy(&HPLAI_bprog.lock);
+        HPLAI_bprog.on = 0;
+#endif
+        /*
+ * End of HPLAI_bprog_finalize
+ */
+    }
+
+#ifdef STDC_HEADERS
+    int HPLAI_bprog_post(
+        HPLAI_T_BPROG_FUN FUN,
+        void *PANEL)
+#else
+int HPLAI_bprog_post(FUN, PANEL)
+    HPLAI_T_BPROG_FUN FUN;
+void *PANEL;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_bprog_post hands the broadcast of PANEL over to the progress
+ * thread, which calls FUN( PANEL, &flag ) until it no longer returns
+ * HPLAI_KEEP_TESTING. It returns 1 if the thread took the broadcast, 0
+ * if the caller has to progress it itself.
+ *
+ * ---------------------------------------------------------------------
+ */
+#ifdef HPLAI_PROGRESS_THREAD
+        if (HPLAI_bprog.on == 0)
+            return (0);
+
+        pthread_mutex_lock(&HPLAI_bprog.lock);
+        HPLAI_bprog.fun = FUN;
+        HPLAI_bprog.panel = PANEL;
+        HPLAI_bprog.done = 0;
+        pthread_cond_broadcast(&HPLAI_bprog.cond);
+        pthread_mutex_unlock(&HPLAI_bprog.lock);
+        return (1);
+#else
+    (void)FUN;
+    (void)PANEL;
+    return (0);
+#endif
+        /*
+ * End of HPLAI_bprog_post
+ */
+    }
+
+#ifdef STDC_HEADERS
+    int HPLAI_bprog_test(
+        void *PANEL,
+        int *IFLAG)
+#else
+int HPLAI_bprog_test(PANEL, IFLAG)
+    void *PANEL;
+int *IFLAG;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_bprog_test returns 1 if the broadcast of PANEL is owned by the
+ * progress thread,  and then sets  *IFLAG  to HPLAI_KEEP_TESTING until
+ * the thread has completed it, and to its return value afterwards. It
+ * returns 0 otherwise, leaving *IFLAG unchanged.  It yields the proces-
+ * sor while the broadcast is not completed.
+ *
+ * ---------------------------------------------------------------------
+ */
+#ifdef HPLAI_PROGRESS_THREAD
+        if ((HPLAI_bprog.on == 0) || (PANEL == NULL))
+            return (0);
+
+        pthread_mutex_lock(&HPLAI_bprog.lock);
+        if (HPLAI_bprog.panel != PANEL)
+        {
+            pthread_mutex_unlock(&HPLAI_bprog.lock);
+            return (0);
+        }
+        *IFLAG = (HPLAI_bprog.done != 0 ? HPLAI_bprog.flag : HPLAI_KEEP_TESTING);
+        pthread_mutex_unlock(&HPLAI_bprog.lock);
+        /*
+ * The caller may poll in a loop: let the progress thread run meanwhile
+ */
+        if (*IFLAG == HPLAI_KEEP_TESTING)
+            sched_yield();
+        return (1);
+#else
+    (void)PANEL;
+    (void)IFLAG;
+    return (0);
+#endif
+        /*
+ * End of HPLAI_bprog_test
+ */
+    }
+
+#ifdef STDC_HEADERS
+    int HPLAI_bprog_wait(
+        void *PANEL)
+#else
+int HPLAI_bprog_wait(PANEL)
+    void *PANEL;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_bprog_wait blocks until the progress thread has completed the
+ * broadcast of PANEL, and releases it.  It returns the return value of
+ * the broadcast, or HPL_SUCCESS if PANEL is not owned by the thread.
+ *
+ * ---------------------------------------------------------------------
+ */
+#ifdef HPLAI_PROGRESS_THREAD
+        int flag = HPL_SUCCESS;
+
+        if ((HPLAI_bprog.on == 0) || (PANEL == NULL))
+            return (flag);
+
+        pthread_mutex_lock(&HPLAI_bprog.lock);
+        if (HPLAI_bprog.panel == PANEL)
+        {
+            while (HPLAI_bprog.done == 0)
+                pthread_cond_wait(&HPLAI_bprog.cond, &HPLAI_bprog.lock);
+            flag = HPLAI_bprog.flag;
+            HPLAI_bprog.panel = NULL;
+        }
+        pthread_mutex_unlock(&HPLAI_bprog.lock);
+        return (flag);
+#else
+    (void)PANEL;
+    return (HPL_SUCCESS);
+#endif
+        /*
+ * End of HPLAI_bprog_wait
+ */
+    }
+
+#ifdef STDC_HEADERS
+    int HPLAI_bprog_timed(void)
+#else
+int HPLAI_bprog_timed()
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_bprog_timed returns 1 if the main thread has to time its calls
+ * to HPLAI_bcast and HPLAI_bwait for HPLAI_bprog_count, 0 otherwise.
+ *
+ * ---------------------------------------------------------------------
+ */
+        return (HPLAI_bprog_time);
+        /*
+ * End of HPLAI_bprog_timed
+ */
+    }
+
+#ifdef STDC_HEADERS
+    void HPLAI_bprog_count(
+        const double TIME,
+        const int NPANEL)
+#else
+void HPLAI_bprog_count(TIME, NPANEL)
+    const double TIME;
+const int NPANEL;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_bprog_count adds TIME seconds spent by the main thread in the
+ * panel broadcast, and NPANEL broadcast panels, to the counters.
+ *
+ * ---------------------------------------------------------------------
+ */
+        HPLAI_bstat.npanel += (double)(NPANEL);
+        HPLAI_bstat.tidle += TIME;
+        /*
+ * End of HPLAI_bprog_count
+ */
+    }
+
+#ifdef STDC_HEADERS
+    void HPLAI_bprog_stat(
+        HPLAI_T_bstat *STAT)
+#else
+void HPLAI_bprog_stat(STAT)
+    HPLAI_T_bstat *STAT;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_bprog_stat returns the broadcast counters of this process ac-
+ * cumulated since the previous call, and resets them.
+ *
+ * Arguments
+ * =========
+ *
+ * STAT    (local output)                HPLAI_T_bstat *
+ *         On exit, STAT contains the broadcast counters.
+ *
+ * ---------------------------------------------------------------------
+ */
+        *STAT = HPLAI_bstat;
+#ifdef HPLAI_PROGRESS_THREAD
+        STAT->thread = HPLAI_bprog.on;
+#endif
+        HPLAI_bstat.npanel = HPLAI_bstat.tidle = HPL_rzero;
+        /*
+ * End of HPLAI_bprog_stat
+ */
+    }
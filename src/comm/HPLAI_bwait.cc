@@ -26,11 +26,7 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_bwait(
         HPLAI_T_panel *PANEL)
@@ -59,7 +55,8 @@ int HPLAI_bwait(PANEL)
         /*
  * .. Local Variables ..
  */
-        int ierr;
+        double t0 = HPL_rzero, tt;
+        int ierr, timed;
         HPL_T_TOP top;
         /* ..
  * .. Executable Statements ..
@@ -67,6 +64,16 @@ int HPLAI_bwait(PANEL)
         if (PANEL->grid->npcol <= 1)
             return (HPL_SUCCESS);
         /*
+ * Wait for the progress thread to complete the broadcast, if it owns it
+ */
+        tt = HPLAI_trace_time();
+        timed = HPLAI_bprog_timed();
+        if (timed)
+            t0 = HPL_ptimer_walltime();
+        ierr = HPLAI_bprog_wait((void *)(PANEL));
+        if (ierr != HPL_SUCCESS)
+            return (ierr);
+        /*
  * Retrieve the selected virtual broadcast topology
  */
         top = PANEL->algo->btopo;
@@ -92,8 +99,28 @@ int HPLAI_bwait(PANEL)
             ierr = HPLAI_bwait_blong(PANEL);
             break;
         default:
-            ierr = HPL_SUCCESS;
+            /*
+ * The HPL-AI topologies are not enumerators of HPL_T_TOP
+ */
+            switch ((int)top)
+            {
+            case HPLAI_IBCAST:
+                ierr = HPLAI_bwait_ibcst(PANEL);
+                break;
+            case HPLAI_1RING_S:
+                ierr = HPLAI_bwait_1rinS(PANEL);
+                break;
+            case HPLAI_HIER:
+            case HPLAI_HIER_SHM:
+                ierr = HPLAI_bwait_hier(PANEL);
+                break;
+            default:
+                ierr = HPL_SUCCESS;
+            }
         }
+        if (timed)
+            HPLAI_bprog_count(HPL_ptimer_walltime() - t0, 1);
+        (void)HPLAI_trace_event(HPLAI_TRACE_BCAST, tt, PANEL->ja - PANEL->jb);
 
         return (ierr);
         /*
@@ -101,6 +128,4 @@ int HPLAI_bwait(PANEL)
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_bwait);
@@ -26,11 +26,7 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_copyL(
         HPLAI_T_panel *PANEL)
@@ -87,6 +83,4 @@ void HPLAI_copyL(PANEL)
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_copyL);
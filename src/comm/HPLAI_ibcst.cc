@@ -0,0 +1,184 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+
+#ifdef HPL_NO_MPI_DATATYPE /* The user insists to not use MPI types */
+#ifndef HPL_COPY_L         /* and also want to avoid the copy of L ... */
+#define HPL_COPY_L         /* well, sorry, can not do that: force the copy */
+#endif
+#endif
+
+#ifdef HPL_USE_MPI_DATATYPE
+
+#define _M_BUFF PANEL->buffers[0]
+#define _M_COUNT PANEL->counts[0]
+#define _M_TYPE PANEL->dtypes[0]
+
+#else
+
+#define _M_BUFF (void *)(PANEL->L2)
+#define _M_COUNT PANEL->len
+#define _M_TYPE HPLAI_MPI_AFLOAT
+
+#endif
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    int HPLAI_binit_ibcst(
+        HPLAI_T_panel *PANEL)
+#else
+int HPLAI_binit_ibcst(PANEL)
+    HPLAI_T_panel *PANEL;
+#endif
+    {
+        /*
+ * .. Local Variables ..
+ */
+        int ierr;
+        /* ..
+ * .. Executable Statements ..
+ */
+        if (PANEL == NULL)
+        {
+            return (HPL_SUCCESS);
+        }
+        if (PANEL->grid->npcol <= 1)
+        {
+            return (HPL_SUCCESS);
+        }
+#ifdef HPL_USE_MPI_DATATYPE
+#ifdef HPL_COPY_L
+        /*
+ * Copy the panel into a contiguous buffer
+ */
+        HPLAI_copyL(PANEL);
+#endif
+        /*
+ * Create the MPI user-defined data type
+ */
+        ierr = HPLAI_packL(PANEL, 0, PANEL->len, 0);
+        if (ierr != MPI_SUCCESS)
+            return (HPL_FAILURE);
+#else
+    /*
+ * Force the copy of the panel into a contiguous buffer
+ */
+    HPLAI_copyL(PANEL);
+#endif
+        /*
+ * Post the broadcast of the panel in the row of processes:  every call
+ * to HPLAI_bcast_ibcst only tests the request,  so that the MPI library
+ * progresses it in the background of the update.
+ */
+        ierr = MPI_Ibcast(_M_BUFF, _M_COUNT, _M_TYPE, PANEL->pcol,
+                          PANEL->grid->row_comm, &PANEL->request[0]);
+
+        return ((ierr == MPI_SUCCESS ? HPL_SUCCESS : HPL_FAILURE));
+    }
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    int HPLAI_bcast_ibcst(
+        HPLAI_T_panel *PANEL,
+        int *IFLAG)
+#else
+int HPLAI_bcast_ibcst(PANEL, IFLAG)
+    HPLAI_T_panel *PANEL;
+int *IFLAG;
+#endif
+    {
+        /*
+ * .. Local Variables ..
+ */
+        int ierr, go;
+        /* ..
+ * .. Executable Statements ..
+ */
+        if (PANEL == NULL)
+        {
+            *IFLAG = HPL_SUCCESS;
+            return (HPL_SUCCESS);
+        }
+        if (PANEL->grid->npcol <= 1)
+        {
+            *IFLAG = HPL_SUCCESS;
+            return (HPL_SUCCESS);
+        }
+        /*
+ * Once the broadcast is complete,  the request is MPI_REQUEST_NULL and
+ * MPI_Test keeps on returning go = 1.
+ */
+        ierr = MPI_Test(&PANEL->request[0], &go, &PANEL->status[0]);
+
+        if ((ierr == MPI_SUCCESS) && (go == 0))
+        {
+            *IFLAG = HPLAI_KEEP_TESTING;
+            return (*IFLAG);
+        }
+        *IFLAG = (ierr == MPI_SUCCESS ? HPL_SUCCESS : HPL_FAILURE);
+
+        return (*IFLAG);
+    }
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    int HPLAI_bwait_ibcst(
+        HPLAI_T_panel *PANEL)
+#else
+int HPLAI_bwait_ibcst(PANEL)
+    HPLAI_T_panel *PANEL;
+#endif
+    {
+        /*
+ * .. Local Variables ..
+ */
+        int ierr;
+        /* ..
+ * .. Executable Statements ..
+ */
+        if (PANEL == NULL)
+        {
+            return (HPL_SUCCESS);
+        }
+        if (PANEL->grid->npcol <= 1)
+        {
+            return (HPL_SUCCESS);
+        }
+        /*
+ * Complete the broadcast, if the update did not test it to the end
+ */
+        ierr = MPI_Wait(&PANEL->request[0], &PANEL->status[0]);
+#ifdef HPL_USE_MPI_DATATYPE
+        if (ierr == MPI_SUCCESS)
+            ierr = MPI_Type_free(&PANEL->dtypes[0]);
+#endif
+        return ((ierr == MPI_SUCCESS ? HPL_SUCCESS : HPL_FAILURE));
+    }
+
+HPLAI_INSTANTIATE(HPLAI_binit_ibcst);
+HPLAI_INSTANTIATE(HPLAI_bcast_ibcst);
+HPLAI_INSTANTIATE(HPLAI_bwait_ibcst);
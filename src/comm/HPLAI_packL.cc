@@ -26,11 +26,7 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_packL(
         HPLAI_T_panel *PANEL,
@@ -93,7 +89,7 @@ const int IBUF;
  */
 #ifdef HPL_COPY_L
         /*
- * Panel + L1 + DPIV  have been copied into a contiguous buffer - Create
+ * Panel + L1 + IPIV  have been copied into a contiguous buffer - Create
  * and commit a contiguous data type
  */
         PANEL->buffers[IBUF] = (void *)(PANEL->L2 + INDEX);
@@ -106,7 +102,7 @@ const int IBUF;
         return (ierr);
 #else
         /*
- * Panel is not contiguous (because of LDA and also L1 + DPIV) -  Create
+ * Panel is not contiguous (because of LDA and also L1 + IPIV) -  Create
  * and commit a struct data type
  */
         jbp1 = (jb = PANEL->jb) + 1;
@@ -189,11 +185,13 @@ const int IBUF;
                 }
             }
             /*
- * Pack L1, DPIV, DINFO
+ * Pack L1, IPIV, IINFO (the integers travel as raw HPLAI_T_AFLOAT slots).
+ * L1 starts  HPLAI_IALIGN(jbm)  entries into the buffer:  the padding in
+ * front of it is taken from the factorization workspace preceding L1.
  */
             if (len > 0)
-            { /* L1, DPIV, DINFO */
-                bufs[nbufs] = (void **)(PANEL->L1 + ibuf - jbm);
+            { /* L1, IPIV, IINFO */
+                bufs[nbufs] = (void **)(PANEL->L1 + ibuf - HPLAI_IALIGN(jbm));
                 type[nbufs] = HPLAI_MPI_AFLOAT;
                 blen[nbufs] = len;
                 if (ierr == MPI_SUCCESS)
@@ -251,6 +249,4 @@ const int IBUF;
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_packL);
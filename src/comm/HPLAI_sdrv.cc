@@ -25,11 +25,6 @@
  * Include files
  */
 #include "hplai.hh"
-
-#ifdef __cplusplus
-extern "C"
-{
-#endif
 /*
  * Do not use  MPI user-defined data types no matter what.  This routine
  * is used for small contiguous messages.
@@ -38,6 +33,7 @@ extern "C"
 #undef HPL_USE_MPI_DATATYPE
 #endif
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_sdrv(
         HPLAI_T_AFLOAT *SBUF,
@@ -222,6 +218,4 @@ MPI_Comm COMM;
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_sdrv);
@@ -73,7 +73,10 @@ int HPL_all_reduce
  * =======
  *
  * HPL_all_reduce performs   a   global   reduce  operation  across  all
- * processes of a group leaving the results on all processes.
+ * processes of a group leaving the results on all processes.  With the
+ * HPL_COLL_MPI backend (see HPL_coll_set), the reductions by HPL_sum,
+ * HPL_max and HPL_min are done by MPI_Allreduce,  or for long vectors,
+ * by MPI_Reduce_scatter followed by MPI_Allgatherv.
  *
  * Arguments
  * =========
@@ -101,10 +104,52 @@ int HPL_all_reduce
 /*
  * .. Local Variables ..
  */
-   int                        hplerr;
+   MPI_Op                     mpiop;
+   int                        * counts, * displs;
+   size_t                     esize;
+   int                        hplerr, i, lcount, rank, size;
 /* ..
  * .. Executable Statements ..
  */
+   if( ( COUNT > 0 ) && HPL_coll_op( OP, &mpiop ) )
+   {
+      (void) HPL_coll_get( &lcount );
+      (void) MPI_Comm_size( COMM, &size );
+      if( ( COUNT < lcount ) || ( COUNT < size ) || ( size == 1 ) )
+         return( MPI_Allreduce( MPI_IN_PLACE, BUFFER, COUNT,
+                                HPL_2_MPI_TYPE( DTYPE ), mpiop, COMM ) );
+/*
+ * Reduce-scatter  in contiguous blocks of about  COUNT / size  entries,
+ * move the local block from the top of BUFFER to its place and gather.
+ */
+      (void) MPI_Comm_rank( COMM, &rank );
+      counts = (int *)malloc( (size_t)(2*size) * sizeof( int ) );
+      if( counts == NULL )
+      { HPL_pabort( __LINE__, "HPL_all_reduce", "Memory allocation failed" ); }
+      displs = counts + size;
+
+      for( i = 0; i < size; i++ )
+      {
+         counts[i] = COUNT / size + ( i < COUNT % size ? 1 : 0 );
+         displs[i] = ( i == 0 ? 0 : displs[i-1] + counts[i-1] );
+      }
+      esize = ( DTYPE == HPL_INT ? sizeof( int ) : sizeof( double ) );
+
+      hplerr = MPI_Reduce_scatter( MPI_IN_PLACE, BUFFER, counts,
+                                   HPL_2_MPI_TYPE( DTYPE ), mpiop, COMM );
+      if( hplerr == MPI_SUCCESS )
+      {
+         if( displs[rank] > 0 )
+            (void) memmove( (char *)(BUFFER) + (size_t)(displs[rank]) * esize,
+                            BUFFER, (size_t)(counts[rank]) * esize );
+         hplerr = MPI_Allgatherv( MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                                  BUFFER, counts, displs,
+                                  HPL_2_MPI_TYPE( DTYPE ), COMM );
+      }
+      free( counts );
+      return( hplerr );
+   }
+
    hplerr = HPL_reduce(   BUFFER, COUNT, DTYPE, OP, 0, COMM );
    if( hplerr != MPI_SUCCESS ) return( hplerr );
    return( HPL_broadcast( BUFFER, COUNT, DTYPE,     0, COMM ) );
@@ -73,7 +73,8 @@ int HPL_broadcast
  * =======
  *
  * HPL_broadcast broadcasts  a message from the process with rank ROOT to
- * all processes in the group.
+ * all processes in the group.  With the HPL_COLL_MPI backend (see
+ * HPL_coll_set), this is done by MPI_Bcast.
  *
  * Arguments
  * =========
@@ -110,6 +111,10 @@ int HPL_broadcast
  */
    if( COUNT <= 0 ) return( MPI_SUCCESS );
    mpierr = MPI_Comm_size( COMM, &size ); if( size <= 1 ) return( mpierr );
+
+   if( HPL_coll_get( NULL ) == HPL_COLL_MPI )
+      return( MPI_Bcast( BUFFER, COUNT, HPL_2_MPI_TYPE( DTYPE ), ROOT,
+                         COMM ) );
    mpierr = MPI_Comm_rank( COMM, &rank );
 
    kk = size - 1;
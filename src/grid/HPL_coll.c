@@ -0,0 +1,173 @@
+/* 
+ * -- High Performance Computing Linpack Benchmark (HPL)                
+ *    HPL - 2.3 - December 2, 2018                          
+ *    Antoine P. Petitet                                                
+ *    University of Tennessee, Knoxville                                
+ *    Innovative Computing Laboratory                                 
+ *    (C) Copyright 2000-2008 All Rights Reserved                       
+ *                                                                      
+ * -- Copyright notice and Licensing terms:                             
+ *                                                                      
+ * Redistribution  and  use in  source and binary forms, with or without
+ * modification, are  permitted provided  that the following  conditions
+ * are met:                                                             
+ *                                                                      
+ * 1. Redistributions  of  source  code  must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.        
+ *                                                                      
+ * 2. Redistributions in binary form must reproduce  the above copyright
+ * notice, this list of conditions,  and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution. 
+ *                                                                      
+ * 3. All  advertising  materials  mentioning  features  or  use of this
+ * software must display the following acknowledgement:                 
+ * This  product  includes  software  developed  at  the  University  of
+ * Tennessee, Knoxville, Innovative Computing Laboratory.             
+ *                                                                      
+ * 4. The name of the  University,  the name of the  Laboratory,  or the
+ * names  of  its  contributors  may  not  be used to endorse or promote
+ * products  derived   from   this  software  without  specific  written
+ * permission.                                                          
+ *                                                                      
+ * -- Disclaimer:                                                       
+ *                                                                      
+ * THIS  SOFTWARE  IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING,  BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY
+ * OR  CONTRIBUTORS  BE  LIABLE FOR ANY  DIRECT,  INDIRECT,  INCIDENTAL,
+ * SPECIAL,  EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES  (INCLUDING,  BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA OR PROFITS; OR BUSINESS INTERRUPTION)  HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT,  STRICT LIABILITY,  OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ * ---------------------------------------------------------------------
+ */ 
+/*
+ * Include files
+ */
+#include "hpl.h"
+/*
+ * Collective backend used by HPL_broadcast, HPL_reduce and HPL_all_reduce,
+ * and minimum count of the all-reduce done as reduce-scatter + allgather
+ */
+static HPL_T_COLL          HPL_coll_backend = HPL_COLL_TREE;
+static int                 HPL_coll_long    = HPL_COLL_LONG;
+
+#ifdef STDC_HEADERS
+void HPL_coll_set
+(
+   const HPL_T_COLL                 BACKEND,
+   const int                        LONG
+)
+#else
+void HPL_coll_set
+( BACKEND, LONG )
+   const HPL_T_COLL                 BACKEND;
+   const int                        LONG;
+#endif
+{
+/* 
+ * Purpose
+ * =======
+ *
+ * HPL_coll_set selects the implementation of the grid collectives. With
+ * HPL_COLL_TREE, HPL_broadcast, HPL_reduce and HPL_all_reduce are the
+ * binomial trees over  MPI_Send / MPI_Recv  of HPL.  With HPL_COLL_MPI,
+ * they call MPI_Bcast, MPI_Reduce and MPI_Allreduce,  the latter being
+ * replaced by MPI_Reduce_scatter  followed by MPI_Allgatherv  for  at
+ * least LONG entries.  The reductions whose combine function is not one
+ * of HPL_sum, HPL_max or HPL_min always use the binomial trees.
+ *
+ * Arguments
+ * =========
+ *
+ * BACKEND (global input)                const HPL_T_COLL
+ *         On entry, BACKEND specifies the implementation to be used.
+ *
+ * LONG    (global input)                const int
+ *         On entry, LONG is the minimum number of entries from which an
+ *         all-reduce is split into a reduce-scatter and an allgather. A
+ *         non-positive value selects the default HPL_COLL_LONG.
+ *
+ * ---------------------------------------------------------------------
+ */ 
+/* ..
+ * .. Executable Statements ..
+ */
+   HPL_coll_backend = BACKEND;
+   HPL_coll_long    = ( LONG > 0 ? LONG : HPL_COLL_LONG );
+/*
+ * End of HPL_coll_set
+ */
+}
+
+#ifdef STDC_HEADERS
+HPL_T_COLL HPL_coll_get
+(
+   int *                            LONG
+)
+#else
+HPL_T_COLL HPL_coll_get
+( LONG )
+   int *                            LONG;
+#endif
+{
+/* 
+ * Purpose
+ * =======
+ *
+ * HPL_coll_get returns the implementation of the grid collectives, and
+ * the all-reduce splitting threshold in LONG unless it is NULL.
+ *
+ * ---------------------------------------------------------------------
+ */ 
+/* ..
+ * .. Executable Statements ..
+ */
+   if( LONG != NULL ) *LONG = HPL_coll_long;
+   return( HPL_coll_backend );
+/*
+ * End of HPL_coll_get
+ */
+}
+
+#ifdef STDC_HEADERS
+int HPL_coll_op
+(
+   const HPL_T_OP                   OP,
+   MPI_Op *                         MPIOP
+)
+#else
+int HPL_coll_op
+( OP, MPIOP )
+   const HPL_T_OP                   OP;
+   MPI_Op *                         MPIOP;
+#endif
+{
+/* 
+ * Purpose
+ * =======
+ *
+ * HPL_coll_op returns 1 and the MPI operation equivalent to  the combine
+ * function OP in MPIOP when the reductions are to be done by the MPI
+ * collectives, and 0 otherwise.
+ *
+ * ---------------------------------------------------------------------
+ */ 
+/* ..
+ * .. Executable Statements ..
+ */
+   if( HPL_coll_backend != HPL_COLL_MPI ) return( 0 );
+
+   if(      OP == HPL_sum ) *MPIOP = MPI_SUM;
+   else if( OP == HPL_max ) *MPIOP = MPI_MAX;
+   else if( OP == HPL_min ) *MPIOP = MPI_MIN;
+   else return( 0 );
+
+   return( 1 );
+/*
+ * End of HPL_coll_op
+ */
+}
@@ -93,6 +93,13 @@ int HPL_grid_exit
       mpierr = MPI_Comm_free( &(GRID->all_comm) );
       if( mpierr != MPI_SUCCESS ) hplerr = mpierr;
    }
+   if( GRID->node_comm != MPI_COMM_NULL )
+   {
+      mpierr = MPI_Comm_free( &(GRID->node_comm) );
+      if( mpierr != MPI_SUCCESS ) hplerr = mpierr;
+   }
+   if( GRID->row_node ) free( GRID->row_node );
+   GRID->row_node = NULL;
 
    GRID->order   = HPL_COLUMN_MAJOR;
 
@@ -111,7 +111,8 @@ int HPL_grid_init
  * .. Local Variables ..
  */
    int                        hdim, hplerr=MPI_SUCCESS, ierr, ip2, k,
-                              mask, mycol, myrow, nprocs, rank, size;
+                              mask, mycol, myrow, nodecol, nprocs, rank,
+                              size;
 /* ..
  * .. Executable Statements ..
  */
@@ -167,6 +168,8 @@ int HPL_grid_init
  * All communicator, leave if I am not part of this grid. Creation of the
  * row- and column communicators.
  */
+   GRID->node_comm = MPI_COMM_NULL;
+   GRID->row_node  = NULL;
    ierr = MPI_Comm_split( COMM, ( rank < nprocs ? 0 : MPI_UNDEFINED ),
                           rank, &(GRID->all_comm) );
    if( GRID->all_comm == MPI_COMM_NULL ) return( ierr );
@@ -176,6 +179,26 @@ int HPL_grid_init
 
    ierr = MPI_Comm_split( GRID->all_comm, mycol, myrow, &(GRID->col_comm) );
    if( ierr != MPI_SUCCESS ) hplerr = ierr;
+/*
+ * Identify the processes of my row sharing a node  by the first column
+ * of their node, for the node-aware panel broadcasts. The node communi-
+ * cator is kept for the panels shared by those processes.
+ */
+   if( hplerr != MPI_SUCCESS ) return( hplerr );
+
+   ierr = MPI_Comm_split_type( GRID->row_comm, MPI_COMM_TYPE_SHARED, mycol,
+                               MPI_INFO_NULL, &(GRID->node_comm) );
+   if( ierr != MPI_SUCCESS ) return( ierr );
+   ierr = MPI_Allreduce( &mycol, &nodecol, 1, MPI_INT, MPI_MIN,
+                         GRID->node_comm );
+   if( ierr != MPI_SUCCESS ) return( ierr );
+
+   GRID->row_node = (int *)malloc( (size_t)(NPCOL) * sizeof( int ) );
+   if( GRID->row_node == NULL )
+   { HPL_pabort( __LINE__, "HPL_grid_init", "Memory allocation failed" ); }
+   ierr = MPI_Allgather( &nodecol, 1, MPI_INT, GRID->row_node, 1, MPI_INT,
+                         GRID->row_comm );
+   if( ierr != MPI_SUCCESS ) hplerr = ierr;
 
    return( hplerr );
 /*
@@ -109,6 +109,7 @@ int HPL_reduce
  * .. Local Variables ..
  */
    MPI_Status                 status;
+   MPI_Op                     mpiop;
    void                       * buffer = NULL;
    int                        hplerr=MPI_SUCCESS, d=1, i, ip2=1, mask=0,
                               mpierr, mydist, partner, rank, size, 
@@ -120,6 +121,16 @@ int HPL_reduce
    mpierr = MPI_Comm_size( COMM, &size );
    if( size  == 1 ) return( MPI_SUCCESS );
    mpierr = MPI_Comm_rank( COMM, &rank );
+
+   if( HPL_coll_op( OP, &mpiop ) )
+   {
+      if( rank == ROOT )
+         return( MPI_Reduce( MPI_IN_PLACE, BUFFER, COUNT,
+                             HPL_2_MPI_TYPE( DTYPE ), mpiop, ROOT, COMM ) );
+      return( MPI_Reduce( BUFFER, NULL, COUNT, HPL_2_MPI_TYPE( DTYPE ),
+                          mpiop, ROOT, COMM ) );
+   }
+
    i = size - 1; while( i > 1 ) { i >>= 1; d++; }
 
    if( DTYPE == HPL_INT )
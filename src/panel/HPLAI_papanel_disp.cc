@@ -26,11 +26,7 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_papanel_disp(
         HPLAI_T_panel **PANEL)
@@ -66,6 +62,19 @@ int HPLAI_papanel_disp(PANEL)
  * Deallocate the panel resources and panel structure
  */
         mpierr = HPLAI_papanel_free(*PANEL);
+        if ((*PANEL)->WORK)
+            free((*PANEL)->WORK);
+        if ((*PANEL)->IWORK)
+            free((*PANEL)->IWORK);
+        if ((*PANEL)->wshm != MPI_WIN_NULL)
+        {
+            (void)MPI_Win_unlock_all((*PANEL)->wshm);
+            (void)MPI_Win_free(&(*PANEL)->wshm);
+        }
+        if ((*PANEL)->mxtype != MPI_DATATYPE_NULL)
+            (void)MPI_Type_free(&(*PANEL)->mxtype);
+        if ((*PANEL)->mxop != MPI_OP_NULL)
+            (void)MPI_Op_free(&(*PANEL)->mxop);
         if (*PANEL)
             free(*PANEL);
         *PANEL = NULL;
@@ -76,6 +85,4 @@ int HPLAI_papanel_disp(PANEL)
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_papanel_disp);
@@ -23,11 +23,7 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     int HPLAI_papanel_free(
         HPLAI_T_panel *PANEL)
@@ -41,7 +37,10 @@ int HPLAI_papanel_free(PANEL)
  * =======
  *
  * HPL_pdpanel_free deallocates  the panel resources  and  stores the error
- * code returned by the panel factorization.
+ * code returned by the panel factorization.  The workspaces  WORK  and
+ * IWORK are kept  for the next  call to  HPLAI_papanel_init  and are
+ * released by HPLAI_papanel_disp,  unless  HPLAI_NO_PANEL_POOL is defined
+ * at compile time.
  *
  * Arguments
  * =========
@@ -56,7 +55,7 @@ int HPLAI_papanel_free(PANEL)
  * .. Executable Statements ..
  */
         if (PANEL->pmat->info == 0)
-            PANEL->pmat->info = *(PANEL->DINFO);
+            PANEL->pmat->info = *(PANEL->IINFO);
 #ifdef HPL_CALL_VSIPL
         /*
  * Release the blocks
@@ -74,10 +73,16 @@ int HPLAI_papanel_free(PANEL)
             vsip_blockdestroy_d(PANEL->Ublock);
 #endif
 
+#ifdef HPLAI_NO_PANEL_POOL
         if (PANEL->WORK)
             free(PANEL->WORK);
         if (PANEL->IWORK)
             free(PANEL->IWORK);
+        PANEL->WORK = NULL;
+        PANEL->IWORK = NULL;
+        PANEL->lwork = 0;
+        PANEL->liwork = 0;
+#endif
 
         return (MPI_SUCCESS);
         /*
@@ -85,6 +90,4 @@ int HPLAI_papanel_free(PANEL)
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_papanel_free);
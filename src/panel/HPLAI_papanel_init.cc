@@ -26,17 +26,13 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
 #ifdef HPL_NO_MPI_DATATYPE /* The user insists to not use MPI types */
 #ifndef HPL_COPY_L         /* and also want to avoid the copy of L ... */
 #define HPL_COPY_L         /* well, sorry, can not do that: force the copy */
 #endif
 #endif
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_papanel_init(
         HPL_T_grid *GRID,
@@ -118,9 +114,9 @@ HPLAI_T_panel *PANEL;
  * .. Local Variables ..
  */
         size_t dalign;
-        int icurcol, icurrow, ii, itmp1, jj, lwork,
-            ml2, mp, mycol, myrow, nb, npcol, nprow,
-            nq, nu;
+        int icurcol, icurrow, ii, itmp1, jj, lpf, lwork,
+            lwant, ml2, mp, mycol, myrow, nb, npcol, nprow,
+            nq, nu, shm;
         /* ..
  * .. Executable Statements ..
  */
@@ -141,15 +137,15 @@ HPLAI_T_panel *PANEL;
         /* ptr to trailing part of A */
         PANEL->A = Mptr((HPLAI_T_AFLOAT *)(A->A), ii, jj, A->ld);
         /*
- * Workspace pointers are initialized to NULL.
+ * Workspace pointers are initialized to NULL. WORK and IWORK are kept,
+ * as they may be recycled from the previous panel (HPLAI_papanel_wget).
  */
-        PANEL->WORK = NULL;
+        PANEL->PFWORK = NULL;
         PANEL->L2 = NULL;
         PANEL->L1 = NULL;
-        PANEL->DPIV = NULL;
-        PANEL->DINFO = NULL;
+        PANEL->IPIV = NULL;
+        PANEL->IINFO = NULL;
         PANEL->U = NULL;
-        PANEL->IWORK = NULL;
         /*
  * Local lengths, indexes process coordinates
  */
@@ -179,52 +175,84 @@ HPLAI_T_panel *PANEL;
  * re initialization.
  *
  * L1:    JB x JB in all processes
- * DPIV:  JB      in all processes
- * DINFO: 1       in all processes
+ * IPIV:  JB      in all processes (integers)
+ * IINFO: 1       in all processes (integer)
+ *
+ * IPIV and IINFO are integers  stored  in  HPLAI_IPIV_LEN(JB)  entries
+ * of the  HPLAI_T_AFLOAT  buffer,  so that pivot indexes remain exact in
+ * low precision.  When HPLAI_T_AFLOAT is narrower than an int,  L1 and
+ * IPIV start on an int boundary: L1 is  HPLAI_IALIGN(ml2*JB) entries
+ * after L2, and IPIV HPLAI_IALIGN(JB*JB) entries after L1.
  *
  * We make sure that those three arrays are contiguous in memory for the
  * later panel broadcast.  We  also  choose  to put this amount of space 
  * right  after  L2 (when it exist) so that one can receive a contiguous
  * buffer.
+ *
+ * The workspace of the panel factorization  (2*(HDR+2*JB) entries with
+ * HDR = HPLAI_MXSWP_HDR) is carved out of the same allocation, in front
+ * of those arrays. When  a new allocation is needed,  it is sized for a
+ * full panel at this position,  so that it can be recycled by the panels
+ * to come, which are never larger.
  */
-        dalign = ALGO->align * sizeof(HPLAI_T_AFLOAT);
+        dalign = Mmax(ALGO->align * sizeof(HPLAI_T_AFLOAT), sizeof(int));
+        lpf = (HPLAI_MXSWP_HDR + (JB << 1)) << 1;
+        lwant = (ALGO->align << 1) + lpf + HPLAI_IALIGN(mp * JB) + JB * JB +
+                HPLAI_IPIV_LEN(JB) + (nprow > 1 ? JB * Mmax(0, nq) : 0);
 
         if (npcol == 1) /* P x 1 process grid */
-        {               /* space for L1, DPIV, DINFO */
-            lwork = ALGO->align + (PANEL->len = JB * JB + JB + 1);
+        {               /* space for L1, IPIV, IINFO */
+            lwork = (ALGO->align << 1) + lpf +
+                    (PANEL->len = JB * JB + HPLAI_IPIV_LEN(JB));
             if (nprow > 1) /* space for U */
             {
                 nu = nq - JB;
                 lwork += JB * Mmax(0, nu);
             }
 
-            if (!(PANEL->WORK = (HPLAI_T_AFLOAT *)malloc((size_t)(lwork) *
-                                                         sizeof(HPLAI_T_AFLOAT))))
-            {
-                HPLAI_pabort(__LINE__, "HPLAI_papanel_init",
-                           "Memory allocation failed");
-            }
+            PANEL->WORK = (HPLAI_T_AFLOAT *)HPLAI_papanel_wget(
+                PANEL->WORK, &PANEL->lwork,
+                (size_t)(lwork) * sizeof(HPLAI_T_AFLOAT),
+                (size_t)(lwant) * sizeof(HPLAI_T_AFLOAT));
+            PANEL->PFWORK = (HPLAI_T_AFLOAT *)HPL_PTR(PANEL->WORK, dalign);
             /*
  * Initialize the pointers of the panel structure  -  Always re-use A in
  * the only process column
  */
             PANEL->L2 = PANEL->A + (myrow == icurrow ? JB : 0);
             PANEL->ldl2 = A->ld;
-            PANEL->L1 = (HPLAI_T_AFLOAT *)HPL_PTR(PANEL->WORK, dalign);
-            PANEL->DPIV = PANEL->L1 + JB * JB;
-            PANEL->DINFO = PANEL->DPIV + JB;
-            *(PANEL->DINFO) = 0.0;
-            PANEL->U = (nprow > 1 ? PANEL->DINFO + 1 : NULL);
+            PANEL->L1 = (HPLAI_T_AFLOAT *)HPL_PTR(PANEL->PFWORK + lpf, dalign);
+            PANEL->IPIV = (int *)(PANEL->L1 + HPLAI_IALIGN(JB * JB));
+            PANEL->IINFO = PANEL->IPIV + JB;
+            *(PANEL->IINFO) = 0;
+            PANEL->U = (nprow > 1 ? PANEL->L1 + JB * JB + HPLAI_IPIV_LEN(JB) : NULL);
         }
         else
-        { /* space for L2, L1, DPIV */
+        { /* space for L2, L1, IPIV */
             ml2 = (myrow == icurrow ? mp - JB : mp);
             ml2 = Mmax(0, ml2);
-            PANEL->len = ml2 * JB + (itmp1 = JB * JB + JB + 1);
+            PANEL->len = HPLAI_IALIGN(ml2 * JB) + (itmp1 = JB * JB + HPLAI_IPIV_LEN(JB));
+            /*
+ * With the shared panel broadcast, L2, L1 and IPIV of the processes not
+ * owning the panel are the node shared buffer SHM, which is sized for a
+ * full panel.  Only the factorization workspace and U remain private.
+ */
+            if (ALGO->btopo == HPLAI_HIER_SHM)
+                HPLAI_papanel_shm(PANEL,
+                                  (size_t)(PANEL->len) * sizeof(HPLAI_T_AFLOAT),
+                                  (size_t)(HPLAI_IALIGN(mp * JB) + itmp1) * sizeof(HPLAI_T_AFLOAT));
+            shm = ((PANEL->SHM != NULL) && (mycol != icurcol));
+
+            if (shm)
+            {
+                lwant -= HPLAI_IALIGN(mp * JB) + itmp1;
+                lwork = (ALGO->align << 1) + lpf;
+            }
+            else
 #ifdef HPL_COPY_L
-            lwork = ALGO->align + PANEL->len;
+                lwork = (ALGO->align << 1) + lpf + PANEL->len;
 #else
-        lwork = ALGO->align + (mycol == icurcol ? itmp1 : PANEL->len);
+            lwork = (ALGO->align << 1) + lpf + (mycol == icurcol ? itmp1 : PANEL->len);
 #endif
             if (nprow > 1) /* space for U */
             {
@@ -232,38 +260,56 @@ HPLAI_T_panel *PANEL;
                 lwork += JB * Mmax(0, nu);
             }
 
-            if (!(PANEL->WORK = (HPLAI_T_AFLOAT *)malloc((size_t)(lwork) *
-                                                         sizeof(HPLAI_T_AFLOAT))))
-            {
-                HPLAI_pabort(__LINE__, "HPLAI_papanel_init",
-                           "Memory allocation failed");
-            }
+            PANEL->WORK = (HPLAI_T_AFLOAT *)HPLAI_papanel_wget(
+                PANEL->WORK, &PANEL->lwork,
+                (size_t)(lwork) * sizeof(HPLAI_T_AFLOAT),
+                (size_t)(lwant) * sizeof(HPLAI_T_AFLOAT));
+            PANEL->PFWORK = (HPLAI_T_AFLOAT *)HPL_PTR(PANEL->WORK, dalign);
 /*
  * Initialize the pointers of the panel structure - Re-use A in the cur-
  * rent process column when HPL_COPY_L is not defined.
  */
+            if (shm)
+            {
+                PANEL->L2 = PANEL->SHM;
+                PANEL->ldl2 = Mmax(1, ml2);
+                PANEL->L1 = PANEL->L2 + HPLAI_IALIGN(ml2 * JB);
+            }
+            else
+            {
 #ifdef HPL_COPY_L
-            PANEL->L2 = (HPLAI_T_AFLOAT *)HPL_PTR(PANEL->WORK, dalign);
-            PANEL->ldl2 = Mmax(1, ml2);
-            PANEL->L1 = PANEL->L2 + ml2 * JB;
+                PANEL->L2 = (HPLAI_T_AFLOAT *)HPL_PTR(PANEL->PFWORK + lpf, dalign);
+                PANEL->ldl2 = Mmax(1, ml2);
+                PANEL->L1 = PANEL->L2 + HPLAI_IALIGN(ml2 * JB);
 #else
-        if (mycol == icurcol)
-        {
-            PANEL->L2 = PANEL->A + (myrow == icurrow ? JB : 0);
-            PANEL->ldl2 = A->ld;
-            PANEL->L1 = (HPLAI_T_AFLOAT *)HPL_PTR(PANEL->WORK, dalign);
-        }
-        else
-        {
-            PANEL->L2 = (HPLAI_T_AFLOAT *)HPL_PTR(PANEL->WORK, dalign);
-            PANEL->ldl2 = Mmax(1, ml2);
-            PANEL->L1 = PANEL->L2 + ml2 * JB;
-        }
+            if (mycol == icurcol)
+            {
+                PANEL->L2 = PANEL->A + (myrow == icurrow ? JB : 0);
+                PANEL->ldl2 = A->ld;
+                PANEL->L1 = (HPLAI_T_AFLOAT *)HPL_PTR(PANEL->PFWORK + lpf, dalign);
+            }
+            else
+            {
+                PANEL->L2 = (HPLAI_T_AFLOAT *)HPL_PTR(PANEL->PFWORK + lpf, dalign);
+                PANEL->ldl2 = Mmax(1, ml2);
+                PANEL->L1 = PANEL->L2 + HPLAI_IALIGN(ml2 * JB);
+            }
 #endif
-            PANEL->DPIV = PANEL->L1 + JB * JB;
-            PANEL->DINFO = PANEL->DPIV + JB;
-            *(PANEL->DINFO) = 0.0;
-            PANEL->U = (nprow > 1 ? PANEL->DINFO + 1 : NULL);
+            }
+            PANEL->IPIV = (int *)(PANEL->L1 + HPLAI_IALIGN(JB * JB));
+            PANEL->IINFO = PANEL->IPIV + JB;
+            /*
+ * The shared IINFO is set by the broadcast only: the leader of my node
+ * may already have received the panel.
+ */
+            if (!shm)
+                *(PANEL->IINFO) = 0;
+            if (nprow == 1)
+                PANEL->U = NULL;
+            else if (shm)
+                PANEL->U = (HPLAI_T_AFLOAT *)HPL_PTR(PANEL->PFWORK + lpf, dalign);
+            else
+                PANEL->U = PANEL->L1 + JB * JB + HPLAI_IPIV_LEN(JB);
         }
 #ifdef HPL_CALL_VSIPL
         PANEL->Ablock = A->block;
@@ -336,12 +382,9 @@ HPLAI_T_panel *PANEL;
             lwork = 4 + (9 * JB) + (3 * nprow) + itmp1;
         }
 
-        PANEL->IWORK = (int *)malloc((size_t)(lwork) * sizeof(int));
-
-        if (PANEL->IWORK == NULL)
-        {
-            HPLAI_pabort(__LINE__, "HPLAI_papanel_init", "Memory allocation failed");
-        }
+        PANEL->IWORK = (int *)HPLAI_papanel_wget(
+            PANEL->IWORK, &PANEL->liwork, (size_t)(lwork) * sizeof(int),
+            (size_t)(lwork) * sizeof(int));
         /* Initialize the first entry of the workarray */
         *(PANEL->IWORK) = -1;
         /*
@@ -349,6 +392,4 @@ HPLAI_T_panel *PANEL;
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
\ No newline at end of file
+HPLAI_INSTANTIATE(HPLAI_papanel_init);
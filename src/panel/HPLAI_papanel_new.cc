@@ -26,11 +26,7 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_papanel_new(
         HPL_T_grid *GRID,
@@ -71,6 +67,19 @@ HPLAI_T_panel **PANEL;
         {
             HPLAI_pabort(__LINE__, "HPLAI_papanel_new", "Memory allocation failed");
         }
+        /*
+ * No workspace to recycle yet
+ */
+        p->WORK = NULL;
+        p->IWORK = NULL;
+        p->lwork = 0;
+        p->liwork = 0;
+        p->wshm = MPI_WIN_NULL;
+        p->SHM = NULL;
+        p->lshm = 0;
+        p->mxtype = MPI_DATATYPE_NULL;
+        p->mxop = MPI_OP_NULL;
+        p->mxn0 = 0;
 
         HPLAI_papanel_init(GRID, ALGO, M, N, JB, A, IA, JA, TAG, p);
         *PANEL = p;
@@ -79,6 +88,4 @@ HPLAI_T_panel **PANEL;
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_papanel_new);
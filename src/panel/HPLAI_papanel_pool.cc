@@ -0,0 +1,146 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "hplai.hh"
+
+    /*
+ * Panel workspace counters, accumulated since the last call to
+ * HPLAI_papanel_wstat.
+ */
+    static HPLAI_T_pwstat HPLAI_pwstat = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+#ifdef STDC_HEADERS
+    void *HPLAI_papanel_wget(
+        void *WORK,
+        size_t *SIZE,
+        const size_t NEED,
+        const size_t WANT)
+#else
+void *HPLAI_papanel_wget(WORK, SIZE, NEED, WANT)
+    void *WORK;
+size_t *SIZE;
+const size_t NEED;
+const size_t WANT;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_papanel_wget returns a panel workspace of at least NEED bytes.
+ * When the workspace  WORK  of  *SIZE bytes  previously  attached to the
+ * panel is large enough, it is recycled as is. Otherwise it is released
+ * and a new workspace of Mmax( NEED, WANT ) bytes is allocated and first
+ * touched, so that the page faults are paid once for all,  rather than
+ * in every iteration of the factorization.
+ *
+ * Arguments
+ * =========
+ *
+ * WORK    (local input)                 void *
+ *         On entry, WORK is the workspace currently owned by the panel,
+ *         or NULL.
+ *
+ * SIZE    (local input/output)          size_t *
+ *         On entry, *SIZE is the size of WORK in bytes. On exit, it is
+ *         the size of the returned workspace.
+ *
+ * NEED    (local input)                 const size_t
+ *         On entry, NEED is the number of bytes needed by the panel.
+ *
+ * WANT    (local input)                 const size_t
+ *         On entry, WANT is the number of bytes to allocate when a new
+ *         workspace is needed,  i.e.  the worst case over the panels to
+ *         come.
+ *
+ * ---------------------------------------------------------------------
+ */
+        /*
+ * .. Local Variables ..
+ */
+        double t0;
+        size_t len;
+        /* ..
+ * .. Executable Statements ..
+ */
+        if ((WORK != NULL) && (*SIZE >= NEED))
+        {
+            HPLAI_pwstat.nreuse += HPL_rone;
+            HPLAI_pwstat.breuse += (double)(NEED);
+            return (WORK);
+        }
+
+        t0 = HPL_ptimer_walltime();
+        if (WORK)
+            free(WORK);
+        len = Mmax(NEED, WANT);
+        if (!(WORK = malloc(len)))
+        {
+            HPLAI_pabort(__LINE__, "HPLAI_papanel_wget", "Memory allocation failed");
+        }
+        memset(WORK, 0, len);
+        *SIZE = len;
+
+        HPLAI_pwstat.nalloc += HPL_rone;
+        HPLAI_pwstat.balloc += (double)(len);
+        HPLAI_pwstat.talloc += HPL_ptimer_walltime() - t0;
+
+        return (WORK);
+        /*
+ * End of HPLAI_papanel_wget
+ */
+    }
+
+#ifdef STDC_HEADERS
+    void HPLAI_papanel_wstat(
+        HPLAI_T_pwstat *STAT)
+#else
+void HPLAI_papanel_wstat(STAT)
+    HPLAI_T_pwstat *STAT;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_papanel_wstat returns  the  panel  workspace counters of  this
+ * process accumulated since the previous call, and resets them.
+ *
+ * Arguments
+ * =========
+ *
+ * STAT    (local output)                HPLAI_T_pwstat *
+ *         On exit, STAT contains the panel workspace counters.
+ *
+ * ---------------------------------------------------------------------
+ */
+        /* ..
+ * .. Executable Statements ..
+ */
+        *STAT = HPLAI_pwstat;
+        HPLAI_pwstat.nalloc = HPLAI_pwstat.balloc = HPLAI_pwstat.talloc = HPL_rzero;
+        HPLAI_pwstat.nreuse = HPLAI_pwstat.breuse = HPL_rzero;
+        /*
+ * End of HPLAI_papanel_wstat
+ */
+    }
@@ -0,0 +1,132 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "hplai.hh"
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    void HPLAI_papanel_shm(
+        HPLAI_T_panel *PANEL,
+        const size_t NEED,
+        const size_t WANT)
+#else
+void HPLAI_papanel_shm(PANEL, NEED, WANT)
+    HPLAI_T_panel *PANEL;
+const size_t NEED;
+const size_t WANT;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_papanel_shm attaches to PANEL a buffer of at least NEED bytes,
+ * shared by the processes of my row on my node. It is the MPI shared
+ * memory window PANEL->wshm of the first of those processes.  As in
+ * HPLAI_papanel_wget,  the window of the previous panel is recycled when
+ * it is large enough,  otherwise it is released and a window of Mmax(
+ * NEED, WANT ) bytes is allocated and first touched.  On exit, PANEL->SHM
+ * is NULL when I am alone on my node.
+ *
+ * This function is collective over GRID->node_comm.  It returns once all
+ * the processes of my node are done with the previous panel,  so that
+ * the buffer can be overwritten by the next broadcast.
+ *
+ * Arguments
+ * =========
+ *
+ * PANEL   (local input/output)          HPLAI_T_panel *
+ *         On entry,  PANEL  points to the data structure containing the
+ *         panel information.
+ *
+ * NEED    (local input)                 const size_t
+ *         On entry, NEED is the number of bytes needed by the panel. It
+ *         must be the same in all the processes of my node.
+ *
+ * WANT    (local input)                 const size_t
+ *         On entry, WANT is the number of bytes to allocate when a new
+ *         window is needed.  It must be the same in all the processes of
+ *         my node.
+ *
+ * ---------------------------------------------------------------------
+ */
+        /*
+ * .. Local Variables ..
+ */
+        MPI_Comm comm = PANEL->grid->node_comm;
+        MPI_Aint len;
+        void *base;
+        int disp, ierr, rank, size;
+        /* ..
+ * .. Executable Statements ..
+ */
+        PANEL->SHM = NULL;
+        if (comm == MPI_COMM_NULL)
+            return;
+        (void)MPI_Comm_size(comm, &size);
+        if (size <= 1)
+            return;
+
+        if ((PANEL->wshm != MPI_WIN_NULL) && (PANEL->lshm >= NEED))
+        {
+            (void)MPI_Win_shared_query(PANEL->wshm, 0, &len, &disp, &base);
+            PANEL->SHM = (HPLAI_T_AFLOAT *)base;
+            (void)MPI_Win_sync(PANEL->wshm);
+            (void)MPI_Barrier(comm);
+            (void)MPI_Win_sync(PANEL->wshm);
+            return;
+        }
+
+        if (PANEL->wshm != MPI_WIN_NULL)
+        {
+            (void)MPI_Win_unlock_all(PANEL->wshm);
+            (void)MPI_Win_free(&PANEL->wshm);
+        }
+        (void)MPI_Comm_rank(comm, &rank);
+        len = (MPI_Aint)(rank == 0 ? Mmax(NEED, WANT) : 0);
+        ierr = MPI_Win_allocate_shared(len, (int)(sizeof(HPLAI_T_AFLOAT)),
+                                       MPI_INFO_NULL, comm, &base, &PANEL->wshm);
+        if (ierr == MPI_SUCCESS)
+            ierr = MPI_Win_shared_query(PANEL->wshm, 0, &len, &disp, &base);
+        if (ierr != MPI_SUCCESS)
+        {
+            HPLAI_pabort(__LINE__, "HPLAI_papanel_shm",
+                         "Shared memory window allocation failed");
+        }
+        (void)MPI_Win_lock_all(MPI_MODE_NOCHECK, PANEL->wshm);
+        if (rank == 0)
+            memset(base, 0, (size_t)(len));
+        PANEL->SHM = (HPLAI_T_AFLOAT *)base;
+        PANEL->lshm = (size_t)(len);
+        /*
+ * Nobody writes to the window before it is zeroed
+ */
+        (void)MPI_Win_sync(PANEL->wshm);
+        (void)MPI_Barrier(comm);
+        (void)MPI_Win_sync(PANEL->wshm);
+        /*
+ * End of HPLAI_papanel_shm
+ */
+    }
+
+HPLAI_INSTANTIATE(HPLAI_papanel_shm);
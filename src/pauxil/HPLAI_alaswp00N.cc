@@ -26,11 +26,6 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
 /*
  * Define default value for unrolling factor
  */
@@ -39,6 +34,7 @@ extern "C"
 #define HPL_LASWP00N_LOG2_DEPTH 5
 #endif
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_alaswp00N(
         const int M,
@@ -311,6 +307,4 @@ const int *IPIV;
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_alaswp00N);
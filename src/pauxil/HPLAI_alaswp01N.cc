@@ -26,11 +26,6 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
 /*
  * Define default value for unrolling factor
  */
@@ -39,6 +34,7 @@ extern "C"
 #define HPL_LASWP01N_LOG2_DEPTH 5
 #endif
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_alaswp01N(
         const int M,
@@ -284,6 +280,4 @@ const int *LINDXAU;
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_alaswp01N);
@@ -26,11 +26,6 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
 /*
  * Define default value for unrolling factor
  */
@@ -39,6 +34,7 @@ extern "C"
 #define HPL_LASWP01T_LOG2_DEPTH 5
 #endif
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_alaswp01T(
         const int M,
@@ -362,6 +358,4 @@ const int *LINDXAU;
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_alaswp01T);
@@ -26,11 +26,7 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_alocmax(
         HPLAI_T_panel *PANEL,
@@ -52,12 +48,13 @@ HPLAI_T_AFLOAT *WORK;
  * =======
  *
  * HPLAI_alocmax finds  the maximum entry in the current column  and packs
- * the useful information in  WORK[0:3].  On exit,  WORK[0] contains the
- * local maximum  absolute value  scalar,  WORK[1] is the  corresponding
- * local row index,  WORK[2]  is the corresponding global row index, and
- * WORK[3] is the coordinate of the process owning this max.  When N  is
- * less than 1, the WORK[0:2] is initialized to zero, and WORK[3] is set
- * to the total number of process rows.
+ * the useful information in  the header of WORK  (see HPLAI_MXSWP_HDR).
+ * On exit, WORK[0] contains the local maximum absolute value scalar and
+ * the integers  HPLAI_MXSWP_LINDX, HPLAI_MXSWP_GINDX and HPLAI_MXSWP_PROW
+ * of the header are  the corresponding local row index,  global row in-
+ * dex and the coordinate of the process owning this max.   When N is less
+ * than 1, WORK[0] and the row indexes are initialized to zero,  and the
+ * process coordinate is set to the total number of process rows.
  *
  * Arguments
  * =========
@@ -79,11 +76,11 @@ HPLAI_T_AFLOAT *WORK;
  *         be operated on starts with respect to the panel.
  *
  * WORK    (local workspace)             HPLAI_T_AFLOAT *
- *         On entry, WORK  is  a workarray of size at least 4.  On exit,
- *         WORK[0] contains  the  local  maximum  absolute value scalar,
- *         WORK[1] contains  the corresponding local row index,  WORK[2]
- *         contains the corresponding global row index, and  WORK[3]  is
- *         the coordinate of process owning this max.
+ *         On entry, WORK  is  a workarray of size at least HPLAI_MXSWP_HDR.
+ *         On exit, WORK[0] contains the local maximum absolute value
+ *         scalar, and the header integers contain the corresponding
+ *         local and global row indexes and the coordinate of process
+ *         owning this max.
  *
  * ---------------------------------------------------------------------
  */
@@ -105,30 +102,30 @@ HPLAI_T_AFLOAT *WORK;
             Mindxl2g(igindx, kk, nb, nb, myrow, 0, nprow);
             /*
  * WORK[0] := local maximum absolute value scalar,
- * WORK[1] := corresponding local  row index,
- * WORK[2] := corresponding global row index,
- * WORK[3] := coordinate of process owning this max.
+ * LINDX   := corresponding local  row index,
+ * GINDX   := corresponding global row index,
+ * PROW    := coordinate of process owning this max.
  */
             WORK[0] = A[ilindx];
-            WORK[1] = (HPLAI_T_AFLOAT)(ilindx);
-            WORK[2] = (HPLAI_T_AFLOAT)(igindx);
-            WORK[3] = (HPLAI_T_AFLOAT)(myrow);
+            HPLAI_mxswp_seti(WORK, HPLAI_MXSWP_LINDX, ilindx);
+            HPLAI_mxswp_seti(WORK, HPLAI_MXSWP_GINDX, igindx);
+            HPLAI_mxswp_seti(WORK, HPLAI_MXSWP_PROW, myrow);
         }
         else
         {
             /*
  * If I do not have any row of A, then set the coordinate of the process
- * (WORK[3]) owning this "ghost" row,  such that it  will never be used,
+ * (PROW) owning this "ghost" row,  such that  it  will  never be used,
  * even if there are only zeros in the current column of A.
  */
-            WORK[0] = WORK[1] = WORK[2] = HPLAI_rzero;
-            WORK[3] = (HPLAI_T_AFLOAT)(PANEL->grid->nprow);
+            WORK[0] = HPLAI_rzero;
+            HPLAI_mxswp_seti(WORK, HPLAI_MXSWP_LINDX, 0);
+            HPLAI_mxswp_seti(WORK, HPLAI_MXSWP_GINDX, 0);
+            HPLAI_mxswp_seti(WORK, HPLAI_MXSWP_PROW, PANEL->grid->nprow);
         }
         /*
  * End of HPLAI_alocmax
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_alocmax);
@@ -25,11 +25,6 @@
  * Include files
  */
 #include "hplai.hh"
-
-#ifdef __cplusplus
-extern "C"
-{
-#endif
 /*
  * Define default value for unrolling factor
  */
@@ -38,6 +33,7 @@ extern "C"
 #define HPL_LOCSWP_LOG2_DEPTH 5
 #endif
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_alocswpN(
         HPLAI_T_panel *PANEL,
@@ -76,12 +72,12 @@ HPLAI_T_AFLOAT *WORK;
  *         be operated on starts with respect to the panel.
  *
  * WORK    (local workspace)             HPLAI_T_AFLOAT *
- *         On entry, WORK  is a workarray of size at least 2 * (4+2*N0).
- *         WORK[0] contains  the  local  maximum  absolute value scalar,
- *         WORK[1] contains  the corresponding local row index,  WORK[2]
- *         contains the corresponding global row index, and  WORK[3]  is
- *         the coordinate of process owning this max.  The N0 length max
- *         row is stored in WORK[4:4+N0-1];  Note  that this is also the
+ *         On entry, WORK  is a workarray of size at least 2 * (HDR+2*N0)
+ *         with HDR = HPLAI_MXSWP_HDR. WORK[0] contains the local maximum
+ *         absolute value scalar, the header integers contain the corres-
+ *         ponding local and global row indexes and the coordinate of the
+ *         process owning this max.    The N0 length max row is stored in
+ *         WORK[HDR:HDR+N0-1];  Note  that this is also the
  *         JJth row  (or column) of L1. The remaining part of this array
  *         is used as workspace.
  *
@@ -101,7 +97,7 @@ HPLAI_T_AFLOAT *WORK;
         n0 = PANEL->jb;
         lda = PANEL->lda;
 
-        Wr0 = (Wmx = WORK + 4) + n0;
+        Wr0 = (Wmx = WORK + HPLAI_MXSWP_HDR) + n0;
         Wmx[JJ] = gmax = WORK[0];
         nu = (int)(((unsigned int)(n0) >> HPL_LOCSWP_LOG2_DEPTH)
                    << HPL_LOCSWP_LOG2_DEPTH);
@@ -123,12 +119,12 @@ HPLAI_T_AFLOAT *WORK;
                 /*
  * and if I also own the row to be swapped with the current row of A ...
  */
-                if (myrow == (int)(WORK[3]))
+                if (myrow == HPLAI_mxswp_geti(WORK, HPLAI_MXSWP_PROW))
                 {
                     /*
  * and if the current row of A is not to swapped with itself ...
  */
-                    if ((ilindx = (int)(WORK[1])) != 0)
+                    if ((ilindx = HPLAI_mxswp_geti(WORK, HPLAI_MXSWP_LINDX)) != 0)
                     {
                         /*
  * then copy the max row into L1 and locally swap the 2 rows of A.
@@ -624,9 +620,9 @@ HPLAI_T_AFLOAT *WORK;
                 /*
  * and if I own the max row, overwrite it with the current row Wr0.
  */
-                if (myrow == (int)(WORK[3]))
+                if (myrow == HPLAI_mxswp_geti(WORK, HPLAI_MXSWP_PROW))
                 {
-                    A2 = Mptr(PANEL->A, II + (size_t)(WORK[1]), 0, lda);
+                    A2 = Mptr(PANEL->A, II + (size_t)(HPLAI_mxswp_geti(WORK, HPLAI_MXSWP_LINDX)), 0, lda);
 
                     for (i = 0; i < nu; i += HPL_LOCSWP_DEPTH,
                         Wr0 += HPL_LOCSWP_DEPTH)
@@ -806,14 +802,12 @@ HPLAI_T_AFLOAT *WORK;
             /*
  * set INFO.
  */
-            if (*(PANEL->DINFO) == 0.0)
-                *(PANEL->DINFO) = (HPLAI_T_AFLOAT)(PANEL->ia + JJ + 1);
+            if (*(PANEL->IINFO) == 0)
+                *(PANEL->IINFO) = PANEL->ia + JJ + 1;
         }
         /*
  * End of HPLAI_alocswpN
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
\ No newline at end of file
+HPLAI_INSTANTIATE(HPLAI_alocswpN);
@@ -26,11 +26,7 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_pafact(
         HPLAI_T_panel *PANEL)
@@ -85,8 +81,8 @@ void HPLAI_pafact(PANEL)
         /*
  * .. Local Variables ..
  */
-        void *vptr = NULL;
-        int align, jb;
+        double tt;
+        int jb;
         /* ..
  * .. Executable Statements ..
  */
@@ -96,23 +92,16 @@ void HPLAI_pafact(PANEL)
 
         if ((PANEL->grid->mycol != PANEL->pcol) || (jb <= 0))
             return;
+        tt = HPLAI_trace_time();
 #ifdef HPL_DETAILED_TIMING
         HPL_ptimer(HPL_TIMING_RPFACT);
 #endif
-        align = PANEL->algo->align;
-        vptr = (void *)malloc(((size_t)(align) +
-                               (size_t)(((4 + ((unsigned int)(jb) << 1)) << 1))) *
-                              sizeof(HPLAI_T_AFLOAT));
-        if (vptr == NULL)
-        {
-            HPLAI_pabort(__LINE__, "HPLAI_pafact", "Memory allocation failed");
-        }
         /*
- * Factor the panel - Update the panel pointers
+ * Factor the panel in the workspace set aside by HPLAI_papanel_init,
+ * without pivoting if requested and possible - Update the panel pointers
  */
-        PANEL->algo->rffun(PANEL, PANEL->mp, jb, 0, (HPLAI_T_AFLOAT *)HPL_PTR(vptr, ((size_t)(align) * sizeof(HPLAI_T_AFLOAT))));
-        if (vptr)
-            free(vptr);
+        if ((PANEL->algo->nopiv == 0) || (HPLAI_panopiv(PANEL) != 0))
+            PANEL->algo->rffun(PANEL, PANEL->mp, jb, 0, PANEL->PFWORK);
 
         PANEL->A = Mptr(PANEL->A, 0, jb, PANEL->lda);
         PANEL->nq -= jb;
@@ -120,11 +109,10 @@ void HPLAI_pafact(PANEL)
 #ifdef HPL_DETAILED_TIMING
         HPL_ptimer(HPL_TIMING_RPFACT);
 #endif
+        (void)HPLAI_trace_event(HPLAI_TRACE_PFACT, tt, PANEL->ja - jb);
         /*
  * End of HPLAI_pafact
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_pafact);
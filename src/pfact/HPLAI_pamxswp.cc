@@ -26,11 +26,7 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_pamxswp(
         HPLAI_T_panel *PANEL,
@@ -67,6 +63,9 @@ HPLAI_T_AFLOAT *WORK;
  * process  column. Mono-directional links  will cause the communication
  * cost to HPLAI_T_AFLOAT.
  *
+ * When ALGO->mxswp is set,  the exchange is left to a single MPI_Allreduce
+ * instead, see HPLAI_pamxswpA.
+ *
  * Arguments
  * =========
  *
@@ -87,10 +86,11 @@ HPLAI_T_AFLOAT *WORK;
  *         be operated on starts with respect to the panel.
  *
  * WORK    (local workspace)             HPLAI_T_AFLOAT *
- *         On entry, WORK  is a workarray of size at least 2 * (4+2*N0).
- *         It  is assumed that  HPLAI_alocmax  was called  prior  to  this
- *         routine to  initialize  the first four entries of this array.
- *         On exit, the  N0  length max row is stored in WORK[4:4+N0-1];
+ *         On entry, WORK  is a workarray of size at least 2 * (HDR+2*N0)
+ *         with HDR = HPLAI_MXSWP_HDR.  It is assumed that  HPLAI_alocmax
+ *         was called prior to this routine to initialize the header  of
+ *         this array. On exit, the N0 length max row is stored in
+ *         WORK[HDR:HDR+N0-1];
  *         Note that this is also the  JJth  row  (or column) of L1. The
  *         remaining part is used as a temporary array.
  *
@@ -103,6 +103,7 @@ HPLAI_T_AFLOAT *WORK;
         HPLAI_T_AFLOAT *A0, *Wmx, *Wwork;
         HPL_T_grid *grid;
         MPI_Comm comm;
+        double tt;
         unsigned int hdim, ip2, ip2_, ipow, k, mask;
         int Np2, cnt_, cnt0, i, icurrow, lda, mydist,
             mydis_, myrow, n0, nprow, partner, rcnt,
@@ -110,6 +111,12 @@ HPLAI_T_AFLOAT *WORK;
 /* ..
  * .. Executable Statements ..
  */
+        if (PANEL->algo->mxswp != 0)
+        {
+            HPLAI_pamxswpA(PANEL, M, II, JJ, WORK);
+            return;
+        }
+        tt = HPLAI_trace_time();
 #ifdef HPL_DETAILED_TIMING
         HPL_ptimer(HPL_TIMING_MXSWP);
 #endif
@@ -130,15 +137,15 @@ HPLAI_T_AFLOAT *WORK;
         mydist = MModSub(myrow, icurrow, nprow);
         /*
  * Set up pointers in workspace:  WORK and Wwork  point to the beginning
- * of the buffers of size 4 + 2*N0 to be combined. Wmx points to the row
+ * of the buffers of size HDR + 2*N0 to be combined. Wmx points to the row
  * owning the local (before combine) and global (after combine) absolute
  * value max. A0 points to the copy of the current row of the matrix.
  */
-        cnt0 = (cnt_ = n0 + 4) + n0;
-        A0 = (Wmx = WORK + 4) + n0;
+        cnt0 = (cnt_ = n0 + HPLAI_MXSWP_HDR) + n0;
+        A0 = (Wmx = WORK + HPLAI_MXSWP_HDR) + n0;
         Wwork = WORK + cnt0;
         /*
- * Wmx[0:N0-1] := A[ilindx,0:N0-1] where ilindx is  (int)(WORK[1])  (row
+ * Wmx[0:N0-1] := A[ilindx,0:N0-1] where ilindx is the LINDX  header entry (row
  * with max in current column). If I am the current process row, pack in
  * addition the current row of A in A0[0:N0-1].  If I do not own any row
  * of A, then zero out Wmx[0:N0-1].
@@ -146,7 +153,7 @@ HPLAI_T_AFLOAT *WORK;
         if (M > 0)
         {
             lda = PANEL->lda;
-            blas::copy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(n0, Mptr(PANEL->A, II + (int)(WORK[1]), 0, lda), lda,
+            blas::copy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(n0, Mptr(PANEL->A, II + HPLAI_mxswp_geti(WORK, HPLAI_MXSWP_LINDX), 0, lda), lda,
                                                        Wmx, 1);
             if (myrow == icurrow)
             {
@@ -187,10 +194,11 @@ HPLAI_T_AFLOAT *WORK;
                 else
                     (void)HPLAI_recv(Wwork, cnt_, MModAdd(partner, icurrow, nprow), MSGID_BEGIN_PFACT, comm);
 
-                tmp1 = Mabs(Wwork[0]);
-                gmax = Mabs(WORK[0]);
+                tmp1 = fabs(Wwork[0]);
+                gmax = fabs(WORK[0]);
                 if ((tmp1 > gmax) ||
-                    ((tmp1 == gmax) && (Wwork[3] < WORK[3])))
+                    ((tmp1 == gmax) && (HPLAI_mxswp_geti(Wwork, HPLAI_MXSWP_PROW) <
+                                        HPLAI_mxswp_geti(WORK, HPLAI_MXSWP_PROW))))
                 {
                     blas::copy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(cnt_, Wwork, 1, WORK, 1);
                 }
@@ -234,10 +242,11 @@ HPLAI_T_AFLOAT *WORK;
                 (void)HPLAI_sdrv(WORK, scnt, MSGID_BEGIN_PFACT, Wwork, rcnt,
                                  MSGID_BEGIN_PFACT, MModAdd(partner, icurrow, nprow), comm);
 
-                tmp1 = Mabs(Wwork[0]);
-                gmax = Mabs(WORK[0]);
+                tmp1 = fabs(Wwork[0]);
+                gmax = fabs(WORK[0]);
                 if ((tmp1 > gmax) ||
-                    ((tmp1 == gmax) && (Wwork[3] < WORK[3])))
+                    ((tmp1 == gmax) && (HPLAI_mxswp_geti(Wwork, HPLAI_MXSWP_PROW) <
+                                        HPLAI_mxswp_geti(WORK, HPLAI_MXSWP_PROW))))
                 {
                     blas::copy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>((rcnt == cnt0 ? cnt0 : cnt_), Wwork, 1,
                                                                WORK, 1);
@@ -307,15 +316,14 @@ HPLAI_T_AFLOAT *WORK;
         /*
  * Save the global pivot index in pivot array
  */
-        (PANEL->DPIV)[JJ] = WORK[2];
+        (PANEL->IPIV)[JJ] = HPLAI_mxswp_geti(WORK, HPLAI_MXSWP_GINDX);
 #ifdef HPL_DETAILED_TIMING
         HPL_ptimer(HPL_TIMING_MXSWP);
 #endif
+        (void)HPLAI_trace_event(HPLAI_TRACE_MXSWP, tt, PANEL->ja - PANEL->jb);
         /*
  * End of HPLAI_pamxswp
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_pamxswp);
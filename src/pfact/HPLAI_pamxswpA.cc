@@ -0,0 +1,234 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    static void HPLAI_pamxswpA_op(
+        void *INVEC,
+        void *INOUTVEC,
+        int *LEN,
+        MPI_Datatype *DTYPE)
+#else
+static void HPLAI_pamxswpA_op(INVEC, INOUTVEC, LEN, DTYPE)
+    void *INVEC;
+void *INOUTVEC;
+int *LEN;
+MPI_Datatype *DTYPE;
+#endif
+    {
+        /*
+ * User-defined reduction of  HPLAI_pamxswpA:  INOUTVEC  takes the max,
+ * its indexes and the max row of INVEC  with the  same rule as the bi-
+ * nary exchange  (larger absolute value,  then smaller process row),
+ * and the current row of A from whichever buffer carries it. The panel
+ * width N0 is recovered from the size of the datatype.
+ */
+        HPLAI_T_AFLOAT gmax, tmp1;
+        HPLAI_T_AFLOAT *Win, *Wio;
+        int i, k, n0, size;
+
+        (void)MPI_Type_size(*DTYPE, &size);
+        n0 = (int)(((size_t)(size) - sizeof(HPLAI_T_AFLOAT) -
+                    HPLAI_MXSWP_NINT * sizeof(int)) /
+                   (2 * sizeof(HPLAI_T_AFLOAT)));
+
+        for (k = 0; k < *LEN; k++)
+        {
+            Win = (HPLAI_T_AFLOAT *)(INVEC) + (size_t)(k) * (HPLAI_MXSWP_HDR + 2 * n0);
+            Wio = (HPLAI_T_AFLOAT *)(INOUTVEC) + (size_t)(k) * (HPLAI_MXSWP_HDR + 2 * n0);
+
+            tmp1 = fabs(Win[0]);
+            gmax = fabs(Wio[0]);
+            if ((tmp1 > gmax) ||
+                ((tmp1 == gmax) && (HPLAI_mxswp_geti(Win, HPLAI_MXSWP_PROW) <
+                                    HPLAI_mxswp_geti(Wio, HPLAI_MXSWP_PROW))))
+            {
+                Wio[0] = Win[0];
+                HPLAI_mxswp_seti(Wio, HPLAI_MXSWP_LINDX, HPLAI_mxswp_geti(Win, HPLAI_MXSWP_LINDX));
+                HPLAI_mxswp_seti(Wio, HPLAI_MXSWP_GINDX, HPLAI_mxswp_geti(Win, HPLAI_MXSWP_GINDX));
+                HPLAI_mxswp_seti(Wio, HPLAI_MXSWP_PROW, HPLAI_mxswp_geti(Win, HPLAI_MXSWP_PROW));
+                for (i = 0; i < n0; i++)
+                    Wio[HPLAI_MXSWP_HDR + i] = Win[HPLAI_MXSWP_HDR + i];
+            }
+            if (HPLAI_mxswp_geti(Win, HPLAI_MXSWP_CURR) != 0)
+            {
+                HPLAI_mxswp_seti(Wio, HPLAI_MXSWP_CURR, 1);
+                for (i = 0; i < n0; i++)
+                    Wio[HPLAI_MXSWP_HDR + n0 + i] = Win[HPLAI_MXSWP_HDR + n0 + i];
+            }
+        }
+    }
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    void HPLAI_pamxswpA(
+        HPLAI_T_panel *PANEL,
+        const int M,
+        const int II,
+        const int JJ,
+        HPLAI_T_AFLOAT *WORK)
+#else
+void HPLAI_pamxswpA(PANEL, M, II, JJ, WORK)
+    HPLAI_T_panel *PANEL;
+const int M;
+const int II;
+const int JJ;
+HPLAI_T_AFLOAT *WORK;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_pamxswpA swaps and broadcasts  the  absolute value max row with
+ * a single MPI_Allreduce in the process column.  It is the alternative
+ * to the binary exchange of HPLAI_pamxswp selected by ALGO->mxswp,  and
+ * produces the same WORK array.
+ *
+ * The header (max, local and global row indexes,  owning process row),
+ * the max row and the current row of A are described by one derived
+ * datatype, reduced with a user-defined commutative operation  keeping
+ * the tie-breaking rule of the binary exchange. The MPI library is thus
+ * free to use its own,  possibly offloaded,  allreduce algorithm.  The
+ * datatype and the operation are created once and kept in the panel.
+ *
+ * Arguments
+ * =========
+ *
+ * PANEL   (local input/output)          HPLAI_T_panel *
+ *         On entry,  PANEL  points to the data structure containing the
+ *         panel information.
+ *
+ * M       (local input)                 const int
+ *         On entry,  M specifies the local number of rows of the matrix
+ *         column on which this function operates.
+ *
+ * II      (local input)                 const int
+ *         On entry, II  specifies the row offset where the column to be
+ *         operated on starts with respect to the panel.
+ *
+ * JJ      (local input)                 const int
+ *         On entry, JJ  specifies the column offset where the column to
+ *         be operated on starts with respect to the panel.
+ *
+ * WORK    (local workspace)             HPLAI_T_AFLOAT *
+ *         On entry, WORK  is a workarray of size at least 2 * (HDR+2*N0)
+ *         with HDR = HPLAI_MXSWP_HDR.  It is assumed that  HPLAI_alocmax
+ *         was called prior to this routine to initialize the header  of
+ *         this array. On exit, the N0 length max row is stored in
+ *         WORK[HDR:HDR+N0-1] and the current row of A in the next N0
+ *         entries.
+ *
+ * ---------------------------------------------------------------------
+ */
+        /*
+ * .. Local Variables ..
+ */
+        MPI_Aint disp[3];
+        MPI_Datatype types[3];
+        HPLAI_T_AFLOAT *A0, *Wmx;
+        double tt;
+        int blen[3], i, ierr, myrow, n0;
+/* ..
+ * .. Executable Statements ..
+ */
+        tt = HPLAI_trace_time();
+#ifdef HPL_DETAILED_TIMING
+        HPL_ptimer(HPL_TIMING_MXSWP);
+#endif
+        myrow = PANEL->grid->myrow;
+        n0 = PANEL->jb;
+        A0 = (Wmx = WORK + HPLAI_MXSWP_HDR) + n0;
+        /*
+ * Build the datatype for this panel width  and the operation,  unless
+ * they are left from a previous panel
+ */
+        ierr = MPI_SUCCESS;
+        if ((PANEL->mxtype != MPI_DATATYPE_NULL) && (PANEL->mxn0 != n0))
+            ierr = MPI_Type_free(&PANEL->mxtype);
+        if (PANEL->mxtype == MPI_DATATYPE_NULL)
+        {
+            blen[0] = 1;
+            blen[1] = HPLAI_MXSWP_NINT;
+            blen[2] = n0 << 1;
+            disp[0] = 0;
+            disp[1] = (MPI_Aint)(sizeof(HPLAI_T_AFLOAT));
+            disp[2] = (MPI_Aint)(HPLAI_MXSWP_HDR * sizeof(HPLAI_T_AFLOAT));
+            types[0] = types[2] = HPLAI_MPI_AFLOAT;
+            types[1] = MPI_INT;
+            if (ierr == MPI_SUCCESS)
+                ierr = MPI_Type_create_struct(3, blen, disp, types, &PANEL->mxtype);
+            if (ierr == MPI_SUCCESS)
+                ierr = MPI_Type_commit(&PANEL->mxtype);
+            PANEL->mxn0 = n0;
+        }
+        if ((ierr == MPI_SUCCESS) && (PANEL->mxop == MPI_OP_NULL))
+            ierr = MPI_Op_create(HPLAI_pamxswpA_op<HPLAI_T_AFLOAT>, 1, &PANEL->mxop);
+        /*
+ * Wmx[0:N0-1] := A[ilindx,0:N0-1] where ilindx is the LINDX  header entry (row
+ * with max in current column). If I am the current process row, pack in
+ * addition the current row of A in A0[0:N0-1] and flag it.  If I do not
+ * own any row of A, then zero out Wmx[0:N0-1].
+ */
+        if (M > 0)
+        {
+            blas::copy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(n0, Mptr(PANEL->A, II + HPLAI_mxswp_geti(WORK, HPLAI_MXSWP_LINDX), 0, PANEL->lda),
+                                                       PANEL->lda, Wmx, 1);
+            if (myrow == PANEL->prow)
+            {
+                blas::copy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(n0, Mptr(PANEL->A, II, 0, PANEL->lda), PANEL->lda, A0, 1);
+            }
+        }
+        else
+        {
+            for (i = 0; i < n0; i++)
+                Wmx[i] = HPLAI_rzero;
+        }
+        HPLAI_mxswp_seti(WORK, HPLAI_MXSWP_CURR, (myrow == PANEL->prow ? 1 : 0));
+        /*
+ * Combine the results in every process of the column
+ */
+        if (ierr == MPI_SUCCESS)
+            ierr = MPI_Allreduce(MPI_IN_PLACE, (void *)(WORK), 1, PANEL->mxtype,
+                                 PANEL->mxop, PANEL->grid->col_comm);
+        if (ierr != MPI_SUCCESS)
+            HPLAI_pabort(__LINE__, "HPLAI_pamxswpA", "MPI call failed");
+        /*
+ * Save the global pivot index in pivot array
+ */
+        (PANEL->IPIV)[JJ] = HPLAI_mxswp_geti(WORK, HPLAI_MXSWP_GINDX);
+#ifdef HPL_DETAILED_TIMING
+        HPL_ptimer(HPL_TIMING_MXSWP);
+#endif
+        (void)HPLAI_trace_event(HPLAI_TRACE_MXSWP, tt, PANEL->ja - PANEL->jb);
+        /*
+ * End of HPLAI_pamxswpA
+ */
+    }
+
+HPLAI_INSTANTIATE(HPLAI_pamxswpA);
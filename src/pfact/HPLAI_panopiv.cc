@@ -0,0 +1,154 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    int HPLAI_panopiv(
+        HPLAI_T_panel *PANEL)
+#else
+int HPLAI_panopiv(PANEL)
+    HPLAI_T_panel *PANEL;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_panopiv factorizes a panel of columns without pivoting.  The
+ * process row owning the diagonal block factors a copy of it in L1, and
+ * broadcasts L1 together with the (identity) pivots to the other process
+ * rows, which obtain their part of L  with a single triangular solve.
+ * This replaces the  JB  pivot searches and row exchanges of the partial
+ * pivoting factorization by one broadcast, the result being only stable
+ * for matrices that do not need pivoting,  e.g. diagonally dominant ones.
+ *
+ * The pivot growth is checked in the diagonal block:  if any pivot is
+ * zero or smaller than HPLAI_NOPIV_TOL times the largest entry below it,
+ * the panel is left unchanged, the owner sets IPIV[0] to -1, and all the
+ * process rows return 1  so that the caller  factors the panel  with
+ * partial pivoting instead.  After a random butterfly transformation
+ * (ALGO->rbt > 0), only a zero pivot is rejected:  the refinement does
+ * not apply row interchanges,  and it corrects the growth instead.
+ *
+ * Arguments
+ * =========
+ *
+ * PANEL   (local input/output)          HPLAI_T_panel *
+ *         On entry,  PANEL  points to the data structure containing the
+ *         panel information.
+ *
+ * ---------------------------------------------------------------------
+ */
+        /*
+ * .. Local Variables ..
+ */
+        HPLAI_T_AFLOAT *A, *L1, *Ljj, tmp;
+        double amax, piv, tol;
+        int curr, i, ia, j, jb, lda, ltran, m;
+        /* ..
+ * .. Executable Statements ..
+ */
+        jb = PANEL->jb;
+        A = PANEL->A;
+        L1 = PANEL->L1;
+        lda = PANEL->lda;
+        ia = PANEL->ia;
+        curr = (PANEL->grid->myrow == PANEL->prow);
+        m = PANEL->mp - (curr != 0 ? jb : 0);
+        tol = (PANEL->algo->rbt > 0 ? HPL_rzero : HPLAI_NOPIV_TOL);
+        ltran = ((PANEL->algo->upfun == HPLAI_paupdateTN<HPLAI_T_AFLOAT>) ||
+                 (PANEL->algo->upfun == HPLAI_paupdateTT<HPLAI_T_AFLOAT>));
+        /*
+ * Right looking LU of the diagonal block in L1,  stopping at the first
+ * pivot that does not pass the growth check.
+ */
+        if (curr != 0)
+        {
+            HPLAI_alacpy(jb, jb, A, lda, L1, jb);
+
+            for (j = 0; j < jb; j++)
+            {
+                Ljj = Mptr(L1, j, j, jb);
+                piv = fabs((double)(Ljj[0]));
+                for (amax = piv, i = 1; i < jb - j; i++)
+                    amax = Mmax(amax, fabs((double)(Ljj[i])));
+                if ((piv == HPL_rzero) || (piv < tol * amax))
+                    break;
+
+                blas::scal<HPLAI_T_AFLOAT>(jb - j - 1, HPLAI_rone / Ljj[0], Ljj + 1, 1);
+                blas::ger<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+                    blas::Layout::ColMajor, jb - j - 1, jb - j - 1, -HPLAI_rone,
+                    Ljj + 1, 1, Ljj + jb, jb, Ljj + jb + 1, jb);
+            }
+            for (i = 0; i < jb; i++)
+                PANEL->IPIV[i] = ia + i;
+            if (j < jb)
+                PANEL->IPIV[0] = -1;
+        }
+        /*
+ * Broadcast L1 and IPIV (contiguous) in the process column
+ */
+        (void)MPI_Bcast((void *)(L1), jb * jb + HPLAI_IPIV_LEN(jb),
+                        HPLAI_MPI_AFLOAT, PANEL->prow, PANEL->grid->col_comm);
+        if (PANEL->IPIV[0] < 0)
+            return (1);
+        /*
+ * L := A * inv( U ) in the rows below the diagonal block, and copy the
+ * factored diagonal block back into A in the current process row
+ */
+        if (m > 0)
+        {
+            blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Side::Right, blas::Uplo::Upper, blas::Op::NoTrans,
+                                                       blas::Diag::NonUnit, m, jb, HPLAI_rone, L1, jb,
+                                                       (curr != 0 ? Mptr(A, jb, 0, lda) : A), lda);
+        }
+        if (curr != 0)
+            HPLAI_alacpy(jb, jb, L1, jb, A, lda);
+        /*
+ * The transposed updates expect L1 in transposed form
+ */
+        if (ltran)
+        {
+            for (j = 0; j < jb; j++)
+            {
+                for (i = j + 1; i < jb; i++)
+                {
+                    tmp = *Mptr(L1, i, j, jb);
+                    *Mptr(L1, i, j, jb) = *Mptr(L1, j, i, jb);
+                    *Mptr(L1, j, i, jb) = tmp;
+                }
+            }
+        }
+
+        return (0);
+        /*
+ * End of HPLAI_panopiv
+ */
+    }
+
+HPLAI_INSTANTIATE(HPLAI_panopiv);
@@ -26,11 +26,7 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_papancrT(
         HPLAI_T_panel *PANEL,
@@ -102,7 +98,8 @@ HPLAI_T_AFLOAT *WORK;
  *         in A.
  *
  * WORK    (local workspace)             HPLAI_T_AFLOAT *
- *         On entry, WORK  is a workarray of size at least 2*(4+2*N0).
+ *         On entry, WORK  is a workarray of size at least 2*(HDR+2*N0)
+ *         with HDR = HPLAI_MXSWP_HDR.
  *
  * ---------------------------------------------------------------------
  */
@@ -264,6 +261,4 @@ HPLAI_T_AFLOAT *WORK;
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_papancrT);
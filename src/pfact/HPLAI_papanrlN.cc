@@ -26,11 +26,7 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_papanrlN(
         HPLAI_T_panel *PANEL,
@@ -103,7 +99,8 @@ HPLAI_T_AFLOAT *WORK;
  *         in A.
  *
  * WORK    (local workspace)             HPLAI_T_AFLOAT *
- *         On entry, WORK  is a workarray of size at least 2*(4+2*N0).
+ *         On entry, WORK  is a workarray of size at least 2*(HDR+2*N0)
+ *         with HDR = HPLAI_MXSWP_HDR.
  *
  * ---------------------------------------------------------------------
  */
@@ -173,7 +170,7 @@ HPLAI_T_AFLOAT *WORK;
  */
             if (WORK[0] != HPLAI_rzero)
                 blas::scal<HPLAI_T_AFLOAT>(Mm1, HPLAI_rone / WORK[0], Acur, 1);
-            blas::axpy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(Mm1, -WORK[4 + jj + 1], Acur, 1, Anxt, 1);
+            blas::axpy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(Mm1, -WORK[HPLAI_MXSWP_HDR + jj + 1], Acur, 1, Anxt, 1);
             HPLAI_alocmax(PANEL, Mm1, iip1, jj + 1, WORK);
 #ifdef HPL_CALL_VSIPL
             if (Nm1 > 1)
@@ -199,7 +196,7 @@ HPLAI_T_AFLOAT *WORK;
 #else
         if (Nm1 > 1)
             blas::ger<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, Mm1, Nm1 - 1, -HPLAI_rone, Acur, 1,
-                                                                      WORK + 4 + jj + 2, 1, Mptr(Anxt, 0, 1, lda), lda);
+                                                                      WORK + HPLAI_MXSWP_HDR + jj + 2, 1, Mptr(Anxt, 0, 1, lda), lda);
 #endif
             /*
  * Same thing as above but with worse data access on y (A += x * y^T)
@@ -248,6 +245,4 @@ HPLAI_T_AFLOAT *WORK;
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_papanrlN);
@@ -0,0 +1,254 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    void HPLAI_papanthT(
+        HPLAI_T_panel *PANEL,
+        const int M,
+        const int N,
+        const int ICOFF,
+        HPLAI_T_AFLOAT *WORK)
+#else
+void HPLAI_papanthT(PANEL, M, N, ICOFF, WORK)
+    HPLAI_T_panel *PANEL;
+const int M;
+const int N;
+const int ICOFF;
+HPLAI_T_AFLOAT *WORK;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_papanthT factorizes  a panel of columns  that is a sub-array of a
+ * larger one-dimensional panel A using the Right-looking variant of the
+ * usual one-dimensional algorithm,  with the local rows of the panel cut
+ * into contiguous blocks shared by a team of OpenMP threads.  The lower
+ * triangular N0-by-N0 upper block of the panel is stored in transpose
+ * form.
+ *
+ * Every thread searches  the  absolute value max of the current column,
+ * scales it and performs the rank-1 update in its own block of rows. The
+ * master thread  merges the thread maxima  into  WORK[0:HDR-1]  (first
+ * max wins,  as  in  HPLAI_alocmax)  and  performs  the swap::broadcast
+ * operation with HPLAI_pamxswp and HPLAI_alocswpT: the team thus only
+ * synchronizes around the pivot exchange of each column.  The  result is
+ * the one of HPLAI_papanrlT.
+ *
+ * The team has at most OMP_NUM_THREADS threads, and at least
+ * HPLAI_PFTHR_ROWS rows per thread.  HPLAI_papanrlT is called instead
+ * when this leaves a single thread,  when the panel is factored from an
+ * active parallel region, or when MPI does not provide at least
+ * MPI_THREAD_SERIALIZED.
+ *
+ * Arguments
+ * =========
+ *
+ * PANEL   (local input/output)          HPLAI_T_panel *
+ *         On entry,  PANEL  points to the data structure containing the
+ *         panel information.
+ *
+ * M       (local input)                 const int
+ *         On entry,  M specifies the local number of rows of sub(A).
+ *
+ * N       (local input)                 const int
+ *         On entry,  N specifies the local number of columns of sub(A).
+ *
+ * ICOFF   (global input)                const int
+ *         On entry, ICOFF specifies the row and column offset of sub(A)
+ *         in A.
+ *
+ * WORK    (local workspace)             HPLAI_T_AFLOAT *
+ *         On entry, WORK  is a workarray of size at least 2*(HDR+2*N0)
+ *         with HDR = HPLAI_MXSWP_HDR.
+ *
+ * ---------------------------------------------------------------------
+ */
+        /*
+ * .. Local Variables ..
+ */
+        HPLAI_T_AFLOAT *A, *L1, *tmax;
+        int *tidx, curr, i0, lda, n0, nthr = 1;
+#ifdef _OPENMP
+        int thread;
+#endif
+/* ..
+ * .. Executable Statements ..
+ */
+#ifdef _OPENMP
+        MPI_Query_thread(&thread);
+        if ((thread >= MPI_THREAD_SERIALIZED) && (omp_in_parallel() == 0))
+            nthr = Mmax(1, Mmin(omp_get_max_threads(), M / HPLAI_PFTHR_ROWS));
+#endif
+        if (nthr <= 1)
+        {
+            HPLAI_papanrlT(PANEL, M, N, ICOFF, WORK);
+            return;
+        }
+#ifdef HPL_DETAILED_TIMING
+        HPL_ptimer(HPL_TIMING_PFACT);
+#endif
+        A = PANEL->A;
+        lda = PANEL->lda;
+        L1 = PANEL->L1;
+        n0 = PANEL->jb;
+        curr = (int)(PANEL->grid->myrow == PANEL->prow);
+        i0 = (curr != 0 ? ICOFF : 0);
+        /*
+ * One absolute value max and its row per thread, -1 for an empty block
+ */
+        tmax = (HPLAI_T_AFLOAT *)malloc((size_t)(nthr) * sizeof(HPLAI_T_AFLOAT));
+        tidx = (int *)malloc((size_t)(nthr) * sizeof(int));
+        if ((tmax == NULL) || (tidx == NULL))
+            HPLAI_pabort(__LINE__, "HPLAI_papanthT", "Memory allocation failed");
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthr)
+#endif
+        {
+            HPLAI_T_AFLOAT *Acur, *Anxt;
+            int Mm1, Nm1, hi, ii, iip1, jj, lo, m = M, mt, me = 0, nt = 1,
+                                                  r0;
+#ifdef _OPENMP
+            me = omp_get_thread_num();
+            nt = omp_get_num_threads();
+#endif
+            lo = i0 + (int)(((long)(M) * (long)(me)) / (long)(nt));
+            hi = i0 + (int)(((long)(M) * (long)(me + 1)) / (long)(nt));
+
+            Nm1 = N - 1;
+            jj = ICOFF;
+            if (curr != 0)
+            {
+                ii = ICOFF;
+                iip1 = ii + 1;
+                Mm1 = m - 1;
+            }
+            else
+            {
+                ii = 0;
+                iip1 = ii;
+                Mm1 = m;
+            }
+            /*
+ * Find the absolute value max of the first column in this block of rows
+ */
+            r0 = Mmax(lo, ii);
+            mt = hi - r0;
+            tidx[me] = (mt > 0 ? r0 + blas::iamax<HPLAI_T_AFLOAT>(mt, Mptr(A, r0, jj, lda), 1) : -1);
+            if (tidx[me] >= 0)
+                tmax[me] = *Mptr(A, tidx[me], jj, lda);
+
+            while (Nm1 >= 0)
+            {
+#ifdef _OPENMP
+#pragma omp barrier
+#pragma omp master
+#endif
+                {
+                    /*
+ * Merge the thread maxima - initialize WORK[0:HDR-1] - Swap and broad-
+ * cast the current row
+ */
+                    int k, kmax = -1;
+                    for (k = 0; k < nt; k++)
+                    {
+                        if ((tidx[k] >= 0) &&
+                            ((kmax < 0) || (fabs(tmax[k]) > fabs(tmax[kmax]))))
+                            kmax = k;
+                    }
+                    if (kmax >= 0)
+                    {
+                        HPLAI_alocmax(PANEL, 1, tidx[kmax], jj, WORK);
+                        HPLAI_mxswp_seti(WORK, HPLAI_MXSWP_LINDX, tidx[kmax] - ii);
+                    }
+                    else
+                        HPLAI_alocmax(PANEL, 0, ii, jj, WORK);
+
+                    HPLAI_pamxswp(PANEL, m, ii, jj, WORK);
+                    HPLAI_alocswpT(PANEL, ii, jj, WORK);
+                }
+#ifdef _OPENMP
+#pragma omp barrier
+#endif
+                /*
+ * Scale current column by its absolute value max entry  -  Update trai-
+ * ling sub-matrix and find local absolute value max in next column, in
+ * this block of rows.
+ */
+                r0 = Mmax(lo, iip1);
+                mt = hi - r0;
+                if (mt > 0)
+                {
+                    Acur = Mptr(A, r0, jj, lda);
+                    Anxt = Mptr(Acur, 0, 1, lda);
+
+                    if (WORK[0] != HPLAI_rzero)
+                        blas::scal<HPLAI_T_AFLOAT>(mt, HPLAI_rone / WORK[0], Acur, 1);
+                    if (Nm1 >= 1)
+                    {
+                        blas::axpy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(mt, -(*(Mptr(L1, jj + 1, jj, n0))), Acur, 1, Anxt, 1);
+                        tidx[me] = r0 + blas::iamax<HPLAI_T_AFLOAT>(mt, Anxt, 1);
+                        tmax[me] = *Mptr(A, tidx[me], jj + 1, lda);
+                    }
+                    if (Nm1 > 1)
+                        blas::ger<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, mt, Nm1 - 1, -HPLAI_rone, Acur, 1,
+                                                                                  Mptr(L1, jj + 2, jj, n0), 1, Mptr(Anxt, 0, 1, lda), lda);
+                }
+                else
+                    tidx[me] = -1;
+
+                if (curr != 0)
+                {
+                    ii = iip1;
+                    iip1++;
+                    m = Mm1;
+                    Mm1--;
+                }
+
+                Nm1--;
+                jj++;
+            }
+        }
+
+        free(tidx);
+        free(tmax);
+#ifdef HPL_DETAILED_TIMING
+        HPL_ptimer(HPL_TIMING_PFACT);
+#endif
+        /*
+ * End of HPLAI_papanthT
+ */
+    }
+
+HPLAI_INSTANTIATE(HPLAI_papanthT);
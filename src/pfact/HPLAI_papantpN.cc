@@ -0,0 +1,127 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    void HPLAI_papantpN(
+        HPLAI_T_panel *PANEL,
+        const int M,
+        const int N,
+        const int ICOFF,
+        HPLAI_T_AFLOAT *WORK)
+#else
+void HPLAI_papantpN(PANEL, M, N, ICOFF, WORK)
+    HPLAI_T_panel *PANEL;
+const int M;
+const int N;
+const int ICOFF;
+HPLAI_T_AFLOAT *WORK;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_papantpN factorizes a panel of columns  with tournament pivoting
+ * (communication-avoiding LU).  The pivot rows are selected and swapped
+ * by HPLAI_patourn with one reduction and one broadcast in the process
+ * column, instead of one pivot search per column,  and  the rows of L
+ * are then obtained with a single triangular solve.  The lower triangu-
+ * lar N0-by-N0 upper block of the panel is stored in no-transpose form
+ * (i.e. just like the input matrix itself).
+ *
+ * The selection works on the whole panel at once:  this function is set
+ * as both the panel and the recursive factorization,  and  RFACT, NBMIN
+ * and NDIV do not apply.
+ *
+ * Arguments
+ * =========
+ *
+ * PANEL   (local input/output)          HPLAI_T_panel *
+ *         On entry,  PANEL  points to the data structure containing the
+ *         panel information.
+ *
+ * M       (local input)                 const int
+ *         On entry,  M specifies the local number of rows of the panel.
+ *
+ * N       (local input)                 const int
+ *         On entry,  N  specifies the number of columns  of the panel,
+ *         that is PANEL->jb.
+ *
+ * ICOFF   (global input)                const int
+ *         On entry, ICOFF specifies the row and column offset of sub(A)
+ *         in A. It must be 0.
+ *
+ * WORK    (local workspace)             HPLAI_T_AFLOAT *
+ *         Unused: HPLAI_patourn allocates its own workspace.
+ *
+ * ---------------------------------------------------------------------
+ */
+        /*
+ * .. Local Variables ..
+ */
+        HPLAI_T_AFLOAT *A, *L1;
+        int curr, lda, m;
+/* ..
+ * .. Executable Statements ..
+ */
+        (void)ICOFF;
+        (void)WORK;
+#ifdef HPL_DETAILED_TIMING
+        HPL_ptimer(HPL_TIMING_PFACT);
+#endif
+        A = PANEL->A;
+        L1 = PANEL->L1;
+        lda = PANEL->lda;
+        curr = (int)(PANEL->grid->myrow == PANEL->prow);
+        m = M - (curr != 0 ? N : 0);
+        /*
+ * Select and swap the pivot rows, L1 := LU factors of those rows
+ */
+        HPLAI_patourn(PANEL);
+        /*
+ * L := A * inv( U ) in the rows below the diagonal block, and copy the
+ * factored diagonal block back into A in the current process row
+ */
+        if (m > 0)
+        {
+            blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Side::Right, blas::Uplo::Upper, blas::Op::NoTrans,
+                                                       blas::Diag::NonUnit, m, N, HPLAI_rone, L1, N,
+                                                       (curr != 0 ? Mptr(A, N, 0, lda) : A), lda);
+        }
+        if (curr != 0)
+            HPLAI_alacpy(N, N, L1, N, A, lda);
+#ifdef HPL_DETAILED_TIMING
+        HPL_ptimer(HPL_TIMING_PFACT);
+#endif
+        /*
+ * End of HPLAI_papantpN
+ */
+    }
+
+HPLAI_INSTANTIATE(HPLAI_papantpN);
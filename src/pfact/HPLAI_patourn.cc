@@ -0,0 +1,319 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    static int HPLAI_patourn_lu(
+        const int M,
+        const int N,
+        HPLAI_T_AFLOAT *S,
+        const int LDS,
+        int *IDX)
+#else
+static int HPLAI_patourn_lu(M, N, S, LDS, IDX)
+    const int M;
+const int N;
+HPLAI_T_AFLOAT *S;
+const int LDS;
+int *IDX;
+#endif
+    {
+        /*
+ * Partial pivoting LU of the M-by-N array S, the row interchanges being
+ * applied to IDX as well. On exit, the first min(M,N) entries of IDX are
+ * the pivot rows in pivot order, and the number of those is returned.
+ */
+        HPLAI_T_AFLOAT piv, tmp;
+        int i, j, k, l;
+
+        k = Mmin(M, N);
+        for (j = 0; j < k; j++)
+        {
+            i = j + (int)(blas::iamax<HPLAI_T_AFLOAT>(M - j, Mptr(S, j, j, LDS), 1));
+            if (i != j)
+            {
+                for (l = 0; l < N; l++)
+                {
+                    tmp = *Mptr(S, i, l, LDS);
+                    *Mptr(S, i, l, LDS) = *Mptr(S, j, l, LDS);
+                    *Mptr(S, j, l, LDS) = tmp;
+                }
+                l = IDX[i];
+                IDX[i] = IDX[j];
+                IDX[j] = l;
+            }
+            if ((piv = *Mptr(S, j, j, LDS)) != HPLAI_rzero)
+                blas::scal<HPLAI_T_AFLOAT>(M - j - 1, HPLAI_rone / piv, Mptr(S, j + 1, j, LDS), 1);
+            if ((M - j > 1) && (N - j > 1))
+                blas::ger<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(
+                    blas::Layout::ColMajor, M - j - 1, N - j - 1, -HPLAI_rone,
+                    Mptr(S, j + 1, j, LDS), 1, Mptr(S, j, j + 1, LDS), LDS,
+                    Mptr(S, j + 1, j + 1, LDS), LDS);
+        }
+        return (k);
+    }
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    void HPLAI_patourn(
+        HPLAI_T_panel *PANEL)
+#else
+void HPLAI_patourn(PANEL)
+    HPLAI_T_panel *PANEL;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_patourn selects the  JB  pivot rows of a panel by tournament
+ * pivoting and applies them to the panel. Every process row picks JB
+ * candidate rows among its local rows with a partial pivoting LU  of a
+ * copy of them.  The candidates are then combined pairwise  along a
+ * binomial tree rooted at the current process row, each merge keeping
+ * the  JB  pivot rows  of the  partial pivoting LU of the two stacked
+ * sets of original rows. The current process row finally broadcasts
+ * the winners together with their factored JB-by-JB block and its own
+ * JB first rows, so that the panel is swapped without further commu-
+ * nication.
+ *
+ * This replaces the JB pivot searches and row exchanges of HPLAI_pamxswp
+ * by one reduction and one broadcast per panel:  on P process rows the
+ * running time of the selection can be approximated by
+ *
+ *    2 * log_2( P ) * ( lat + ( JB * JB + JB ) / bdwth ) +
+ *    JB^2 * ( M + JB * log_2( P ) ) * gam2
+ *
+ * where M is the local number of rows of the panel.
+ *
+ * On exit,  IPIV  holds the  row interchanges  in the same form as the
+ * partial pivoting factorization,  the rows of the panel are swapped
+ * accordingly,  and  L1 holds the  LU factors  of the JB pivot rows in
+ * no-transpose form. The rows of L below L1 are left to the caller.
+ *
+ * Arguments
+ * =========
+ *
+ * PANEL   (local input/output)          HPLAI_T_panel *
+ *         On entry,  PANEL  points to the data structure containing the
+ *         panel information.
+ *
+ * ---------------------------------------------------------------------
+ */
+        /*
+ * .. Local Variables ..
+ */
+        HPLAI_T_AFLOAT *A, *B, *C, *F, *O, *R, *S, *T, *work;
+        HPL_T_grid *grid;
+        MPI_Comm comm;
+        double tt;
+        int *hb, *hc, *hr, *idx, *pos, *row, *iwork;
+        int c, c1, c2, hdr, i, ia, icurrow, jb, k, lda, ldf, lmsg, ls,
+            m, mask, mydist, myrow, n, nb, nprow, p, t;
+/* ..
+ * .. Executable Statements ..
+ */
+        tt = HPLAI_trace_time();
+#ifdef HPL_DETAILED_TIMING
+        HPL_ptimer(HPL_TIMING_MXSWP);
+#endif
+        grid = PANEL->grid;
+        comm = grid->col_comm;
+        myrow = grid->myrow;
+        nprow = grid->nprow;
+        icurrow = PANEL->prow;
+        mydist = MModSub(myrow, icurrow, nprow);
+        A = PANEL->A;
+        lda = PANEL->lda;
+        ia = PANEL->ia;
+        nb = PANEL->nb;
+        jb = PANEL->jb;
+        m = PANEL->mp;
+        /*
+ * A candidate set is made of a header of  HPLAI_IPIV_LEN(JB) entries,
+ * holding  the  count  and  the  global row indexes  as integers,  and
+ * of the original rows in a JB-by-JB array.  The  broadcast buffer  B
+ * adds the factored block of the winners and the first JB rows of the
+ * current process row.
+ */
+        hdr = HPLAI_IPIV_LEN(jb);
+        lmsg = ((hdr + jb * jb + 1) >> 1) << 1; /* keeps the headers aligned */
+        ls = Mmax(m, jb << 1);
+
+        work = (HPLAI_T_AFLOAT *)malloc(((size_t)(ls) * (size_t)(jb) +
+                                         (size_t)(2 * jb * jb) + (size_t)(2 * lmsg) +
+                                         (size_t)(hdr + 2 * jb * jb)) *
+                                        sizeof(HPLAI_T_AFLOAT));
+        iwork = (int *)malloc((size_t)(ls + (jb << 2)) * sizeof(int));
+        if ((work == NULL) || (iwork == NULL))
+            HPLAI_pabort(__LINE__, "HPLAI_patourn", "Memory allocation failed");
+
+        C = work;
+        R = C + lmsg;
+        B = R + lmsg;
+        O = B + hdr + 2 * jb * jb;
+        S = O + 2 * jb * jb;
+        hc = (int *)(C);
+        hr = (int *)(R);
+        hb = (int *)(B);
+        C += hdr;
+        R += hdr;
+        idx = iwork;
+        pos = idx + ls;
+        row = pos + (jb << 1);
+        /*
+ * Local candidates: the pivot rows of the LU of a copy of my rows
+ */
+        for (i = 0; i < m; i++)
+            idx[i] = i;
+        if (m > 0)
+            HPLAI_alacpy(m, jb, A, lda, S, m);
+        c = HPLAI_patourn_lu(m, jb, S, Mmax(1, m), idx);
+        hc[0] = c;
+        for (i = 0; i < c; i++)
+        {
+            Mindxl2g(hc[1 + i], PANEL->ii + idx[i], nb, nb, myrow, 0, nprow);
+            blas::copy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(jb, Mptr(A, idx[i], 0, lda), lda,
+                                                       Mptr(C, i, 0, jb), jb);
+        }
+        F = S;
+        ldf = Mmax(1, m);
+        /*
+ * Tournament along a binomial tree rooted at the current process row
+ */
+        for (mask = 1; mask < nprow; mask <<= 1)
+        {
+            if ((mydist & mask) != 0)
+            {
+                (void)HPLAI_send(C - hdr, lmsg, MModAdd(mydist - mask, icurrow, nprow),
+                                 MSGID_BEGIN_PFACT, comm);
+                break;
+            }
+            if (mydist + mask >= nprow)
+                continue;
+
+            (void)HPLAI_recv(R - hdr, lmsg, MModAdd(mydist + mask, icurrow, nprow),
+                             MSGID_BEGIN_PFACT, comm);
+            c1 = hc[0];
+            c2 = hr[0];
+            if ((c = c1 + c2) == 0)
+                continue;
+            /*
+ * Stack both sets of original rows in O, and keep the pivot rows of the
+ * LU of a copy of them
+ */
+            if (c1 > 0)
+                HPLAI_alacpy(c1, jb, C, jb, O, c);
+            if (c2 > 0)
+                HPLAI_alacpy(c2, jb, R, jb, O + c1, c);
+            HPLAI_alacpy(c, jb, O, c, S, c);
+            for (i = 0; i < c; i++)
+                idx[i] = i;
+            k = HPLAI_patourn_lu(c, jb, S, c, idx);
+
+            for (i = 0; i < k; i++)
+                pos[i] = (idx[i] < c1 ? hc[1 + idx[i]] : hr[1 + idx[i] - c1]);
+            hc[0] = k;
+            for (i = 0; i < k; i++)
+            {
+                hc[1 + i] = pos[i];
+                blas::copy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(jb, Mptr(O, idx[i], 0, c), c,
+                                                           Mptr(C, i, 0, jb), jb);
+            }
+            F = S;
+            ldf = c;
+        }
+        /*
+ * The current process row broadcasts the winners,  their LU factors and
+ * its first JB rows
+ */
+        T = B + hdr + jb * jb;
+        if (mydist == 0)
+        {
+            for (i = 0; i <= jb; i++)
+                hb[i] = hc[i];
+            HPLAI_alacpy(jb, jb, F, ldf, B + hdr, jb);
+            HPLAI_alacpy(jb, jb, A, lda, T, jb);
+        }
+        if (MPI_Bcast((void *)(B), hdr + 2 * jb * jb, HPLAI_MPI_AFLOAT, icurrow,
+                      comm) != MPI_SUCCESS)
+            HPLAI_pabort(__LINE__, "HPLAI_patourn", "MPI call failed");
+        /*
+ * Turn the winners into row interchanges:  position pos[t] holds the
+ * original row row[t],  the JB first entries being the rows ia..ia+JB-1
+ * of the panel. Only rows of that block can leave it.
+ */
+        for (n = jb, i = 0; i < jb; i++)
+            pos[i] = row[i] = ia + i;
+        for (i = 0; i < jb; i++)
+        {
+            for (t = 0; (t < n) && (row[t] != hb[1 + i]); t++)
+                ;
+            if (t == n)
+            {
+                pos[n] = row[n] = hb[1 + i];
+                n++;
+            }
+            PANEL->IPIV[i] = pos[t];
+            k = row[t];
+            row[t] = row[i];
+            row[i] = k;
+        }
+        /*
+ * Swap the panel:  the rows leaving the first block are taken from the
+ * broadcast copy, the first block itself being overwritten by the caller
+ */
+        for (t = jb; t < n; t++)
+        {
+            Mindxg2p(pos[t], nb, nb, p, 0, nprow);
+            if (p != myrow)
+                continue;
+            Mindxg2l(i, pos[t], nb, nb, myrow, 0, nprow);
+            blas::copy<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(jb, Mptr(T, row[t] - ia, 0, jb), jb,
+                                                       Mptr(A, i - PANEL->ii, 0, lda), lda);
+        }
+
+        HPLAI_alacpy(jb, jb, B + hdr, jb, PANEL->L1, jb);
+        for (i = 0; i < jb; i++)
+        {
+            if ((*Mptr(PANEL->L1, i, i, jb) == HPLAI_rzero) && (*(PANEL->IINFO) == 0))
+                *(PANEL->IINFO) = ia + i + 1;
+        }
+
+        free(iwork);
+        free(work);
+#ifdef HPL_DETAILED_TIMING
+        HPL_ptimer(HPL_TIMING_MXSWP);
+#endif
+        (void)HPLAI_trace_event(HPLAI_TRACE_MXSWP, tt, PANEL->ja - jb);
+        /*
+ * End of HPLAI_patourn
+ */
+    }
+
+HPLAI_INSTANTIATE(HPLAI_patourn);
@@ -26,6 +26,7 @@
  */
 #include "hplai.hh"
 
+template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
 void HPLAI_equil(
     HPLAI_T_panel *PBCST,
@@ -256,3 +257,5 @@ int *IWORK;
  * End of HPLAI_equil
  */
 }
+
+HPLAI_INSTANTIATE(HPLAI_equil);
@@ -26,11 +26,7 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_pagesv(
         HPL_T_grid *GRID,
@@ -50,8 +46,13 @@ HPLAI_T_pmat *A;
             return;
 
         A->info = 0;
+        HPLAI_progress_start();
 
-        if ((ALGO->depth == 0) || (GRID->npcol == 1))
+        if (ALGO->depth < 0)
+        {
+            HPLAI_pagesvT(GRID, ALGO, A);
+        }
+        else if ((ALGO->depth == 0) || (GRID->npcol == 1))
         {
             HPLAI_pagesv0(GRID, ALGO, A);
         }
@@ -59,6 +60,7 @@ HPLAI_T_pmat *A;
         {
             HPLAI_pagesvK2(GRID, ALGO, A);
         }
+        HPLAI_progress_report(GRID, A->n, A->n);
         /*
  * Solve upper triangular system
  */
@@ -69,6 +71,4 @@ HPLAI_T_pmat *A;
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_pagesv);
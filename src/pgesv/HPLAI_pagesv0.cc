@@ -26,11 +26,7 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_pagesv0(
         HPL_T_grid *GRID,
@@ -75,6 +71,7 @@ HPLAI_T_pmat *A;
  */
         HPLAI_T_panel **panel = NULL;
         HPLAI_T_UPD_FUN HPLAI_paupdate;
+        double tt;
         int N, j, jb, n, nb, tag = MSGID_BEGIN_FACT,
                              test = HPL_KEEP_TESTING;
 #ifdef HPL_PROGRESS_REPORT
@@ -119,6 +116,7 @@ HPLAI_T_pmat *A;
                 HPL_fprintf(stdout, "Column=%09d Fraction=%4.1f%% Gflops=%9.3e\n", j, j * 100.0 / N, gflops);
             }
 #endif
+            HPLAI_progress_report(GRID, N, j);
             /*
  * Release panel resources - re-initialize panel data structure
  */
@@ -129,10 +127,12 @@ HPLAI_T_pmat *A;
  */
             HPLAI_pafact(panel[0]);
             (void)HPLAI_binit(panel[0]);
+            tt = HPLAI_trace_time();
             do
             {
                 (void)HPLAI_bcast(panel[0], &test);
             } while (test != HPL_SUCCESS);
+            (void)HPLAI_trace_event(HPLAI_TRACE_BCAST, tt, j);
             (void)HPLAI_bwait(panel[0]);
             HPLAI_paupdate(NULL, NULL, panel[0], -1);
             /*
@@ -152,6 +152,4 @@ HPLAI_T_pmat *A;
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_pagesv0);
@@ -26,11 +26,7 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_pagesvK2(
         HPL_T_grid *GRID,
@@ -75,6 +71,7 @@ HPLAI_T_pmat *A;
  */
         HPLAI_T_panel *p, **panel = NULL;
         HPLAI_T_UPD_FUN HPLAI_paupdate;
+        double tt;
         int N, depth, icurcol = 0, j, jb, jj = 0, jstart,
                       k, mycol, n, nb, nn, npcol, nq,
                       tag = MSGID_BEGIN_FACT, test = HPL_KEEP_TESTING;
@@ -147,10 +144,12 @@ HPLAI_T_pmat *A;
  */
             HPLAI_pafact(panel[k]);
             (void)HPLAI_binit(panel[k]);
+            tt = HPLAI_trace_time();
             do
             {
                 (void)HPLAI_bcast(panel[k], &test);
             } while (test != HPL_SUCCESS);
+            (void)HPLAI_trace_event(HPLAI_TRACE_BCAST, tt, j - jb);
             (void)HPLAI_bwait(panel[k]);
             /*
  * Partial update of the depth-k-1 panels in front of me
@@ -177,6 +176,7 @@ HPLAI_T_pmat *A;
                 HPL_fprintf(stdout, "Column=%09d Fraction=%4.1f%% Gflops=%9.3e\n", j, j * 100.0 / N, gflops);
             }
 #endif
+            HPLAI_progress_report(GRID, N, j);
             /*
  * Initialize current panel - Finish latest update, Factor and broadcast
  * current panel
@@ -236,6 +236,4 @@ HPLAI_T_pmat *A;
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_pagesvK2);
@@ -0,0 +1,436 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    static void HPLAI_pagesvT_chunk(
+        HPLAI_T_panel *PANEL,
+        const int LTRAN,
+        const int UTRAN,
+        const int Q0,
+        const int NN)
+#else
+static void HPLAI_pagesvT_chunk(PANEL, LTRAN, UTRAN, Q0, NN)
+    HPLAI_T_panel *PANEL;
+const int LTRAN;
+const int UTRAN;
+const int Q0;
+const int NN;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_pagesvT_chunk updates the NN local columns Q0:Q0+NN-1 of the
+ * trailing submatrix of PANEL.  When nprow is one,  the row interchanges
+ * of  the chunk  are applied here,  otherwise they must have been done
+ * by HPLAI_palaswp0{0,1,2}{N,T} for all the trailing
+ * columns beforehand. This is the body of the HPLAI_paupdate{NN,NT,TN,
+ * TT} chunk loops, and distinct chunks can be updated concurrently.
+ *
+ * Arguments
+ * =========
+ *
+ * PANEL   (local input/output)          HPLAI_T_panel *
+ *         On entry,  PANEL  points to the data structure containing the
+ *         panel (to be updated) information.
+ *
+ * LTRAN   (global input)                const int
+ *         On entry, LTRAN is non-zero when L1 is stored transposed.
+ *
+ * UTRAN   (global input)                const int
+ *         On entry, UTRAN is non-zero when U is stored transposed.
+ *
+ * Q0      (local input)                 const int
+ *         On entry, Q0 is the local offset of the chunk in the trailing
+ *         submatrix.
+ *
+ * NN      (local input)                 const int
+ *         On entry, NN is the number of columns of the chunk.
+ *
+ * ---------------------------------------------------------------------
+ */
+        /*
+ * .. Local Variables ..
+ */
+        HPLAI_T_AFLOAT *Aptr, *L1ptr, *L2ptr, *Uptr;
+        double tt;
+        int curr, jb, lda, ldl2, ldu, mp;
+        /* ..
+ * .. Executable Statements ..
+ */
+        jb = PANEL->jb;
+        lda = PANEL->lda;
+        ldl2 = PANEL->ldl2;
+        L1ptr = PANEL->L1;
+        L2ptr = PANEL->L2;
+        Aptr = Mptr(PANEL->A, 0, Q0, lda);
+        tt = HPLAI_trace_time();
+
+        if (PANEL->grid->nprow == 1)
+        {
+            mp = PANEL->mp - jb;
+            HPLAI_alaswp00N(jb, NN, Aptr, lda, PANEL->IWORK);
+            tt = HPLAI_trace_event(HPLAI_TRACE_LASWP, tt, PANEL->ja - jb);
+            if (LTRAN)
+                blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Side::Left, blas::Uplo::Upper, blas::Op::Trans,
+                                                           blas::Diag::Unit, jb, NN, HPLAI_rone, L1ptr, jb, Aptr, lda);
+            else
+                blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Side::Left, blas::Uplo::Lower, blas::Op::NoTrans,
+                                                           blas::Diag::Unit, jb, NN, HPLAI_rone, L1ptr, jb, Aptr, lda);
+            tt = HPLAI_trace_event(HPLAI_TRACE_TRSM, tt, PANEL->ja - jb);
+            blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Op::NoTrans, blas::Op::NoTrans, mp, NN,
+                                                                       jb, -HPLAI_rone, L2ptr, ldl2, Aptr, lda, HPLAI_rone,
+                                                                       Mptr(Aptr, jb, 0, lda), lda);
+            (void)HPLAI_trace_event(HPLAI_TRACE_GEMM, tt, PANEL->ja - jb);
+            return;
+        }
+
+        curr = (PANEL->grid->myrow == PANEL->prow ? 1 : 0);
+        mp = PANEL->mp - (curr != 0 ? jb : 0);
+
+        if (UTRAN)
+        {
+            ldu = PANEL->nq;
+            Uptr = Mptr(PANEL->U, Q0, 0, ldu);
+            if (LTRAN)
+                blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Side::Right, blas::Uplo::Upper, blas::Op::NoTrans,
+                                                           blas::Diag::Unit, NN, jb, HPLAI_rone, L1ptr, jb, Uptr, ldu);
+            else
+                blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Side::Right, blas::Uplo::Lower, blas::Op::Trans,
+                                                           blas::Diag::Unit, NN, jb, HPLAI_rone, L1ptr, jb, Uptr, ldu);
+            tt = HPLAI_trace_event(HPLAI_TRACE_TRSM, tt, PANEL->ja - jb);
+            blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Op::NoTrans, blas::Op::Trans, mp, NN,
+                                                                       jb, -HPLAI_rone, L2ptr, ldl2, Uptr, ldu, HPLAI_rone,
+                                                                       (curr != 0 ? Mptr(Aptr, jb, 0, lda) : Aptr), lda);
+            if (curr != 0)
+                HPLAI_alatcpy(jb, NN, Uptr, ldu, Aptr, lda);
+            (void)HPLAI_trace_event(HPLAI_TRACE_GEMM, tt, PANEL->ja - jb);
+        }
+        else
+        {
+            ldu = jb;
+            Uptr = Mptr(PANEL->U, 0, Q0, ldu);
+            if (LTRAN)
+                blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Side::Left, blas::Uplo::Upper, blas::Op::Trans,
+                                                           blas::Diag::Unit, jb, NN, HPLAI_rone, L1ptr, jb, Uptr, ldu);
+            else
+                blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Side::Left, blas::Uplo::Lower, blas::Op::NoTrans,
+                                                           blas::Diag::Unit, jb, NN, HPLAI_rone, L1ptr, jb, Uptr, ldu);
+            tt = HPLAI_trace_event(HPLAI_TRACE_TRSM, tt, PANEL->ja - jb);
+            blas::gemm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Op::NoTrans, blas::Op::NoTrans, mp, NN,
+                                                                       jb, -HPLAI_rone, L2ptr, ldl2, Uptr, ldu, HPLAI_rone,
+                                                                       (curr != 0 ? Mptr(Aptr, jb, 0, lda) : Aptr), lda);
+            if (curr != 0)
+                HPLAI_alacpy(jb, NN, Uptr, ldu, Aptr, lda);
+            (void)HPLAI_trace_event(HPLAI_TRACE_GEMM, tt, PANEL->ja - jb);
+        }
+        /*
+ * End of HPLAI_pagesvT_chunk
+ */
+    }
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    static void HPLAI_pagesvT_next(
+        HPLAI_T_panel *PANEL)
+#else
+static void HPLAI_pagesvT_next(PANEL)
+    HPLAI_T_panel *PANEL;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_pagesvT_next factors and broadcasts PANEL. While the broadcast
+ * is in flight,  the executing thread yields to the pending column-chunk
+ * updates.
+ *
+ * ---------------------------------------------------------------------
+ */
+        /*
+ * .. Local Variables ..
+ */
+        double tt;
+        int test = HPL_KEEP_TESTING;
+        /* ..
+ * .. Executable Statements ..
+ */
+        HPLAI_pafact(PANEL);
+        (void)HPLAI_binit(PANEL);
+        tt = HPLAI_trace_time();
+        do
+        {
+            (void)HPLAI_bcast(PANEL, &test);
+#ifdef _OPENMP
+            if (test != HPL_SUCCESS)
+            {
+#pragma omp taskyield
+            }
+#endif
+        } while (test != HPL_SUCCESS);
+        (void)HPLAI_trace_event(HPLAI_TRACE_BCAST, tt, PANEL->ja - PANEL->jb);
+        (void)HPLAI_bwait(PANEL);
+        /*
+ * End of HPLAI_pagesvT_next
+ */
+    }
+
+    template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+    void HPLAI_pagesvT(
+        HPL_T_grid *GRID,
+        HPLAI_T_palg *ALGO,
+        HPLAI_T_pmat *A)
+#else
+void HPLAI_pagesvT(GRID, ALGO, A)
+    HPL_T_grid *GRID;
+HPLAI_T_palg *ALGO;
+HPLAI_T_pmat *A;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_pagesvT factors a N+1-by-N matrix using LU factorization with row
+ * partial pivoting.  The main algorithm  is the "right looking" variant
+ * with a dynamic look-ahead:  every iteration is a small task graph run
+ * by the OpenMP thread pool.  The trailing update of the current panel
+ * is split into one task per nb-wide local column chunk, and the next
+ * panel is factored and broadcast by a task that only depends  on the
+ * chunk holding its columns,  so that it overlaps with the rest of the
+ * update as soon as these columns are ready.  The lower triangular factor
+ * is left unpivoted and the pivots are not returned. The right hand side
+ * is the N+1 column of the coefficient matrix.
+ *
+ * The row interchanges of the current panel (nprow > 1) are applied by
+ * the calling thread before the graph is run,  so that at most one task
+ * communicates at a time:  MPI_THREAD_SERIALIZED is enough.  With a lower
+ * thread support level, or without OpenMP, the graph is run by a single
+ * thread.
+ *
+ * Arguments
+ * =========
+ *
+ * GRID    (local input)                 HPL_T_grid *
+ *         On entry,  GRID  points  to the data structure containing the
+ *         process grid information.
+ *
+ * ALGO    (global input)                HPLAI_T_palg *
+ *         On entry,  ALGO  points to  the data structure containing the
+ *         algorithmic parameters.
+ *
+ * A       (local input/output)          HPLAI_T_pmat *
+ *         On entry, A points to the data structure containing the local
+ *         array information.
+ *
+ * ---------------------------------------------------------------------
+ */
+        /*
+ * .. Local Variables ..
+ */
+        HPLAI_T_panel *curr, *next, *p;
+        char *deps = NULL;
+        double tt;
+        int N, i, j, jb, ltran, mycol, n, nb, nchunk, ndep, npcol,
+            nthreads = 1, tag = MSGID_BEGIN_FACT, test = HPL_KEEP_TESTING,
+            utran;
+#ifdef _OPENMP
+        int thread;
+#endif
+#ifdef HPL_PROGRESS_REPORT
+        double start_time, time, gflops;
+#endif
+        /* ..
+ * .. Executable Statements ..
+ */
+        if ((N = A->n) <= 0)
+            return;
+
+#ifdef HPL_PROGRESS_REPORT
+        start_time = HPL_ptimer_walltime();
+#endif
+
+        mycol = GRID->mycol;
+        npcol = GRID->npcol;
+        nb = A->nb;
+        ltran = ((ALGO->upfun == HPLAI_paupdateTN<HPLAI_T_AFLOAT>) ||
+                 (ALGO->upfun == HPLAI_paupdateTT<HPLAI_T_AFLOAT>));
+        utran = ((ALGO->upfun == HPLAI_paupdateNT<HPLAI_T_AFLOAT>) ||
+                 (ALGO->upfun == HPLAI_paupdateTT<HPLAI_T_AFLOAT>));
+#ifdef _OPENMP
+        MPI_Query_thread(&thread);
+        if (thread >= MPI_THREAD_SERIALIZED)
+            nthreads = omp_get_max_threads();
+#endif
+        /*
+ * One dependency slot per local column chunk of the trailing submatrix,
+ * plus a spare one that no chunk ever writes
+ */
+        ndep = (HPL_numroc(N + 1, nb, nb, mycol, 0, npcol) + nb - 1) / nb;
+        deps = (char *)malloc((size_t)(ndep + 1) * sizeof(char));
+        if (deps == NULL)
+        {
+            HPLAI_pabort(__LINE__, "HPLAI_pagesvT", "Memory allocation failed");
+        }
+        /*
+ * Create the two panels - factor and broadcast the first one
+ */
+        jb = Mmin(N, nb);
+        HPLAI_papanel_new(GRID, ALGO, N, N + 1, jb, A, 0, 0, tag, &curr);
+        tag = MNxtMgid(tag, MSGID_BEGIN_FACT, MSGID_END_FACT);
+        HPLAI_papanel_new(GRID, ALGO, N - jb, N - jb + 1, Mmin(N - jb, nb), A,
+                          jb, jb, tag, &next);
+
+        HPLAI_pafact(curr);
+        (void)HPLAI_binit(curr);
+        tt = HPLAI_trace_time();
+        do
+        {
+            (void)HPLAI_bcast(curr, &test);
+        } while (test != HPL_SUCCESS);
+        (void)HPLAI_trace_event(HPLAI_TRACE_BCAST, tt, 0);
+        (void)HPLAI_bwait(curr);
+        /*
+ * Main loop over the columns of A: curr has been factored and broadcast
+ */
+        for (j = 0; j < N; j += nb)
+        {
+            n = N - j;
+            jb = Mmin(n, nb);
+#ifdef HPL_PROGRESS_REPORT
+            /* if this is process 0,0 and not the first panel */
+            if (GRID->myrow == 0 && mycol == 0 && j > 0)
+            {
+                time = HPL_ptimer_walltime() - start_time;
+                gflops = 2.0 * (N * (double)N * N - n * (double)n * n) / 3.0 / (time > 0.0 ? time : 1e-6) / 1e9;
+                HPL_fprintf(stdout, "Column=%09d Fraction=%4.1f%% Gflops=%9.3e\n", j, j * 100.0 / N, gflops);
+            }
+#endif
+            HPLAI_progress_report(GRID, N, j);
+            if (n > jb)
+            {
+                (void)HPLAI_papanel_free(next);
+                HPLAI_papanel_init(GRID, ALGO, n - jb, n - jb + 1, Mmin(n - jb, nb),
+                                   A, j + jb, j + jb, tag, next);
+            }
+            /*
+ * Apply the row interchanges of the current panel to all the trailing
+ * columns at once (nprow > 1), or prepare the local pivot vector
+ */
+            if ((curr->nq > 0) && (jb > 0))
+            {
+                if (GRID->nprow == 1)
+                {
+                    for (i = 0; i < jb; i++)
+                        curr->IWORK[i] = curr->IPIV[i] - curr->ii;
+                }
+                else if (HPLAI_pnoswp<HPLAI_T_AFLOAT>(curr))
+                {
+                    if (utran)
+                        HPLAI_palaswp02T<HPLAI_T_AFLOAT>(NULL, &test, curr, curr->nq);
+                    else
+                        HPLAI_palaswp02N<HPLAI_T_AFLOAT>(NULL, &test, curr, curr->nq);
+                }
+                else if ((ALGO->fswap == HPLAI_SWAP01) ||
+                         ((ALGO->fswap == HPLAI_SW_MIX) && (curr->nq > ALGO->fsthr)))
+                {
+                    if (utran)
+                        HPLAI_palaswp01T<HPLAI_T_AFLOAT>(NULL, &test, curr, curr->nq);
+                    else
+                        HPLAI_palaswp01N<HPLAI_T_AFLOAT>(NULL, &test, curr, curr->nq);
+                }
+                else
+                {
+                    if (utran)
+                        HPLAI_palaswp00T<HPLAI_T_AFLOAT>(NULL, &test, curr, curr->nq);
+                    else
+                        HPLAI_palaswp00N<HPLAI_T_AFLOAT>(NULL, &test, curr, curr->nq);
+                }
+            }
+            nchunk = (curr->nq + nb - 1) / nb;
+            /*
+ * Run the task graph: when mycol owns the next panel, its columns are in
+ * chunk 0 whose update gates the next panel task,  otherwise this task
+ * waits on the spare slot and starts right away.  All the other chunks
+ * are independent.
+ */
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads)
+#pragma omp single
+#endif
+            {
+                int c, q0;
+
+                for (c = 0; c < nchunk; c++)
+                {
+                    q0 = c * nb;
+#ifdef _OPENMP
+#pragma omp task firstprivate(c, q0) depend(out : deps[c])
+#endif
+                    HPLAI_pagesvT_chunk<HPLAI_T_AFLOAT>(curr, ltran, utran, q0,
+                                                        Mmin(nb, curr->nq - q0));
+                    if ((c == 0) && (n > jb))
+                    {
+#ifdef _OPENMP
+#pragma omp task depend(in : deps[next->pcol == mycol ? 0 : ndep])
+#endif
+                        HPLAI_pagesvT_next<HPLAI_T_AFLOAT>(next);
+                    }
+                }
+                if ((nchunk == 0) && (n > jb))
+                    HPLAI_pagesvT_next<HPLAI_T_AFLOAT>(next);
+            }
+            /*
+ * Swap the panel pointers - update the message id for the broadcast
+ */
+            p = curr;
+            curr = next;
+            next = p;
+            tag = MNxtMgid(tag, MSGID_BEGIN_FACT, MSGID_END_FACT);
+        }
+        /*
+ * Release panels and dependency slots
+ */
+        (void)HPLAI_papanel_disp(&curr);
+        (void)HPLAI_papanel_disp(&next);
+
+        if (deps)
+            free(deps);
+        /*
+ * End of HPLAI_pagesvT
+ */
+    }
+
+HPLAI_INSTANTIATE(HPLAI_pagesvT);
@@ -26,6 +26,7 @@
  */
 #include "hplai.hh"
 
+template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
 void HPLAI_palaswp00N(
     HPLAI_T_panel *PBCST,
@@ -86,6 +87,7 @@ const int NN;
     /*
  * .. Local Variables ..
  */
+    double tt;
     MPI_Comm comm;
     HPL_T_grid *grid;
     HPLAI_T_AFLOAT *A, *U, *W;
@@ -110,6 +112,7 @@ const int NN;
     if ((n <= 0) || (jb <= 0))
         return;
 
+    tt = HPLAI_trace_time();
 #ifdef HPL_DETAILED_TIMING
     HPL_ptimer(HPL_TIMING_LASWP);
 #endif
@@ -437,7 +440,10 @@ const int NN;
 #ifdef HPL_DETAILED_TIMING
     HPL_ptimer(HPL_TIMING_LASWP);
 #endif
+    (void)HPLAI_trace_event(HPLAI_TRACE_LASWP, tt, PANEL->ja - jb);
     /*
  * End of HPLAI_palaswp00N
  */
 }
+
+HPLAI_INSTANTIATE(HPLAI_palaswp00N);
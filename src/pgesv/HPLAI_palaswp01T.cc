@@ -26,6 +26,7 @@
  */
 #include "hplai.hh"
 
+template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
 void HPLAI_palaswp01T(
     HPLAI_T_panel *PBCST,
@@ -88,6 +89,7 @@ const int NN;
     /*
  * .. Local Variables ..
  */
+    double tt;
     HPLAI_T_AFLOAT *A, *U;
     int *ipID, *iplen, *ipmap, *ipmapm1,
         *iwork, *lindxA = NULL, *lindxAU,
@@ -107,6 +109,7 @@ const int NN;
  */
     if ((n <= 0) || (jb <= 0))
         return;
+    tt = HPLAI_trace_time();
 #ifdef HPL_DETAILED_TIMING
     HPL_ptimer(HPL_TIMING_LASWP);
 #endif
@@ -201,7 +204,10 @@ const int NN;
 #ifdef HPL_DETAILED_TIMING
     HPL_ptimer(HPL_TIMING_LASWP);
 #endif
+    (void)HPLAI_trace_event(HPLAI_TRACE_LASWP, tt, PANEL->ja - jb);
     /*
  * End of HPLAI_palaswp01T
  */
 }
+
+HPLAI_INSTANTIATE(HPLAI_palaswp01T);
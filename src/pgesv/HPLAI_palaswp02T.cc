@@ -0,0 +1,174 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+
+template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+void HPLAI_palaswp02T(
+    HPLAI_T_panel *PBCST,
+    int *IFLAG,
+    HPLAI_T_panel *PANEL,
+    const int NN)
+#else
+void HPLAI_palaswp02T(PBCST, IFLAG, PANEL, NN)
+    HPLAI_T_panel *PBCST;
+int *IFLAG;
+HPLAI_T_panel *PANEL;
+const int NN;
+#endif
+{
+    /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_palaswp02T broadcasts the row panel U of a panel whose pivoting
+ * vector is the identity (see HPLAI_panopiv).  No row interchange has to
+ * be applied:  the NB rows of U already live in process row  icurrow and
+ * are simply transposed into U and broadcast  along the process column
+ * with a binomial tree, with no spread, roll nor local exchange phase.
+ * With  P  process rows,  the running time of this function can be
+ * approximated by:
+ *  
+ *    log_2(P) * ( lat + NB * LocQ(N) / bdwth )
+ *  
+ * where  NB  is the number of rows of the row panel U,  N is the global
+ * number of columns being updated,  lat and bdwth  are the latency  and
+ * bandwidth  of  the  network  for  HPLAI_T_AFLOAT  precision real words.
+ *
+ * Arguments
+ * =========
+ *
+ * PBCST   (local input/output)          HPLAI_T_panel *
+ *         On entry,  PBCST  points to the data structure containing the
+ *         panel (to be broadcast) information.
+ *
+ * IFLAG   (local input/output)          int *
+ *         On entry, IFLAG  indicates  whether or not  the broadcast has
+ *         already been completed.  If not,  probing will occur, and the
+ *         outcome will be contained in IFLAG on exit.
+ *
+ * PANEL   (local input/output)          HPLAI_T_panel *
+ *         On entry,  PANEL  points to the data structure containing the
+ *         panel information.
+ *
+ * NN      (local input)                 const int
+ *         On entry, NN specifies  the  local  number  of columns of the
+ *         trailing  submatrix  to  be broadcast  starting at the current
+ *         position. NN must be at least zero.
+ *
+ * ---------------------------------------------------------------------
+ */
+    /*
+ * .. Local Variables ..
+ */
+    MPI_Status status;
+    MPI_Comm comm;
+    double tt;
+    HPLAI_T_AFLOAT *A, *U;
+    unsigned int ip2 = 1, mydist;
+    int Cmsgid = MSGID_BEGIN_PFACT, icurrow, ierr = MPI_SUCCESS,
+        jb, lda, myrow, n, nprow, partner;
+#define LDU n
+    /* ..
+ * .. Executable Statements ..
+ */
+    n = PANEL->n;
+    n = Mmin(NN, n);
+    jb = PANEL->jb;
+    /*
+ * Quick return if there is nothing to do
+ */
+    if ((n <= 0) || (jb <= 0))
+        return;
+    tt = HPLAI_trace_time();
+#ifdef HPL_DETAILED_TIMING
+    HPL_ptimer(HPL_TIMING_LASWP);
+#endif
+    /*
+ * Retrieve parameters from the PANEL data structure
+ */
+    nprow = PANEL->grid->nprow;
+    myrow = PANEL->grid->myrow;
+    comm = PANEL->grid->col_comm;
+    A = PANEL->A;
+    U = PANEL->U;
+    lda = PANEL->lda;
+    icurrow = PANEL->prow;
+    /*
+ * Copy into U the rows to be broadcast (local to icurrow)
+ */
+    if (myrow == icurrow)
+        HPLAI_alatcpy(n, jb, A, lda, U, LDU);
+    /*
+ * Binomial tree rooted at icurrow - optionally probe for column panel
+ */
+    mydist = (unsigned int)MModSub(myrow, icurrow, nprow);
+    while (ip2 < (unsigned int)(nprow))
+        ip2 <<= 1;
+
+    while (ip2 > 1)
+    {
+        ip2 >>= 1;
+        if ((mydist & (ip2 - 1)) == 0)
+        {
+            partner = (int)(mydist ^ ip2);
+
+            if (mydist & ip2)
+            {
+                if (ierr == MPI_SUCCESS)
+                    ierr = MPI_Recv(U, jb * LDU, HPLAI_MPI_AFLOAT,
+                                    MModAdd(partner, icurrow, nprow), Cmsgid,
+                                    comm, &status);
+            }
+            else if (partner < nprow)
+            {
+                if (ierr == MPI_SUCCESS)
+                    ierr = MPI_Send(U, jb * LDU, HPLAI_MPI_AFLOAT,
+                                    MModAdd(partner, icurrow, nprow), Cmsgid,
+                                    comm);
+            }
+        }
+
+        if (*IFLAG == HPLAI_KEEP_TESTING)
+            (void)HPLAI_bcast(PBCST, IFLAG);
+    }
+
+    if (ierr != MPI_SUCCESS)
+    {
+        HPLAI_pabort(__LINE__, "HPLAI_palaswp02T", "MPI call failed");
+    }
+
+#ifdef HPL_DETAILED_TIMING
+    HPL_ptimer(HPL_TIMING_LASWP);
+#endif
+    (void)HPLAI_trace_event(HPLAI_TRACE_LASWP, tt, PANEL->ja - jb);
+    /*
+ * End of HPLAI_palaswp02T
+ */
+}
+
+HPLAI_INSTANTIATE(HPLAI_palaswp02T);
@@ -0,0 +1,330 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+
+/*
+ * Entry I of the random diagonal of level LEVEL of the butterfly SEED:
+ * exp(r/10) with r in [-1/2,1/2) a hash of (SEED, LEVEL, I),  so that
+ * every process computes the same value without communication.
+ */
+static double HPLAI_parbt_diag(
+    const int SEED,
+    const int LEVEL,
+    const int I)
+{
+    uint64_t z;
+
+    z = ((uint64_t)(SEED) << 40) ^ ((uint64_t)(LEVEL) << 32) ^
+        (uint64_t)((unsigned int)(I));
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= (z >> 31);
+
+    return (exp(((double)(z >> 11) / 9007199254740992.0 - 0.5) / 10.0));
+}
+
+template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+void HPLAI_parbt(
+    HPL_T_grid *GRID,
+    const blas::Side SIDE,
+    const blas::Op TRANS,
+    const int DEPTH,
+    const int SEED,
+    const int N,
+    const int NB,
+    const int K,
+    HPLAI_T_AFLOAT *A,
+    const int LDA)
+#else
+void HPLAI_parbt(GRID, SIDE, TRANS, DEPTH, SEED, N, NB, K, A, LDA)
+    HPL_T_grid *GRID;
+const blas::Side SIDE;
+const blas::Op TRANS;
+const int DEPTH;
+const int SEED;
+const int N;
+const int NB;
+const int K;
+HPLAI_T_AFLOAT *A;
+const int LDA;
+#endif
+{
+    /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_parbt applies  a  recursive  butterfly  transformation  W of
+ * depth DEPTH to a distributed array:
+ *  
+ *    A := op( W ) * A  (SIDE is Left),   or   A := A * op( W )  (SIDE is
+ *    Right),   where op( W ) is W or W^T.
+ *  
+ * A butterfly of order 2h  is  B = 1/sqrt(2) [ R0 R1 ; R0 -R1 ],  where
+ * R0 and R1 are random diagonal matrices of order h.  W is the product
+ * of DEPTH levels,  the level l being block diagonal with 2^(l-1) but-
+ * terflies.  W is applied to the leading  n0  rows (columns) of A only,
+ * where n0 is the largest multiple of  2^DEPTH * NB  not larger than N,
+ * so that row (column) i is mixed with the row (column)  i +/- h  that
+ * belongs to a block at  the same  offset  in another block.  The whole
+ * blocks are exchanged with the partner process row (column), in chunks
+ * of NB columns (rows) of A.
+ *
+ * Arguments
+ * =========
+ *
+ * GRID    (local input)                 HPL_T_grid *
+ *         On entry,  GRID  points  to the data structure containing the
+ *         process grid information.
+ *
+ * SIDE    (global input)                const blas::Side
+ *         On entry, SIDE specifies whether  op( W )  multiplies A  from
+ *         the left,  i.e., the N rows of A are distributed in  the pro-
+ *         cess columns,  or from the right,  i.e.,  the  N  columns are
+ *         distributed in the process rows.
+ *
+ * TRANS   (global input)                const blas::Op
+ *         On entry, TRANS specifies whether op( W ) is W or W^T.
+ *
+ * DEPTH   (global input)                const int
+ *         On entry,  DEPTH  specifies  the  number  of recursion levels.
+ *         Nothing is done when DEPTH is less than one.
+ *
+ * SEED    (global input)                const int
+ *         On entry,  SEED  selects the random diagonals,  so that W is
+ *         the same for the same SEED.
+ *
+ * N       (global input)                const int
+ *         On entry, N specifies the order of W.  N must be at least 0.
+ *
+ * NB      (global input)                const int
+ *         On entry,  NB  specifies  the blocking factor used to parti-
+ *         tion and distribute the N rows (columns) of A.
+ *
+ * K       (local input)                 const int
+ *         On entry, K specifies the local number of columns (rows) of A
+ *         the transformation is applied to.  K is the same in the whole
+ *         process column (row).
+ *
+ * A       (local input/output)          HPLAI_T_AFLOAT *
+ *         On entry,  A  points to the local array to be transformed.
+ *
+ * LDA     (local input)                 const int
+ *         On entry, LDA specifies the leading dimension of the array A.
+ *
+ * ---------------------------------------------------------------------
+ */
+    /*
+ * .. Local Variables ..
+ */
+    MPI_Comm comm;
+    MPI_Request req[4];
+    MPI_Status sts[4];
+    HPLAI_T_AFLOAT *Aptr, *Wptr, *Pptr, *buf = NULL, *rbot, *rtop,
+        *sbot, *stop;
+    double *dmy, *dpa, *dwork = NULL, dm, dp, s, t, u;
+    size_t len, sj, sl;
+    int *iwork = NULL, fwd, gb, hb, hk, i, ib, ierr = MPI_SUCCESS, it,
+        j, j0, kb, kc, lev, myp, nblk, nbot, np, nreq, n0, ntop, qdn,
+        qup, tag = MSGID_BEGIN_PFACT;
+    /* ..
+ * .. Executable Statements ..
+ */
+    if ((DEPTH <= 0) || (K <= 0) || (NB <= 0))
+        return;
+    n0 = (N / (NB << DEPTH)) * (NB << DEPTH);
+    if (n0 <= 0)
+        return;
+
+    if (SIDE == blas::Side::Left)
+    {
+        comm = GRID->col_comm;
+        myp = GRID->myrow;
+        np = GRID->nprow;
+        sl = 1;
+        sj = (size_t)(LDA);
+    }
+    else
+    {
+        comm = GRID->row_comm;
+        myp = GRID->mycol;
+        np = GRID->npcol;
+        sl = (size_t)(LDA);
+        sj = 1;
+    }
+    /*
+ * W^T from the left and W from the right take the levels from the top:
+ * (t, b) := ( R0 (t + b), R1 (t - b) ) / sqrt(2).  Otherwise the levels
+ * are taken from the bottom: (t, b) := ( R0 t + R1 b, R0 t - R1 b ) /
+ * sqrt(2).
+ */
+    fwd = (((SIDE == blas::Side::Left) && (TRANS != blas::Op::NoTrans)) ||
+           ((SIDE == blas::Side::Right) && (TRANS == blas::Op::NoTrans)));
+    s = 1.0 / sqrt(2.0);
+    nblk = n0 / NB;
+    kc = Mmin(K, NB);
+    /*
+ * Workspace: the global indexes of my blocks, their diagonals and the
+ * diagonals of their partners, and the send and receive buffers
+ */
+    i = (nblk + np - 1) / np;
+    len = (size_t)(i) * (size_t)(NB) * (size_t)(kc);
+    iwork = (int *)malloc((size_t)(i) * sizeof(int));
+    dwork = (double *)malloc((size_t)(i) * (size_t)(NB) * 2 * sizeof(double));
+    buf = (HPLAI_T_AFLOAT *)malloc(2 * len * sizeof(HPLAI_T_AFLOAT));
+    if ((iwork == NULL) || (dwork == NULL) || (buf == NULL))
+        HPLAI_pabort(__LINE__, "HPLAI_parbt", "Memory allocation failed");
+
+    for (it = 0; it < DEPTH; it++)
+    {
+        lev = (fwd ? it + 1 : DEPTH - it);
+        hk = n0 >> lev;
+        hb = hk / NB;
+        qup = MModAdd(myp, hb % np, np);
+        qdn = MModSub(myp, hb % np, np);
+        /*
+ * Split my blocks into tops (partner below) and bottoms (partner above)
+ * - the tops are stored first in iwork, the bottoms last, both sorted
+ */
+        ntop = 0;
+        for (gb = myp; gb < nblk; gb += np)
+            if ((gb % (hb << 1)) < hb)
+                iwork[ntop++] = gb;
+        nbot = ntop;
+        for (gb = myp; gb < nblk; gb += np)
+            if ((gb % (hb << 1)) >= hb)
+                iwork[nbot++] = gb;
+        nbot -= ntop;
+        /*
+ * Diagonal entries of my rows and of their partner rows
+ */
+        dmy = dwork;
+        dpa = dwork + (size_t)(ntop + nbot) * NB;
+        for (ib = 0; ib < ntop + nbot; ib++)
+        {
+            for (i = 0; i < NB; i++)
+            {
+                j = iwork[ib] * NB + i;
+                dmy[(size_t)(ib)*NB + i] = HPLAI_parbt_diag(SEED, lev, j);
+                dpa[(size_t)(ib)*NB + i] =
+                    HPLAI_parbt_diag(SEED, lev, (ib < ntop ? j + hk : j - hk));
+            }
+        }
+
+        for (j0 = 0; j0 < K; j0 += kc)
+        {
+            kb = Mmin(kc, K - j0);
+            stop = buf;
+            sbot = buf + (size_t)(ntop)*NB * kb;
+            rbot = buf + len;
+            rtop = rbot + (size_t)(ntop)*NB * kb;
+            /*
+ * Pack my blocks, tops first
+ */
+            for (ib = 0; ib < ntop + nbot; ib++)
+            {
+                Aptr = A + (size_t)((iwork[ib] / np) * NB) * sl + (size_t)(j0)*sj;
+                Wptr = buf + (size_t)(ib)*NB * kb;
+                for (j = 0; j < kb; j++)
+                    for (i = 0; i < NB; i++)
+                        Wptr[(size_t)(j)*NB + i] = Aptr[(size_t)(i)*sl + (size_t)(j)*sj];
+            }
+            /*
+ * Exchange with the partners:  my tops go to qup, which sends back the
+ * matching bottoms,  my bottoms go to qdn, which sends back the tops.
+ * When hb is a multiple of np, the partners are my own blocks.
+ */
+            if (qup == myp)
+            {
+                rbot = sbot;
+                rtop = stop;
+            }
+            else
+            {
+                nreq = 0;
+                if ((ntop > 0) && (ierr == MPI_SUCCESS))
+                {
+                    ierr = MPI_Irecv(rbot, ntop * NB * kb, HPLAI_MPI_AFLOAT,
+                                     qup, tag + 1, comm, &req[nreq++]);
+                    if (ierr == MPI_SUCCESS)
+                        ierr = MPI_Isend(stop, ntop * NB * kb, HPLAI_MPI_AFLOAT,
+                                         qup, tag, comm, &req[nreq++]);
+                }
+                if ((nbot > 0) && (ierr == MPI_SUCCESS))
+                {
+                    ierr = MPI_Irecv(rtop, nbot * NB * kb, HPLAI_MPI_AFLOAT,
+                                     qdn, tag, comm, &req[nreq++]);
+                    if (ierr == MPI_SUCCESS)
+                        ierr = MPI_Isend(sbot, nbot * NB * kb, HPLAI_MPI_AFLOAT,
+                                         qdn, tag + 1, comm, &req[nreq++]);
+                }
+                if ((ierr == MPI_SUCCESS) && (nreq > 0))
+                    ierr = MPI_Waitall(nreq, req, sts);
+            }
+            /*
+ * Combine my blocks with their partners and store them back into A
+ */
+            for (ib = 0; ib < ntop + nbot; ib++)
+            {
+                Aptr = A + (size_t)((iwork[ib] / np) * NB) * sl + (size_t)(j0)*sj;
+                Wptr = buf + (size_t)(ib)*NB * kb;
+                Pptr = (ib < ntop ? rbot + (size_t)(ib)*NB * kb
+                                  : rtop + (size_t)(ib - ntop) * NB * kb);
+                for (i = 0; i < NB; i++)
+                {
+                    dm = dmy[(size_t)(ib)*NB + i];
+                    dp = dpa[(size_t)(ib)*NB + i];
+                    for (j = 0; j < kb; j++)
+                    {
+                        t = (double)(Wptr[(size_t)(j)*NB + i]);
+                        u = (double)(Pptr[(size_t)(j)*NB + i]);
+                        if (fwd)
+                            t = (ib < ntop ? dm * (t + u) : dm * (u - t));
+                        else
+                            t = (ib < ntop ? dm * t + dp * u : dp * u - dm * t);
+                        Aptr[(size_t)(i)*sl + (size_t)(j)*sj] = (HPLAI_T_AFLOAT)(s * t);
+                    }
+                }
+            }
+        }
+    }
+
+    if (ierr != MPI_SUCCESS)
+    {
+        HPLAI_pabort(__LINE__, "HPLAI_parbt", "MPI call failed");
+    }
+
+    free(buf);
+    free(dwork);
+    free(iwork);
+    /*
+ * End of HPLAI_parbt
+ */
+}
+
+HPLAI_INSTANTIATE(HPLAI_parbt);
@@ -26,6 +26,7 @@
  */
 #include "hplai.hh"
 
+template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
 void HPLAI_paupdateNN(
     HPLAI_T_panel *PBCST,
@@ -74,11 +75,12 @@ const int NN;
     /*
  * .. Local Variables ..
  */
-    HPLAI_T_AFLOAT *Aptr, *L1ptr, *L2ptr, *Uptr, *dpiv;
-    int *ipiv;
+    HPLAI_T_AFLOAT *Aptr, *L1ptr, *L2ptr, *Uptr;
+    int *ipiv, *ppiv;
 #ifdef HPL_CALL_VSIPL
     vsip_mview_d *Av0, *Av1, *Lv0, *Lv1, *Uv0, *Uv1;
 #endif
+    double tt;
     int curr, i, iroff, jb, lda, ldl2, mp, n, nb,
         nq0, nn, test;
     static int tswap = 0;
@@ -126,7 +128,7 @@ const int NN;
         L2ptr = PANEL->L2;
         L1ptr = PANEL->L1;
         ldl2 = PANEL->ldl2;
-        dpiv = PANEL->DPIV;
+        ppiv = PANEL->IPIV;
         ipiv = PANEL->IWORK;
         mp = PANEL->mp - jb;
         iroff = PANEL->ii;
@@ -149,7 +151,7 @@ const int NN;
 #endif
         for (i = 0; i < jb; i++)
         {
-            ipiv[i] = (int)(dpiv[i]) - iroff;
+            ipiv[i] = ppiv[i] - iroff;
         }
         /*
  * So far we have not updated anything -  test availability of the panel
@@ -163,6 +165,7 @@ const int NN;
 /*
  * Update nb columns at a time
  */
+            tt = HPLAI_trace_time();
 #ifdef HPL_DETAILED_TIMING
             HPL_ptimer(HPL_TIMING_LASWP);
             HPLAI_alaswp00N(jb, nn, Aptr, lda, ipiv);
@@ -170,8 +173,10 @@ const int NN;
 #else
             HPLAI_alaswp00N(jb, nn, Aptr, lda, ipiv);
 #endif
+            tt = HPLAI_trace_event(HPLAI_TRACE_LASWP, tt, PANEL->ja - jb);
             blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Side::Left, blas::Uplo::Lower, blas::Op::NoTrans,
                                                        blas::Diag::Unit, jb, nn, HPLAI_rone, L1ptr, jb, Aptr, lda);
+            tt = HPLAI_trace_event(HPLAI_TRACE_TRSM, tt, PANEL->ja - jb);
 #ifdef HPL_CALL_VSIPL
             /*
  * Create the matrix subviews
@@ -191,6 +196,7 @@ const int NN;
                                                                        jb, -HPLAI_rone, L2ptr, ldl2, Aptr, lda, HPLAI_rone,
                                                                        Mptr(Aptr, jb, 0, lda), lda);
 #endif
+            (void)HPLAI_trace_event(HPLAI_TRACE_GEMM, tt, PANEL->ja - jb);
             Aptr = Mptr(Aptr, 0, nn, lda);
             nq0 += nn;
 
@@ -201,6 +207,7 @@ const int NN;
  */
         if ((nn = n - nq0) > 0)
         {
+            tt = HPLAI_trace_time();
 #ifdef HPL_DETAILED_TIMING
             HPL_ptimer(HPL_TIMING_LASWP);
             HPLAI_alaswp00N(jb, nn, Aptr, lda, ipiv);
@@ -208,8 +215,10 @@ const int NN;
 #else
             HPLAI_alaswp00N(jb, nn, Aptr, lda, ipiv);
 #endif
+            tt = HPLAI_trace_event(HPLAI_TRACE_LASWP, tt, PANEL->ja - jb);
             blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Side::Left, blas::Uplo::Lower, blas::Op::NoTrans,
                                                        blas::Diag::Unit, jb, nn, HPLAI_rone, L1ptr, jb, Aptr, lda);
+            tt = HPLAI_trace_event(HPLAI_TRACE_TRSM, tt, PANEL->ja - jb);
 #ifdef HPL_CALL_VSIPL
             /*
  * Create the matrix subviews
@@ -229,6 +238,7 @@ const int NN;
                                                                        jb, -HPLAI_rone, L2ptr, ldl2, Aptr, lda, HPLAI_rone,
                                                                        Mptr(Aptr, jb, 0, lda), lda);
 #endif
+            (void)HPLAI_trace_event(HPLAI_TRACE_GEMM, tt, PANEL->ja - jb);
         }
 #ifdef HPL_CALL_VSIPL
         /*
@@ -258,8 +268,12 @@ const int NN;
             tswap = PANEL->algo->fsthr;
         }
 
-        if ((fswap == HPLAI_SWAP01) ||
-            ((fswap == HPLAI_SW_MIX) && (n > tswap)))
+        if (HPLAI_pnoswp(PANEL))
+        {
+            HPLAI_palaswp02N(PBCST, &test, PANEL, n);
+        }
+        else if ((fswap == HPLAI_SWAP01) ||
+                 ((fswap == HPLAI_SW_MIX) && (n > tswap)))
         {
             HPLAI_palaswp01N(PBCST, &test, PANEL, n);
         }
@@ -304,8 +318,10 @@ const int NN;
             nn = n - nq0;
             nn = Mmin(nb, nn);
 
+            tt = HPLAI_trace_time();
             blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Side::Left, blas::Uplo::Lower, blas::Op::NoTrans,
                                                        blas::Diag::Unit, jb, nn, HPLAI_rone, L1ptr, jb, Uptr, LDU);
+            tt = HPLAI_trace_event(HPLAI_TRACE_TRSM, tt, PANEL->ja - jb);
             if (curr != 0)
             {
 #ifdef HPL_CALL_VSIPL
@@ -351,6 +367,7 @@ const int NN;
                                                                            Aptr, lda);
 #endif
             }
+            (void)HPLAI_trace_event(HPLAI_TRACE_GEMM, tt, PANEL->ja - jb);
             Uptr = Mptr(Uptr, 0, nn, LDU);
             Aptr = Mptr(Aptr, 0, nn, lda);
             nq0 += nn;
@@ -362,8 +379,10 @@ const int NN;
  */
         if ((nn = n - nq0) > 0)
         {
+            tt = HPLAI_trace_time();
             blas::trsm<HPLAI_T_AFLOAT, HPLAI_T_AFLOAT>(blas::Layout::ColMajor, blas::Side::Left, blas::Uplo::Lower, blas::Op::NoTrans,
                                                        blas::Diag::Unit, jb, nn, HPLAI_rone, L1ptr, jb, Uptr, LDU);
+            tt = HPLAI_trace_event(HPLAI_TRACE_TRSM, tt, PANEL->ja - jb);
 
             if (curr != 0)
             {
@@ -410,6 +429,7 @@ const int NN;
                                                                            Aptr, lda);
 #endif
             }
+            (void)HPLAI_trace_event(HPLAI_TRACE_GEMM, tt, PANEL->ja - jb);
         }
 #ifdef HPL_CALL_VSIPL
         /*
@@ -447,3 +467,5 @@ const int NN;
  * End of HPLAI_paupdateNN
  */
 }
+
+HPLAI_INSTANTIATE(HPLAI_paupdateNN);
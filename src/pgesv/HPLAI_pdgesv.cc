@@ -25,25 +25,121 @@
  * Include files
  */
 #include "hplai.hh"
+#include <type_traits>
+
+/*
+ * Level 2 kernels of the distributed triangular solves below. The right-
+ * hand side and the solution are always kept in double. Factors stored in
+ * a lower precision are upcast on the fly, tile by tile, into the NB x NB
+ * workspace W, so that no double copy of the factors is ever needed.
+ */
+template <typename T>
+static void HPL_ptrsv_gemv(
+    const int M,
+    const int N,
+    const T *A,
+    const int LDA,
+    const double *X,
+    double *Y,
+    double *W,
+    const int NB)
+{
+    int i, ib, ii, j, jb, jj;
+
+    for (j = 0; j < N; j += NB)
+    {
+        jb = Mmin(NB, N - j);
+        for (i = 0; i < M; i += NB)
+        {
+            ib = Mmin(NB, M - i);
+            for (jj = 0; jj < jb; jj++)
+                for (ii = 0; ii < ib; ii++)
+                    W[ii + jj * NB] = (double)(*Mptr(A, i + ii, j + jj, LDA));
+            blas::gemv<double, double, double>(blas::Layout::ColMajor, blas::Op::NoTrans, ib, jb, -HPL_rone,
+                                               W, NB, X + j, 1, HPL_rone, Y + i, 1);
+        }
+    }
+}
+
+template <>
+inline void HPL_ptrsv_gemv<double>(
+    const int M,
+    const int N,
+    const double *A,
+    const int LDA,
+    const double *X,
+    double *Y,
+    double *W,
+    const int NB)
+{
+    (void)W;
+    (void)NB;
+    /* Y := Y - A * X */
+    blas::gemv<double, double, double>(blas::Layout::ColMajor, blas::Op::NoTrans, M, N, -HPL_rone,
+                                       A, LDA, X, 1, HPL_rone, Y, 1);
+}
+
+template <typename T>
+static void HPL_ptrsv_trsv(
+    const blas::Uplo UPLO,
+    const blas::Diag DIAG,
+    const int N,
+    const T *A,
+    const int LDA,
+    double *X,
+    double *W,
+    const int NB)
+{
+    int i, j;
+
+    /* N <= NB: a diagonal block always fits in W */
+    for (j = 0; j < N; j++)
+        for (i = 0; i < N; i++)
+            W[i + j * NB] = (double)(*Mptr(A, i, j, LDA));
+    blas::trsv<double, double>(blas::Layout::ColMajor, UPLO, blas::Op::NoTrans, DIAG,
+                               N, W, NB, X, 1);
+}
+
+template <>
+inline void HPL_ptrsv_trsv<double>(
+    const blas::Uplo UPLO,
+    const blas::Diag DIAG,
+    const int N,
+    const double *A,
+    const int LDA,
+    double *X,
+    double *W,
+    const int NB)
+{
+    (void)W;
+    (void)NB;
+    blas::trsv<double, double>(blas::Layout::ColMajor, UPLO, blas::Op::NoTrans, DIAG,
+                               N, A, LDA, X, 1);
+}
 
 // https://github.com/schuangs/hpl-ai-with-IR/blob/master/src/pgesv/HPL_pLdtrsv.c
 
+template <typename TMAT>
 static void HPL_pLdtrsv(
     HPL_T_grid *GRID,
-    HPL_T_pmat *AMAT)
+    TMAT *AMAT,
+    double *XC,
+    double *XR)
 {
     /* 
  * Purpose
  * =======
  *
- * HPL_pdtrsv solves an lower triangular system of linear equations.
+ * HPL_pLdtrsv solves an unit lower triangular system of linear equations.
  *  
- * The rhs is the last column of the N by N+1 matrix A. The solve starts
+ * The rhs b is held in XC (size np = LOCp( N )) by the process column
+ * that owns the last column of the N by N+1 matrix A.  The solve starts
  * in the process  column owning the  1th  column of A, so the rhs b may
- * need to be moved one process column to the left at the beginning. The
- * routine therefore needs  a column  vector in every process column but
- * the one owning  b. The result is  replicated in all process rows, and
- * returned in XR, i.e. XR is of size nq = LOCq( N ) in all processes.
+ * need to be moved one process column to the left at the beginning. XC
+ * is overwritten in every process column. The result is  replicated in
+ * all process rows, and returned in XR, i.e. XR is of size nq = LOCq( N )
+ * in all processes.  The factors may be stored in any precision,  the
+ * vectors are double.
  *  
  * The algorithm uses decreasing one-ring broadcast in process rows  and
  * columns  implemented  in terms of  synchronous communication point to
@@ -67,24 +163,31 @@ static void HPL_pLdtrsv(
  *         On entry,  GRID  points  to the data structure containing the
  *         process grid information.
  *
- * AMAT    (local input/output)          HPL_T_pmat *
+ * AMAT    (local input)                 HPL_T_pmat * or HPLAI_T_pmat *
  *         On entry,  AMAT  points  to the data structure containing the
  *         local array information.
  *
+ * XC      (local input/output)          double *
+ *         On entry, XC contains the local pieces of the rhs b. On exit,
+ *         its content is destroyed.
+ *
+ * XR      (local output)                double *
+ *         On exit, XR contains the local pieces of the solution.
+ *
  * ---------------------------------------------------------------------
  */
     /*
  * .. Local Variables ..
  */
+    typedef typename std::remove_pointer<decltype(TMAT::A)>::type T;
     MPI_Comm Ccomm, Rcomm;
-    double *A = NULL, *Aprev = NULL, *Aptr, *XC = NULL,
-           *XR = NULL, *Xd = NULL, *Xdprev = NULL,
-           *W = NULL;
-    int Alcol, Alrow, Anpprev, Anp, Anq, Bcol,
+    T *A = NULL, *Aprev = NULL, *Aptr;
+    double *Xd = NULL, *Xdprev = NULL, *W = NULL, *WA = NULL;
+    int Alcol, Alrow, Anp, Anq, Bcol,
         Cmsgid, GridIsNotPx1, GridIsNot1xQ, Rmsgid,
         Wfr = 0, colprev, kb, kbprev, lda, mycol,
         myrow, n, n1, n1p, n1pprev = 0, nb, npcol,
-        nprow, rowprev, tmp1, tmp2, np, nq, N;
+        nprow, rowprev, tmp1, tmp2, np, N;
 /* ..
  * .. Executable Statements ..
  */
@@ -96,7 +199,6 @@ static void HPL_pLdtrsv(
     nb = AMAT->nb;
     lda = AMAT->ld;
     A = AMAT->A;
-    XR = AMAT->X;
 
     (void)HPL_grid_info(GRID, &nprow, &npcol, &myrow, &mycol);
     Rcomm = GRID->row_comm;
@@ -108,9 +210,8 @@ static void HPL_pLdtrsv(
     /*
  * Move the rhs in the process column owning the first column of A.
  */
-    /* np and nq are the local dimensions of of A */
+    /* np is the local number of rows of A */
     Mnumroc(np, n, nb, nb, myrow, 0, nprow);
-    Mnumroc(nq, n, nb, nb, mycol, 0, npcol);
 
     Anp = 0;
     Anq = 0;
@@ -119,8 +220,7 @@ static void HPL_pLdtrsv(
     Alcol = 0;
     kb = Mmin(n, nb);
 
-    Aptr = (double *)(A);
-    XC = Mptr(Aptr, 0, nq, lda);
+    Aptr = A;
     Mindxg2p(n, nb, nb, Bcol, 0, npcol);
 
     if ((np > 0) && (Alcol != Bcol))
@@ -164,9 +264,16 @@ static void HPL_pLdtrsv(
         }
         Wfr = 1;
     }
+    if (!std::is_same<T, double>::value)
+    {
+        WA = (double *)malloc((size_t)(nb) * (size_t)(nb) * sizeof(double));
+        if (WA == NULL)
+        {
+            HPLAI_pabort(__LINE__, "HPL_pLdtrsv", "Memory allocation failed");
+        }
+    }
 
     /* previous version of parameters */
-    Anpprev = Anp;
     Xdprev = Xd = XR;
     Aprev = Aptr;
     tmp1 = kb;
@@ -182,8 +289,7 @@ static void HPL_pLdtrsv(
     {
         if (myrow == Alrow)
         {
-            blas::trsv<double, double>(blas::Layout::ColMajor, blas::Uplo::Lower, blas::Op::NoTrans, blas::Diag::Unit,
-                                       kb, Aptr, lda, XC, 1);
+            HPL_ptrsv_trsv(blas::Uplo::Lower, blas::Diag::Unit, kb, Aptr, lda, XC, WA, nb);
             blas::copy<double, double>(kb, XC, 1, Xd, 1);
         }
 
@@ -235,9 +341,7 @@ static void HPL_pLdtrsv(
  */
             if (n1pprev > 0)
             {
-                blas::gemv<double, double, double>(blas::Layout::ColMajor, blas::Op::NoTrans, n1pprev, kbprev,
-                                                   -HPL_rone, Aprev + Anp, lda, Xdprev, 1, HPL_rone,
-                                                   XC + Anp, 1);
+                HPL_ptrsv_gemv(n1pprev, kbprev, Aprev + Anp, lda, Xdprev, XC + Anp, WA, nb);
                 if (GridIsNotPx1)
                     (void)HPL_send(XC + Anp, n1pprev, Alcol, Rmsgid, Rcomm);
             }
@@ -267,16 +371,14 @@ static void HPL_pLdtrsv(
  */
         if ((mycol == Alcol) && (myrow == Alrow))
         {
-            blas::trsv<double, double>(blas::Layout::ColMajor, blas::Uplo::Lower, blas::Op::NoTrans, blas::Diag::Unit,
-                                       kb, Aptr + Anp, lda, XC + Anp, 1);
+            HPL_ptrsv_trsv(blas::Uplo::Lower, blas::Diag::Unit, kb, Aptr + Anp, lda, XC + Anp, WA, nb);
             blas::copy<double, double>(kb, XC + Anp, 1, Xd, 1);
         }
         /*
  *  Finish previous update
  */
         if ((mycol == colprev) && ((tmp1 = Anp + n1pprev) < np))
-            blas::gemv<double, double, double>(blas::Layout::ColMajor, blas::Op::NoTrans, np - tmp1, kbprev, -HPL_rone,
-                                               Aprev + tmp1, lda, Xdprev, 1, HPL_rone, XC + tmp1, 1);
+            HPL_ptrsv_gemv(np - tmp1, kbprev, Aprev + tmp1, lda, Xdprev, XC + tmp1, WA, nb);
 
         /*
  *  Save info of current step and update info for the next step
@@ -291,7 +393,6 @@ static void HPL_pLdtrsv(
         }
         if (myrow == Alrow)
         {
-            Anpprev = Anp;
             Anp += kb;
         }
 
@@ -319,11 +420,305 @@ static void HPL_pLdtrsv(
 
     if (Wfr)
         free(W);
+    if (WA)
+        free(WA);
 #ifdef HPL_DETAILED_TIMING
     HPL_ptimer(HPL_TIMING_PTRSV);
 #endif
     /*
- * End of HPL_pdtrsv
+ * End of HPL_pLdtrsv
+ */
+}
+
+
+/*
+ * Port of HPL_pdtrsv to factors of any precision, see HPL_pLdtrsv above.
+ */
+template <typename TMAT>
+static void HPL_pUdtrsv(
+    HPL_T_grid *GRID,
+    TMAT *AMAT,
+    double *XC,
+    double *XR)
+{
+    /* 
+ * Purpose
+ * =======
+ *
+ * HPL_pUdtrsv solves an upper triangular system of linear equations.
+ *  
+ * The rhs b is held in XC (size np = LOCp( N )) by the process column
+ * that owns the last column of the N by N+1 matrix A.  The solve starts
+ * in the process  column owning the  Nth  column of A, so the rhs b may
+ * need to be moved one process column to the left at the beginning. XC
+ * is overwritten in every process column. The result is  replicated in
+ * all process rows, and returned in XR, i.e. XR is of size nq = LOCq( N )
+ * in all processes.  The factors may be stored in any precision,  the
+ * vectors are double.
+ *
+ * Arguments
+ * =========
+ *
+ * GRID    (local input)                 HPL_T_grid *
+ *         On entry,  GRID  points  to the data structure containing the
+ *         process grid information.
+ *
+ * AMAT    (local input)                 HPL_T_pmat * or HPLAI_T_pmat *
+ *         On entry,  AMAT  points  to the data structure containing the
+ *         local array information.
+ *
+ * XC      (local input/output)          double *
+ *         On entry, XC contains the local pieces of the rhs b. On exit,
+ *         its content is destroyed.
+ *
+ * XR      (local output)                double *
+ *         On exit, XR contains the local pieces of the solution.
+ *
+ * ---------------------------------------------------------------------
+ */
+    /*
+ * .. Local Variables ..
+ */
+    typedef typename std::remove_pointer<decltype(TMAT::A)>::type T;
+    MPI_Comm Ccomm, Rcomm;
+    T *A = NULL, *Aprev = NULL, *Aptr;
+    double *Xd = NULL, *Xdprev = NULL, *W = NULL, *WA = NULL;
+    int Alcol, Alrow, Anpprev, Anp, Anq, Bcol,
+        Cmsgid, GridIsNotPx1, GridIsNot1xQ, Rmsgid,
+        Wfr = 0, colprev, kb, kbprev, lda, mycol,
+        myrow, n, n1, n1p, n1pprev = 0, nb, npcol,
+        nprow, rowprev, tmp1, tmp2;
+/* ..
+ * .. Executable Statements ..
+ */
+#ifdef HPL_DETAILED_TIMING
+    HPL_ptimer(HPL_TIMING_PTRSV);
+#endif
+    if ((n = AMAT->n) <= 0)
+        return;
+    nb = AMAT->nb;
+    lda = AMAT->ld;
+    A = AMAT->A;
+
+    (void)HPL_grid_info(GRID, &nprow, &npcol, &myrow, &mycol);
+    Rcomm = GRID->row_comm;
+    Rmsgid = MSGID_BEGIN_PTRSV;
+    Ccomm = GRID->col_comm;
+    Cmsgid = MSGID_BEGIN_PTRSV + 1;
+    GridIsNot1xQ = (nprow > 1);
+    GridIsNotPx1 = (npcol > 1);
+    /*
+ * Move the rhs in the process column owning the last column of A.
+ */
+    Mnumroc(Anp, n, nb, nb, myrow, 0, nprow);
+    Mnumroc(Anq, n, nb, nb, mycol, 0, npcol);
+
+    tmp1 = (n - 1) / nb;
+    Alrow = tmp1 - (tmp1 / nprow) * nprow;
+    Alcol = tmp1 - (tmp1 / npcol) * npcol;
+    kb = n - tmp1 * nb;
+
+    Aptr = A;
+    Mindxg2p(n, nb, nb, Bcol, 0, npcol);
+
+    if ((Anp > 0) && (Alcol != Bcol))
+    {
+        if (mycol == Bcol)
+        {
+            (void)HPL_send(XC, Anp, Alcol, Rmsgid, Rcomm);
+        }
+        else if (mycol == Alcol)
+        {
+            (void)HPL_recv(XC, Anp, Bcol, Rmsgid, Rcomm);
+        }
+    }
+    Rmsgid = (Rmsgid + 2 >
+                      MSGID_END_PTRSV
+                  ? MSGID_BEGIN_PTRSV
+                  : Rmsgid + 2);
+    if (mycol != Alcol)
+    {
+        for (tmp1 = 0; tmp1 < Anp; tmp1++)
+            XC[tmp1] = HPL_rzero;
+    }
+    /*
+ * Set up lookahead
+ */
+    n1 = (npcol - 1) * nb;
+    n1 = Mmax(n1, nb);
+    if (Anp > 0)
+    {
+        W = (double *)malloc((size_t)(Mmin(n1, Anp)) * sizeof(double));
+        if (W == NULL)
+        {
+            HPLAI_pabort(__LINE__, "HPL_pUdtrsv", "Memory allocation failed");
+        }
+        Wfr = 1;
+    }
+    if (!std::is_same<T, double>::value)
+    {
+        WA = (double *)malloc((size_t)(nb) * (size_t)(nb) * sizeof(double));
+        if (WA == NULL)
+        {
+            HPLAI_pabort(__LINE__, "HPL_pUdtrsv", "Memory allocation failed");
+        }
+    }
+
+    Anpprev = Anp;
+    Xdprev = XR;
+    Aprev = Aptr = Mptr(Aptr, 0, Anq, lda);
+    tmp1 = n - kb;
+    tmp1 -= (tmp2 = Mmin(tmp1, n1));
+    MnumrocI(n1pprev, tmp2, Mmax(0, tmp1), nb, nb, myrow, 0, nprow);
+
+    if (myrow == Alrow)
+    {
+        Anpprev = (Anp -= kb);
+    }
+    if (mycol == Alcol)
+    {
+        Aprev = (Aptr -= lda * kb);
+        Anq -= kb;
+        Xdprev = (Xd = XR + Anq);
+        if (myrow == Alrow)
+        {
+            HPL_ptrsv_trsv(blas::Uplo::Upper, blas::Diag::NonUnit, kb, Aptr + Anp, lda, XC + Anp, WA, nb);
+            blas::copy<double, double>(kb, XC + Anp, 1, Xd, 1);
+        }
+    }
+
+    rowprev = Alrow;
+    Alrow = MModSub1(Alrow, nprow);
+    colprev = Alcol;
+    Alcol = MModSub1(Alcol, npcol);
+    kbprev = kb;
+    n -= kb;
+    tmp1 = n - (kb = nb);
+    tmp1 -= (tmp2 = Mmin(tmp1, n1));
+    MnumrocI(n1p, tmp2, Mmax(0, tmp1), nb, nb, myrow, 0, nprow);
+    /*
+ * Start the operations
+ */
+    while (n > 0)
+    {
+        if (mycol == Alcol)
+        {
+            Aptr -= lda * kb;
+            Anq -= kb;
+            Xd = XR + Anq;
+        }
+        if (myrow == Alrow)
+        {
+            Anp -= kb;
+        }
+        /*
+ * Broadcast  (decreasing-ring)  of  previous solution block in previous
+ * process column,  compute  partial update of current block and send it
+ * to current process column.
+ */
+        if (mycol == colprev)
+        {
+            /*
+ * Send previous solution block in process row above
+ */
+            if (myrow == rowprev)
+            {
+                if (GridIsNot1xQ)
+                    (void)HPL_send(Xdprev, kbprev, MModSub1(myrow, nprow),
+                                   Cmsgid, Ccomm);
+            }
+            else
+            {
+                (void)HPL_recv(Xdprev, kbprev, MModAdd1(myrow, nprow),
+                               Cmsgid, Ccomm);
+            }
+            /*
+ * Compute partial update of previous solution block and send it to cur-
+ * rent column
+ */
+            if (n1pprev > 0)
+            {
+                tmp1 = Anpprev - n1pprev;
+                HPL_ptrsv_gemv(n1pprev, kbprev, Aprev + tmp1, lda, Xdprev, XC + tmp1, WA, nb);
+                if (GridIsNotPx1)
+                    (void)HPL_send(XC + tmp1, n1pprev, Alcol, Rmsgid, Rcomm);
+            }
+            /*
+ * Finish  the (decreasing-ring) broadcast of the solution block in pre-
+ * vious process column
+ */
+            if ((myrow != rowprev) &&
+                (myrow != MModAdd1(rowprev, nprow)))
+                (void)HPL_send(Xdprev, kbprev, MModSub1(myrow, nprow),
+                               Cmsgid, Ccomm);
+        }
+        else if (mycol == Alcol)
+        {
+            /*
+ * Current  column  receives  and accumulates partial update of previous
+ * solution block
+ */
+            if (n1pprev > 0)
+            {
+                (void)HPL_recv(W, n1pprev, colprev, Rmsgid, Rcomm);
+                blas::axpy<double, double>(n1pprev, HPL_rone, W, 1, XC + Anpprev - n1pprev, 1);
+            }
+        }
+        /*
+ * Solve current diagonal block 
+ */
+        if ((mycol == Alcol) && (myrow == Alrow))
+        {
+            HPL_ptrsv_trsv(blas::Uplo::Upper, blas::Diag::NonUnit, kb, Aptr + Anp, lda, XC + Anp, WA, nb);
+            blas::copy<double, double>(kb, XC + Anp, 1, XR + Anq, 1);
+        }
+        /*
+ *  Finish previous update
+ */
+        if ((mycol == colprev) && ((tmp1 = Anpprev - n1pprev) > 0))
+            HPL_ptrsv_gemv(tmp1, kbprev, Aprev, lda, Xdprev, XC, WA, nb);
+        /*
+ *  Save info of current step and update info for the next step
+ */
+        if (mycol == Alcol)
+        {
+            Xdprev = Xd;
+            Aprev = Aptr;
+        }
+        if (myrow == Alrow)
+        {
+            Anpprev -= kb;
+        }
+        rowprev = Alrow;
+        colprev = Alcol;
+        n1pprev = n1p;
+        kbprev = kb;
+        n -= kb;
+        Alrow = MModSub1(Alrow, nprow);
+        Alcol = MModSub1(Alcol, npcol);
+        tmp1 = n - (kb = nb);
+        tmp1 -= (tmp2 = Mmin(tmp1, n1));
+        MnumrocI(n1p, tmp2, Mmax(0, tmp1), nb, nb, myrow, 0, nprow);
+
+        Rmsgid = (Rmsgid + 2 > MSGID_END_PTRSV ? MSGID_BEGIN_PTRSV : Rmsgid + 2);
+        Cmsgid = (Cmsgid + 2 > MSGID_END_PTRSV ? MSGID_BEGIN_PTRSV + 1 : Cmsgid + 2);
+    }
+    /*
+ * Replicate last solution block
+ */
+    if (mycol == colprev)
+        (void)HPL_broadcast((void *)(XR), kbprev, HPL_DOUBLE, rowprev,
+                            Ccomm);
+
+    if (Wfr)
+        free(W);
+    if (WA)
+        free(WA);
+#ifdef HPL_DETAILED_TIMING
+    HPL_ptimer(HPL_TIMING_PTRSV);
+#endif
+    /*
+ * End of HPL_pUdtrsv
  */
 }
 
@@ -616,6 +1011,12 @@ static void applyHouseholder(
  * 
  * when performing A*v, if v is distributed along different rows like b, some redistributions
  * needed to perform to make v distributed along different columns like x.
+ *
+ * Rows and columns share the same block-cyclic layout (nb x nb blocks, origin at process
+ * (0,0)), so every local column block of vc is a whole block of v owned by exactly one
+ * process row. All the blocks a process row owns are packed into one message and broadcast
+ * over the process column, i.e. nprow broadcasts per call instead of one per element.
+ * Compile with HPLAI_REDIST_PER_ELEMENT to get the former element-wise version back.
  */
 static void redB2X(
     HPL_T_grid *GRID,
@@ -624,6 +1025,7 @@ static void redB2X(
     double *vc       /* the target space, size: nq */
 )
 {
+#ifdef HPLAI_REDIST_PER_ELEMENT
     int ig, i, j, jp;
     for (i = 0; i < A->nq - 1; ++i)
     {
@@ -643,6 +1045,52 @@ static void redB2X(
         /* broadcast the correct vc to other processes in the column */
         HPL_broadcast(&vc[i], 1, HPL_DOUBLE, jp, GRID->col_comm);
     }
+#else
+    double *buf;
+    int cnt, i, ib, ig, j, jp, nb = A->nb, nq = A->nq - 1, root;
+
+    if (nq <= 0)
+        return;
+
+    buf = (double *)malloc((size_t)(nq) * sizeof(double));
+    if (buf == NULL)
+        HPLAI_pabort(__LINE__, "redB2X", "Memory allocation failed");
+
+    for (root = 0; root < GRID->nprow; ++root)
+    {
+        /* pack the blocks of vc that the process row root holds in v */
+        cnt = 0;
+        for (i = 0; i < nq; i += nb)
+        {
+            ib = Mmin(nb, nq - i);
+            ig = HPL_indxl2g(i, nb, nb, GRID->mycol, 0, GRID->npcol);
+            HPL_indxg2lp(&j, &jp, ig, nb, nb, 0, GRID->nprow);
+            if (jp != root)
+                continue;
+            if (GRID->myrow == root)
+                memcpy(buf + cnt, v + j, (size_t)(ib) * sizeof(double));
+            cnt += ib;
+        }
+        if (cnt == 0)
+            continue;
+
+        /* one message per owner row, then scatter the blocks into vc */
+        HPL_broadcast(buf, cnt, HPL_DOUBLE, root, GRID->col_comm);
+
+        cnt = 0;
+        for (i = 0; i < nq; i += nb)
+        {
+            ib = Mmin(nb, nq - i);
+            ig = HPL_indxl2g(i, nb, nb, GRID->mycol, 0, GRID->npcol);
+            if (HPL_indxg2p(ig, nb, nb, 0, GRID->nprow) != root)
+                continue;
+            memcpy(vc + i, buf + cnt, (size_t)(ib) * sizeof(double));
+            cnt += ib;
+        }
+    }
+
+    free(buf);
+#endif
 }
 
 /*
@@ -650,14 +1098,19 @@ static void redB2X(
  * 
  * v is distributed along different columns like x, some redistributions
  * needed to perform to make v distributed along different columns like b.
+ *
+ * Block-wise counterpart of redB2X(): the blocks held by one process column
+ * are packed and broadcast over the process row in a single message.
  */
+template <typename TMAT>
 static void redX2B(
     HPL_T_grid *GRID,
-    HPL_T_pmat *A,   /* local A */
+    TMAT *A,         /* local A */
     const double *v, /* the vector to be redistributed, size: nq */
     double *vc       /* the target space, size: mp */
 )
 {
+#ifdef HPLAI_REDIST_PER_ELEMENT
     int ig, i, j, jp;
     for (i = 0; i < A->mp; ++i)
     {
@@ -676,16 +1129,110 @@ static void redX2B(
         /* broadcast the correct vc to other processes in the rows */
         HPL_broadcast(&vc[i], 1, HPL_DOUBLE, jp, GRID->row_comm);
     }
+#else
+    double *buf;
+    int cnt, i, ib, ig, j, jp, nb = A->nb, mp = A->mp, root;
+
+    if (mp <= 0)
+        return;
+
+    buf = (double *)malloc((size_t)(mp) * sizeof(double));
+    if (buf == NULL)
+        HPLAI_pabort(__LINE__, "redX2B", "Memory allocation failed");
+
+    for (root = 0; root < GRID->npcol; ++root)
+    {
+        /* pack the blocks of vc that the process column root holds in v */
+        cnt = 0;
+        for (i = 0; i < mp; i += nb)
+        {
+            ib = Mmin(nb, mp - i);
+            ig = HPL_indxl2g(i, nb, nb, GRID->myrow, 0, GRID->nprow);
+            HPL_indxg2lp(&j, &jp, ig, nb, nb, 0, GRID->npcol);
+            if (jp != root)
+                continue;
+            if (GRID->mycol == root)
+                memcpy(buf + cnt, v + j, (size_t)(ib) * sizeof(double));
+            cnt += ib;
+        }
+        if (cnt == 0)
+            continue;
+
+        HPL_broadcast(buf, cnt, HPL_DOUBLE, root, GRID->row_comm);
+
+        cnt = 0;
+        for (i = 0; i < mp; i += nb)
+        {
+            ib = Mmin(nb, mp - i);
+            ig = HPL_indxl2g(i, nb, nb, GRID->myrow, 0, GRID->nprow);
+            if (HPL_indxg2p(ig, nb, nb, 0, GRID->npcol) != root)
+                continue;
+            memcpy(vc + i, buf + cnt, (size_t)(ib) * sizeof(double));
+            cnt += ib;
+        }
+    }
+
+    free(buf);
+#endif
+}
+
+/*
+ * precondition()
+ *
+ * perform:
+ *    v <- U-1L-1v
+ * with the LU factors, whatever precision they are stored in. XC (size: mp)
+ * and XR (size: nq) are work vectors for the triangular solves. When the
+ * factors are those of the butterfly transformed matrix U'AV (RBT > 0),
+ * v <- V U-1L-1 U'v instead.
+ */
+template <typename TMAT>
+static void precondition(
+    HPL_T_grid *GRID,
+    TMAT *factors, /* local LU factors */
+    double *v,     /* the vector to be preconditioned, size: mp */
+    double *XC,    /* work vector, size: mp */
+    double *XR,    /* work vector, size: nq */
+    const int tarcol,
+    const int RBT)
+{
+    if (RBT > 0)
+        HPLAI_parbt<double>(GRID, blas::Side::Left, blas::Op::Trans, RBT, HPLAI_RBT_SEEDU,
+                            factors->n, factors->nb, 1, v, Mmax(1, factors->mp));
+
+    /* solve Lx = v, x is returned in XR, which is replicated in process rows */
+    if (GRID->mycol == tarcol)
+    {
+        memcpy(XC, v, factors->mp * sizeof(double));
+    }
+    HPL_pLdtrsv(GRID, factors, XC, XR);
+
+    /* redistribute x into column-distributing pattern for next trsv */
+    redX2B(GRID, factors, XR, v);
+
+    /* solve Ux = v */
+    if (GRID->mycol == tarcol)
+    {
+        memcpy(XC, v, factors->mp * sizeof(double));
+    }
+    HPL_pUdtrsv(GRID, factors, XC, XR);
+    redX2B(GRID, factors, XR, v);
+
+    if (RBT > 0)
+        HPLAI_parbt<double>(GRID, blas::Side::Left, blas::Op::NoTrans, RBT, HPLAI_RBT_SEEDV,
+                            factors->n, factors->nb, 1, v, Mmax(1, factors->mp));
 }
 
 /*
  *  HPL_pgmres():
  * 
  */
+template <typename TALG, typename TMAT>
 static int HPL_pgmres(
     HPL_T_grid *GRID,
+    TALG *ALGO,          /* algorithmic parameters, incl. operator of A */
     HPL_T_pmat *A,       /* local A */
-    HPL_T_pmat *factors, /* local LU factors */
+    TMAT *factors,       /* local LU factors */
     const double *b,     /* local rhs */
     double *x,           /* local solution vector */
     double TOL,          /* tolerance of residual */
@@ -699,15 +1246,15 @@ static int HPL_pgmres(
     double norm, currenterror, tmp;
     int mp = A->mp, nq = A->nq - 1;
 
-    /* bptr point to the rhs area of factors */
-    double *bptr = Mptr(factors->A, 0, nq, factors->ld);
-
     /* distributed storages: each process row stores a part of data */
     double *v = (double *)malloc(mp * sizeof(double));
     double *u = (double *)malloc(mp * sizeof(double));
     double *xt = (double *)malloc(nq * sizeof(double));
     double *H = (double *)malloc(mp * (MM + 1) * sizeof(double));
     double *rhs = (double *)malloc(mp * sizeof(double));
+    /* work vectors of the triangular solves */
+    double *XC = (double *)malloc(Mmax(mp, 1) * sizeof(double));
+    double *XR = (double *)malloc(Mmax(A->nq, 1) * sizeof(double));
 
     /* replicated storage: all processes store the whole data */
     double *cosus = (double *)malloc((MM + 1) * sizeof(double));
@@ -717,29 +1264,10 @@ static int HPL_pgmres(
 
     /* precondition b into rhs, that is: rhs = U-1L-1b */
     tarcol = HPL_indxg2p(factors->n, factors->nb, factors->nb, 0, GRID->npcol);
+    memcpy(rhs, b, mp * sizeof(double));
     if (prec)
     {
-        /* solve Lx = b, then x = L-1b, x is returned at factors->X, which is replicated in process rows */
-        if (GRID->mycol == tarcol)
-        {
-            memcpy(bptr, b, mp * sizeof(double));
-        }
-        HPL_pLdtrsv(GRID, factors);
-
-        /* redistribute x into column-distributing pattern for next pdtrsv */
-        redX2B(GRID, factors, factors->X, rhs);
-
-        /* solve Ux = b, then x = U-1b */
-        if (GRID->mycol == tarcol)
-        {
-            memcpy(bptr, rhs, mp * sizeof(double));
-        }
-        HPL_pdtrsv(GRID, factors);
-        redX2B(GRID, factors, factors->X, rhs);
-    }
-    else
-    {
-        memcpy(rhs, b, mp * sizeof(double));
+        precondition(GRID, factors, rhs, XC, XR, tarcol, ALGO->rbt);
     }
 
     /* no initial guess so the first residual r0 is just b */
@@ -779,26 +1307,13 @@ static int HPL_pgmres(
         {
             /* there is initial guess stored in x here from last iteration */
             /* calculate v = Ax */
-            blas::gemv<double, double, double>(blas::Layout::ColMajor, blas::Op::NoTrans, mp, nq, HPL_rone,
-                                               A->A, A->ld, x, 1, 0, v, 1);
+            ALGO->opfun(GRID, A, HPL_rone, x, HPL_rzero, v);
             HPL_all_reduce(v, mp, HPL_DOUBLE, HPL_sum, GRID->row_comm);
 
             /* preconditioning A */
             if (prec)
             {
-                if (GRID->mycol == tarcol)
-                {
-                    memcpy(bptr, v, mp * sizeof(double));
-                }
-                HPL_pLdtrsv(GRID, factors);
-                redX2B(GRID, factors, factors->X, v);
-
-                if (GRID->mycol == tarcol)
-                {
-                    memcpy(bptr, v, mp * sizeof(double));
-                }
-                HPL_pdtrsv(GRID, factors);
-                redX2B(GRID, factors, factors->X, v);
+                precondition(GRID, factors, v, XC, XR, tarcol, ALGO->rbt);
             }
 
             /* v = rhs - v = rhs - Ax */
@@ -839,26 +1354,13 @@ static int HPL_pgmres(
 
             /* calculate v = AP0P1..Pkv */
             redB2X(GRID, A, v, xt);
-            blas::gemv<double, double, double>(blas::Layout::ColMajor, blas::Op::NoTrans, mp, nq, HPL_rone,
-                                               A->A, A->ld, xt, 1, 0, v, 1);
+            ALGO->opfun(GRID, A, HPL_rone, xt, HPL_rzero, v);
             HPL_all_reduce(v, mp, HPL_DOUBLE, HPL_sum, GRID->row_comm);
 
             /* preconditioning A */
             if (prec)
             {
-                if (GRID->mycol == tarcol)
-                {
-                    memcpy(bptr, v, mp * sizeof(double));
-                }
-                HPL_pLdtrsv(GRID, factors);
-                redX2B(GRID, factors, factors->X, v);
-
-                if (GRID->mycol == tarcol)
-                {
-                    memcpy(bptr, v, mp * sizeof(double));
-                }
-                HPL_pdtrsv(GRID, factors);
-                redX2B(GRID, factors, factors->X, v);
+                precondition(GRID, factors, v, XC, XR, tarcol, ALGO->rbt);
             }
 
             /* apply last k + 1 Householder transformations: 
@@ -964,19 +1466,7 @@ static int HPL_pgmres(
         // /* preconditioning A */
         // if (prec)
         // {
-        //     if (GRID->mycol == tarcol)
-        //     {
-        //         memcpy(bptr, v, mp*sizeof(double));
-        //     }
-        //     HPL_pLdtrsv(GRID, factors);
-        //     redX2B(GRID, factors, factors->X, v);
-
-        //     if (GRID->mycol == tarcol)
-        //     {
-        //         memcpy(bptr, v, mp*sizeof(double));
-        //     }
-        //     HPL_pdtrsv(GRID, factors);
-        //     redX2B(GRID, factors, factors->X, v);
+        //     precondition(GRID, factors, v, XC, XR, tarcol);
         // }
 
         // norm = 0;
@@ -1033,9 +1523,17 @@ static int HPL_pgmres(
         free(R);
     if (xt)
         free(xt);
+    if (XC)
+        free(XC);
+    if (XR)
+        free(XR);
 
-    /* return total number of iterations performed */
-    return (start * MM + k + 1);
+    /*
+ * return total number of iterations performed: start has already been
+ * incremented past the last restart, and none were needed if the first
+ * residual met the tolerance
+ */
+    return (start == 0 ? 0 : (start - 1) * MM + k + 1);
 
     /* end of HPL_pgmres() */
 }
@@ -1051,11 +1549,12 @@ static int HPL_pgmres(
  *    ---by Carson, Erin & Higham, Nicholas J., 2017
  */
 
-static void HPL_pir(
+template <typename TALG, typename TMAT>
+static int HPL_pir(
     HPL_T_grid *GRID,
-    HPLAI_T_palg *ALGO,
+    TALG *ALGO,
     HPL_T_pmat *A,
-    HPL_T_pmat *factors,
+    TMAT *factors,
     double PRE, /* solution tolerance */
     int IR,
     int MM,    /* restart size for GMRES */
@@ -1069,7 +1568,8 @@ static void HPL_pir(
  * HPL_pir performs iterative refinement procesure to enhance the accur-
  * acy of  the solution  of linear system obtained  by LU factorization. 
  * Parallel  GMRES algorithm  is used  as the inner solver to solve  the 
- * inner correct equation Ad = r.
+ * inner correct equation Ad = r.  The total number of GMRES iterations
+ * is returned.
  *
  * Arguments
  * =========
@@ -1085,9 +1585,10 @@ static void HPL_pir(
  * A       (local input/output)          HPL_T_pmat *
  *         On entry, A points to the data structure containing the local
  *         array information. 
- * FA      (local input/output)          HPL_T_pmat *
- *         On entry, A points to the data structure containing the local
- *         array information. It serves as lower precision version if A.
+ * factors (local input)                 HPL_T_pmat * or HPLAI_T_pmat *
+ *         On entry, factors points to the LU factors of A and the lower
+ *         precision solution. The factors are used as the preconditioner
+ *         in the precision they are stored in.
  *
  * ---------------------------------------------------------------------
  */
@@ -1095,10 +1596,10 @@ static void HPL_pir(
     /*
  * .. Local Variables ..
  */
-    int i, j;
+    int i, it, j, iter = 0, zero;
     int mp, nq, n, nb, npcol, nprow, myrow, mycol, tarcol;
     double *Bptr, *res, *d;
-    double norm;
+    double norm, tt, xnorm;
 
     /* ..
  * .. Executable Statements ..
@@ -1130,7 +1631,7 @@ static void HPL_pir(
         *(factors->X + i) = 0;
     }
     */
-    blas::copy<double, double>(nq, factors->X, 1, A->X, 1);
+    blas::copy(nq, factors->X, 1, A->X, 1);
     //待检查能不能改成上面这个
 
     /*
@@ -1153,23 +1654,16 @@ static void HPL_pir(
         if (GRID->iam == 0)
             printf("IR Loop %d\n", i);
         */
+        tt = HPLAI_trace_time();
         /* Calculate residual in double precision */
         if (mycol == tarcol)
         {
             memcpy(res, Bptr, mp * sizeof(double));
-            blas::gemv<double, double, double>(blas::Layout::ColMajor, blas::Op::NoTrans, mp, nq, -HPL_rone,
-                                               A->A, A->ld, A->X, 1, HPL_rone, res, 1);
-        }
-        else if (nq > 0)
-        {
-            memset(res, 0, mp * sizeof(double));
-            blas::gemv<double, double, double>(blas::Layout::ColMajor, blas::Op::NoTrans, mp, nq, -HPL_rone,
-                                               A->A, A->ld, A->X, 1, HPL_rzero, res, 1);
+            ALGO->opfun(GRID, A, -HPL_rone, A->X, HPL_rone, res);
         }
         else
         {
-            for (j = 0; j < mp; ++j)
-                res[j] = HPL_rzero;
+            ALGO->opfun(GRID, A, -HPL_rone, A->X, HPL_rzero, res);
         }
 
         if (mp > 0)
@@ -1184,18 +1678,49 @@ static void HPL_pir(
         norm = sqrt(norm);
 
         if (norm < PRE)
+        {
+            (void)HPLAI_trace_event(HPLAI_TRACE_REFINE, tt, i);
             break;
+        }
 
         /* 
     * Solve correction  equation using preconditioned  GMRES  method in mix
     * precision.  
     */
+        /*
+    * The GMRES residual is the correction d preconditioned by the factors,
+    * so its tolerance is taken relative to the current solution: with the
+    * matrix scaled up,  x is small and an absolute tolerance would stop a
+    * 16-bit preconditioner before d reaches double accuracy.
+    */
+        xnorm = 0;
+        for (j = 0; j < nq; ++j)
+        {
+            xnorm += A->X[j] * A->X[j];
+        }
+        HPL_all_reduce(&xnorm, 1, HPL_DOUBLE, HPL_sum, GRID->row_comm);
+        xnorm = sqrt(xnorm);
+
         memset(d, 0, nq * sizeof(double));
-        HPL_pgmres(GRID, A, factors, res, d, TOL, MM, MAXIT);
+        it = HPL_pgmres(GRID, ALGO, A, factors, res, d, TOL * xnorm, MM, MAXIT);
+        /*
+    * Check the iteration count: at most MM per restart, and zero exactly
+    * when the first residual met the tolerance and d was left unchanged.
+    */
+        for (zero = 1, j = 0; j < nq; ++j)
+        {
+            if (d[j] != HPL_rzero)
+                zero = 0;
+        }
+        HPL_all_reduce(&zero, 1, HPL_INT, HPL_min, GRID->all_comm);
+        if ((it < 0) || (it > MAXIT * MM) || ((it == 0) != (zero != 0)))
+            HPLAI_pabort(__LINE__, "HPL_pir", "Inconsistent GMRES iteration count %d", it);
+        iter += it;
         /* 
     * update X with d
     */
         blas::axpy<double, double>(nq, 1, d, 1, A->X, 1);
+        (void)HPLAI_trace_event(HPLAI_TRACE_REFINE, tt, i);
     }
 
     /* free dynamic memories */
@@ -1204,6 +1729,7 @@ static void HPL_pir(
     if (res)
         free(res);
 
+    return (iter);
     /*
  * End of HPL_pir
  */
@@ -1236,14 +1762,17 @@ static void HPLAI_pmat_cpy(
     blas::copy(SRC->nq, SRC->X, 1, DST->X, 1);
 }
 
-template <typename T1, typename T2, typename T3>
-static void HPLAI_pmat_new(
+template <typename T1, typename T2, typename TALG, typename T3>
+static void HPLAI_pmat_init(
     T1 *DST,
     const T2 *SRC,
-    HPLAI_T_palg *ALGO,
+    TALG *ALGO,
     void **vptr,
     T3 *DSTA)
 {
+    /*
+     * Allocate DST with the shape of SRC, without copying the entries
+     */
     *vptr = (void *)malloc(
         ((size_t)(ALGO->align) + (size_t)(SRC->ld + 1) * (size_t)(SRC->nq)) * sizeof(DST->A[0]));
     if (*vptr == NULL)
@@ -1259,33 +1788,80 @@ static void HPLAI_pmat_new(
 
     DST->X = Mptr(DST->A, 0, SRC->nq, SRC->ld);
 
-    HPLAI_pmat_cpy(DST, SRC);
+    DST->n = SRC->n;
+    DST->nb = SRC->nb;
+    DST->ld = SRC->ld;
+    DST->mp = SRC->mp;
+    DST->nq = SRC->nq;
+    DST->info = SRC->info;
 }
 
-#ifdef __cplusplus
-extern "C"
+template <typename T1, typename T2, typename TALG, typename T3>
+static void HPLAI_pmat_new(
+    T1 *DST,
+    const T2 *SRC,
+    TALG *ALGO,
+    void **vptr,
+    T3 *DSTA)
 {
-#endif
+    HPLAI_pmat_init(DST, SRC, ALGO, vptr, DSTA);
+    HPLAI_pmat_cpy(DST, SRC);
+}
 
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
-    void HPLAI_pdgesv(
+    int HPLAI_pdgesv(
         HPL_T_grid *GRID,
         HPLAI_T_palg *ALGO,
         HPL_T_pmat *A)
 #else
-void HPLAI_pdgesv(GRID, ALGO, A)
+int HPLAI_pdgesv(GRID, ALGO, A)
     HPL_T_grid *GRID;
-HPL_T_palg *ALGO;
-HPLAI_T_pmat *A;
+HPLAI_T_palg *ALGO;
+HPL_T_pmat *A;
 #endif
     {
-        void *vptr_FA, *vptr_factors;
+        int iter = 0;
+        void *vptr_FA;
         HPLAI_T_pmat FA;
-        HPL_T_pmat factors;
+#ifdef HPLAI_PMAT_DIRECT
+        /*
+         * A has not been generated by the caller:  generate [ A | b ]
+         * directly in low precision, the double matrix is only generated
+         * after the factorization, for the refinement. With the analytic
+         * operator, only b is generated in double.
+         */
+        HPLAI_pmat_init(&FA, A, ALGO, &vptr_FA, FA.A);
+        HPLAI_pmatgen(GRID, A->n, A->n + 1, A->nb, FA.A, FA.ld, HPL_ISEED);
+#else
         HPLAI_pmat_new(&FA, A, ALGO, &vptr_FA, FA.A);
+#endif
+
+        if (ALGO->rbt > 0)
+        {
+            /*
+             * Factor [ U'AV | U'b ] without pivoting and get x = Vy back
+             * from the solution y of the transformed system.
+             */
+            HPLAI_parbt(GRID, blas::Side::Left, blas::Op::Trans, ALGO->rbt,
+                        HPLAI_RBT_SEEDU, A->n, A->nb, FA.nq, FA.A, FA.ld);
+            HPLAI_parbt(GRID, blas::Side::Right, blas::Op::NoTrans, ALGO->rbt,
+                        HPLAI_RBT_SEEDV, A->n, A->nb, FA.mp, FA.A, FA.ld);
+        }
 
         HPLAI_pagesv(GRID, ALGO, &FA);
 
+        if (ALGO->rbt > 0)
+            HPLAI_parbt(GRID, blas::Side::Right, blas::Op::Trans, ALGO->rbt,
+                        HPLAI_RBT_SEEDV, A->n, A->nb, 1, FA.X, 1);
+
+#ifdef HPLAI_IR_DOUBLE_FACTORS
+        /*
+         * Keep a double copy of the factors for the refinement, as it used
+         * to be done: 16 bytes per matrix entry instead of 12.
+         */
+        void *vptr_factors;
+        HPL_T_pmat factors;
 #ifdef HPLAI_PMAT_REGEN
         HPLAI_pmat_cpy(A, &FA);
         if (vptr_FA)
@@ -1293,21 +1869,46 @@ HPLAI_T_pmat *A;
         HPLAI_pmat_new(&factors, A, ALGO, &vptr_factors, factors.A);
         HPLAI_pdmatgen(GRID, A->n, A->n + 1, A->nb, A->A, A->ld, HPL_ISEED);
 #else
-    HPLAI_pmat_new(&factors, &FA, ALGO, &vptr_factors, factors.A);
-    if (vptr_FA)
-        free(vptr_FA);
+        HPLAI_pmat_new(&factors, &FA, ALGO, &vptr_factors, factors.A);
+        if (vptr_FA)
+            free(vptr_FA);
+#ifdef HPLAI_PMAT_DIRECT
+        if (ALGO->oper == HPLAI_OPER_ANALYTIC)
+            HPLAI_pdrhsgen(GRID, A->n, A->nb, Mptr(A->A, 0, A->nq - 1, A->ld), HPL_ISEED);
+        else
+            HPLAI_pdmatgen(GRID, A->n, A->n + 1, A->nb, A->A, A->ld, HPL_ISEED);
+#endif
 #endif
 
 #ifdef HPLAI_NO_IR
         HPLAI_pmat_cpy(A, &factors);
 #else
-    HPL_pir(GRID, ALGO, A, &factors, 1e-14, 1, 50, 1, DBL_EPSILON / 2.0 / ((double)A->n / 4.0));
+        iter = HPL_pir(GRID, ALGO, A, &factors, 1e-14, 1, 50, 1, DBL_EPSILON / 2.0 / ((double)A->n / 4.0));
 #endif
 
         if (vptr_factors)
             free(vptr_factors);
-    }
+#else
+        /*
+         * The refinement is preconditioned directly with the factors in
+         * FA, upcast to double on the fly by the triangular solves.
+         */
+#ifdef HPLAI_NO_IR
+        HPLAI_pmat_cpy(A, &FA);
+#else
+#ifdef HPLAI_PMAT_DIRECT
+        if (ALGO->oper == HPLAI_OPER_ANALYTIC)
+            HPLAI_pdrhsgen(GRID, A->n, A->nb, Mptr(A->A, 0, A->nq - 1, A->ld), HPL_ISEED);
+        else
+            HPLAI_pdmatgen(GRID, A->n, A->n + 1, A->nb, A->A, A->ld, HPL_ISEED);
+#endif
+        iter = HPL_pir(GRID, ALGO, A, &FA, 1e-14, 1, 50, 1, DBL_EPSILON / 2.0 / ((double)A->n / 4.0));
+#endif
 
-#ifdef __cplusplus
-}
+        if (vptr_FA)
+            free(vptr_FA);
 #endif
+        return (iter);
+    }
+
+HPLAI_INSTANTIATE(HPLAI_pdgesv);
@@ -0,0 +1,115 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+
+#ifdef STDC_HEADERS
+    void HPLAI_pdoper_stored(
+        const HPL_T_grid *GRID,
+        const HPL_T_pmat *A,
+        const double ALPHA,
+        const double *X,
+        const double BETA,
+        double *Y)
+#else
+void HPLAI_pdoper_stored(GRID, A, ALPHA, X, BETA, Y)
+    const HPL_T_grid *GRID;
+const HPL_T_pmat *A;
+const double ALPHA;
+const double *X;
+const double BETA;
+double *Y;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_pdoper_stored computes  y := alpha * A x + beta * y  restricted
+ * to the local part of the N by N matrix A, with the entries stored in
+ * A->A. The sum over the process row is left to the caller.
+ *
+ * Arguments
+ * =========
+ *
+ * GRID    (local input)                 const HPL_T_grid *
+ *         On entry,  GRID  points  to the data structure containing the
+ *         process grid information. It is unused here, and only part of
+ *         the HPLAI_T_OPR_FUN interface.
+ *
+ * A       (local input)                 const HPL_T_pmat *
+ *         On entry, A points to the data structure containing the local
+ *         array information. The local  A  is  A->mp by A->nq-1, the last
+ *         local column being the right-hand side.
+ *
+ * ALPHA   (local input)                 const double
+ *         On entry, ALPHA specifies the scalar alpha.
+ *
+ * X       (local input)                 const double *
+ *         On entry, X is the local part of x, of size A->nq-1.
+ *
+ * BETA    (local input)                 const double
+ *         On entry, BETA specifies the scalar beta. When BETA is zero, Y
+ *         need not be set on input.
+ *
+ * Y       (local input/output)          double *
+ *         On entry, Y is the local part of y, of size A->mp. On exit, Y
+ *         is overwritten by the updated vector.
+ *
+ * ---------------------------------------------------------------------
+ */
+        /*
+ * .. Local Variables ..
+ */
+        int i, mp, nq;
+        /* ..
+ * .. Executable Statements ..
+ */
+        (void)GRID;
+        mp = A->mp;
+        nq = A->nq - 1;
+        if (mp <= 0)
+            return;
+
+        if (nq > 0)
+        {
+            blas::gemv<double, double, double>(blas::Layout::ColMajor, blas::Op::NoTrans, mp, nq, ALPHA,
+                                               A->A, A->ld, X, 1, BETA, Y, 1);
+        }
+        else if (BETA == HPL_rzero)
+        {
+            for (i = 0; i < mp; i++)
+                Y[i] = HPL_rzero;
+        }
+        else
+        {
+            for (i = 0; i < mp; i++)
+                Y[i] *= BETA;
+        }
+        /*
+ * End of HPLAI_pdoper_stored
+ */
+    }
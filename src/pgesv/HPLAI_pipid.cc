@@ -26,6 +26,7 @@
  */
 #include "hplai.hh"
 
+template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
 void HPLAI_pipid(
     HPLAI_T_panel *PANEL,
@@ -55,7 +56,7 @@ int *IPID;
  * global index of the first row to be swapped.
  *  
  * For every row src IA + i with i in [0..N) to be swapped with row  dst
- * such that dst is given by DPIV[i]:
+ * such that dst is given by IPIV[i]:
  *  
  * Is row  src  the destination  of a previous row of the current block,
  * that is, is there k odd such that IPID(k) is equal to src ?
@@ -98,7 +99,7 @@ int *IPID;
  *         On entry, IPID is an array of length 4*N.  On exit, the first
  *         K entries of that array contain the src and final destination
  *         resulting  from  the  application of the  N  interchanges  as
- *         specified by  DPIV.  The  pairs  (src,dst)  are  contiguously
+ *         specified by  IPIV.  The  pairs  (src,dst)  are  contiguously
  *         stored and sorted so that IPID(2*i+1) is equal to IA+i with i
  *         in [0..N)
  *
@@ -109,14 +110,14 @@ int *IPID;
  */
     int dst, fndd, fnds, ia, i, j, jb, lst, off,
         src;
-    HPLAI_T_AFLOAT *dpiv;
+    int *ipiv;
     /* ..
  * .. Executable Statements ..
  */
-    dpiv = PANEL->DPIV;
+    ipiv = PANEL->IPIV;
     jb = PANEL->jb;
     src = ia = PANEL->ia;
-    dst = (int)(dpiv[0]);
+    dst = ipiv[0];
     IPID[0] = dst;
     IPID[1] = src;
     *K = 2;
@@ -132,7 +133,7 @@ int *IPID;
         fnds = 0;
         j = 1;
 
-        if ((src = ia + i) == (dst = (int)(dpiv[i])))
+        if ((src = ia + i) == (dst = ipiv[i]))
         {
             do
             {
@@ -214,3 +215,5 @@ int *IPID;
  * End of HPLAI_pipid
  */
 }
+
+HPLAI_INSTANTIATE(HPLAI_pipid);
@@ -26,6 +26,7 @@
  */
 #include "hplai.hh"
 
+template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
 void HPLAI_plindx0(
     HPLAI_T_panel *PANEL,
@@ -268,3 +269,5 @@ int *LLEN;
  * End of HPLAI_plindx0
  */
 }
+
+HPLAI_INSTANTIATE(HPLAI_plindx0);
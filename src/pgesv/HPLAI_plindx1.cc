@@ -26,6 +26,7 @@
  */
 #include "hplai.hh"
 
+template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
 void HPLAI_plindx1(
     HPLAI_T_panel *PANEL,
@@ -275,3 +276,5 @@ int *IWORK;
  * End of HPLAI_plindx1
  */
 }
+
+HPLAI_INSTANTIATE(HPLAI_plindx1);
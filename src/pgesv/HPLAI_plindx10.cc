@@ -26,6 +26,7 @@
  */
 #include "hplai.hh"
 
+template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
 void HPLAI_plindx10(
     HPLAI_T_panel *PANEL,
@@ -134,3 +135,5 @@ int *IPMAPM1;
  * End of HPLAI_plindx10
  */
 }
+
+HPLAI_INSTANTIATE(HPLAI_plindx10);
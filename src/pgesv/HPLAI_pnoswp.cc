@@ -0,0 +1,81 @@
+/*
+ * MIT License
+ * 
+ * Copyright (c) 2021 WuK
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+ * Include files
+ */
+#include "hplai.hh"
+
+template <typename HPLAI_T_AFLOAT>
+#ifdef STDC_HEADERS
+int HPLAI_pnoswp(
+    HPLAI_T_panel *PANEL)
+#else
+int HPLAI_pnoswp(PANEL)
+    HPLAI_T_panel *PANEL;
+#endif
+{
+    /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_pnoswp returns 1 when the no pivoting mode is enabled  and the
+ * pivoting vector of PANEL is the identity,  i.e. when the row panel U
+ * can be broadcast by  HPLAI_palaswp02N/T  without any row interchange,
+ * and 0 otherwise.
+ *
+ * Arguments
+ * =========
+ *
+ * PANEL   (local input)                 HPLAI_T_panel *
+ *         On entry,  PANEL  points to the data structure containing the
+ *         panel information.
+ *
+ * ---------------------------------------------------------------------
+ */
+    /*
+ * .. Local Variables ..
+ */
+    int i, ia, *ipiv, jb;
+    /* ..
+ * .. Executable Statements ..
+ */
+    if (PANEL->algo->nopiv == 0)
+        return (0);
+
+    ipiv = PANEL->IPIV;
+    ia = PANEL->ia;
+    jb = PANEL->jb;
+
+    for (i = 0; i < jb; i++)
+    {
+        if (ipiv[i] != ia + i)
+            return (0);
+    }
+    return (1);
+    /*
+ * End of HPLAI_pnoswp
+ */
+}
+
+HPLAI_INSTANTIATE(HPLAI_pnoswp);
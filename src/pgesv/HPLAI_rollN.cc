@@ -29,6 +29,7 @@
 #define I_SEND 0
 #define I_RECV 1
 
+template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
 void HPLAI_rollN(
     HPLAI_T_panel *PBCST,
@@ -204,3 +205,5 @@ const int *IPMAPM1;
  * End of HPLAI_rollN
  */
 }
+
+HPLAI_INSTANTIATE(HPLAI_rollN);
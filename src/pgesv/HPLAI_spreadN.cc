@@ -26,6 +26,7 @@
  */
 #include "hplai.hh"
 
+template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
 void HPLAI_spreadN(
     HPLAI_T_panel *PBCST,
@@ -320,3 +321,5 @@ const int *IPMAPM1;
  * End of HPLAI_spreadN
  */
 }
+
+HPLAI_INSTANTIATE(HPLAI_spreadN);
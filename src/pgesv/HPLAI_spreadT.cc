@@ -26,6 +26,7 @@
  */
 #include "hplai.hh"
 
+template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
 void HPLAI_spreadT(
     HPLAI_T_panel *PBCST,
@@ -389,3 +390,5 @@ const int *IPMAPM1;
  * End of HPLAI_spreadT
  */
 }
+
+HPLAI_INSTANTIATE(HPLAI_spreadT);
@@ -0,0 +1,297 @@
+/* 
+ * -- High Performance Computing Linpack Benchmark (HPL)                
+ *    HPL - 2.3 - December 2, 2018                          
+ *    Antoine P. Petitet                                                
+ *    University of Tennessee, Knoxville                                
+ *    Innovative Computing Laboratory                                 
+ *    (C) Copyright 2000-2008 All Rights Reserved                       
+ *                                                                      
+ * -- Copyright notice and Licensing terms:                             
+ *                                                                      
+ * Redistribution  and  use in  source and binary forms, with or without
+ * modification, are  permitted provided  that the following  conditions
+ * are met:                                                             
+ *                                                                      
+ * 1. Redistributions  of  source  code  must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.        
+ *                                                                      
+ * 2. Redistributions in binary form must reproduce  the above copyright
+ * notice, this list of conditions,  and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution. 
+ *                                                                      
+ * 3. All  advertising  materials  mentioning  features  or  use of this
+ * software must display the following acknowledgement:                 
+ * This  product  includes  software  developed  at  the  University  of
+ * Tennessee, Knoxville, Innovative Computing Laboratory.             
+ *                                                                      
+ * 4. The name of the  University,  the name of the  Laboratory,  or the
+ * names  of  its  contributors  may  not  be used to endorse or promote
+ * products  derived   from   this  software  without  specific  written
+ * permission.                                                          
+ *                                                                      
+ * -- Disclaimer:                                                       
+ *                                                                      
+ * THIS  SOFTWARE  IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING,  BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY
+ * OR  CONTRIBUTORS  BE  LIABLE FOR ANY  DIRECT,  INDIRECT,  INCIDENTAL,
+ * SPECIAL,  EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES  (INCLUDING,  BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA OR PROFITS; OR BUSINESS INTERRUPTION)  HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT,  STRICT LIABILITY,  OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ * ---------------------------------------------------------------------
+ */ 
+/*
+ * Include files
+ */
+#include "hpl.h"
+#include <limits.h>
+/*
+ * Largest message size in doubles, and number of repetitions of the
+ * smallest messages
+ */
+#define    HPL_COLLBENCH_MAX   1048576
+#define    HPL_COLLBENCH_REP   100
+/*
+ * Collectives measured, and implementations they are measured with
+ */
+#define    HPL_COLLBENCH_BCAST 0
+#define    HPL_COLLBENCH_RED   1
+#define    HPL_COLLBENCH_ARED  2
+
+#define    HPL_COLLBENCH_TREE  0
+#define    HPL_COLLBENCH_MPI   1
+#define    HPL_COLLBENCH_RSAG  2
+
+#ifdef STDC_HEADERS
+static double HPL_pcollbench_time
+(
+   const int                  OP,
+   const int                  IMPL,
+   const int                  COUNT,
+   const int                  NREP,
+   double *                   BUF,
+   MPI_Comm                   COMM,
+   int *                      NERR
+)
+#else
+static double HPL_pcollbench_time
+( OP, IMPL, COUNT, NREP, BUF, COMM, NERR )
+   const int                  OP;
+   const int                  IMPL;
+   const int                  COUNT;
+   const int                  NREP;
+   double *                   BUF;
+   MPI_Comm                   COMM;
+   int *                      NERR;
+#endif
+{
+/* 
+ * Purpose
+ * =======
+ *
+ * HPL_pcollbench_time  returns the largest over the processes of COMM of
+ * the average time taken by  the collective OP on COUNT doubles with the
+ * implementation IMPL, and increments NERR by the number of entries  of
+ * wrong value it produced on the calling process.  Every process starts
+ * with all entries equal to its rank in COMM plus one.
+ *
+ * ---------------------------------------------------------------------
+ */ 
+/*
+ * .. Local Variables ..
+ */
+   double                     expect, t, time = HPL_rzero;
+   int                        i, k, rank, size;
+/* ..
+ * .. Executable Statements ..
+ */
+   (void) MPI_Comm_rank( COMM, &rank );
+   (void) MPI_Comm_size( COMM, &size );
+
+   if(      IMPL == HPL_COLLBENCH_TREE ) HPL_coll_set( HPL_COLL_TREE, 0 );
+   else if( IMPL == HPL_COLLBENCH_MPI  ) HPL_coll_set( HPL_COLL_MPI, INT_MAX );
+   else                                  HPL_coll_set( HPL_COLL_MPI, 1 );
+
+   if( OP == HPL_COLLBENCH_BCAST ) expect = HPL_rone;
+   else expect = (double)(size) * (double)(size+1) / 2.0;
+
+   for( k = 0; k < NREP; k++ )
+   {
+      for( i = 0; i < COUNT; i++ ) BUF[i] = (double)(rank+1);
+      (void) MPI_Barrier( COMM );
+
+      t = HPL_ptimer_walltime();
+      if( OP == HPL_COLLBENCH_BCAST )
+         (void) HPL_broadcast( (void *)(BUF), COUNT, HPL_DOUBLE, 0, COMM );
+      else if( OP == HPL_COLLBENCH_RED )
+         (void) HPL_reduce( (void *)(BUF), COUNT, HPL_DOUBLE, HPL_sum, 0,
+                            COMM );
+      else
+         (void) HPL_all_reduce( (void *)(BUF), COUNT, HPL_DOUBLE, HPL_sum,
+                                COMM );
+      time += HPL_ptimer_walltime() - t;
+
+      if( ( OP != HPL_COLLBENCH_RED ) || ( rank == 0 ) )
+      {
+         for( i = 0; i < COUNT; i++ ) { if( BUF[i] != expect ) (*NERR)++; }
+      }
+   }
+   time /= (double)(NREP);
+   (void) MPI_Allreduce( MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX,
+                         COMM );
+   return( time );
+/*
+ * End of HPL_pcollbench_time
+ */
+}
+
+#ifdef STDC_HEADERS
+int main
+(
+   int                        ARGC,
+   char                       * * ARGV
+)
+#else
+int main( ARGC, ARGV )
+/*
+ * .. Scalar Arguments ..
+ */
+   int                        ARGC;
+/*
+ * .. Array Arguments ..
+ */
+   char                       * * ARGV;
+#endif
+{
+/* 
+ * Purpose
+ * =======
+ *
+ * main  is the driver of the grid collectives microbenchmark.  For every
+ * P x Q process grid of the MPI_COMM_WORLD processes, it times the  row,
+ * column and grid broadcasts, reductions and all-reductions of messages
+ * from 1 to  HPL_COLLBENCH_MAX  doubles  (or the first argument if any)
+ * with  the binomial trees  (HPL_COLL_TREE)  and  the MPI collectives
+ * (HPL_COLL_MPI).  The all-reductions are also timed as a reduce-scatter
+ * followed by an allgather.  Every line of the table reports the average
+ * time in microseconds  of the slowest process and the speedup  of the
+ * fastest MPI variant over the trees.
+ *
+ * ---------------------------------------------------------------------
+ */ 
+/*
+ * .. Local Variables ..
+ */
+   char                       * cname[3] = { "row", "column", "grid" },
+                              * oname[3] = { "bcast", "reduce", "allreduce" };
+   double                     time[3];
+   double                     * buf;
+   MPI_Comm                   comm;
+   HPL_T_grid                 grid;
+   int                        count, ic, impl, maxcount, mycol, myrow,
+                              nerr, nimpl, npcol, nprow, nrep, op, p,
+                              rank, size;
+/* ..
+ * .. Executable Statements ..
+ */
+   MPI_Init( &ARGC, &ARGV );
+   MPI_Comm_rank( MPI_COMM_WORLD, &rank );
+   MPI_Comm_size( MPI_COMM_WORLD, &size );
+
+   maxcount = HPL_COLLBENCH_MAX;
+   if( ARGC > 1 ) maxcount = Mmax( 1, atoi( ARGV[1] ) );
+
+   buf = (double *)malloc( (size_t)(maxcount) * sizeof( double ) );
+   if( buf == NULL )
+   { HPL_pabort( __LINE__, "main", "Memory allocation failed" ); }
+
+   if( rank == 0 )
+   {
+      HPL_fprintf( stdout, "%s%s\n",
+                   "========================================",
+                   "========================================" );
+      HPL_fprintf( stdout,
+                   "Grid collectives: binomial trees versus MPI, %d processes\n",
+                   size );
+      HPL_fprintf( stdout, "%s%s\n",
+                   "========================================",
+                   "========================================" );
+      HPL_fprintf( stdout, "%5s %5s %-6s %-9s %8s %11s %11s %11s %7s %s\n",
+                   "P", "Q", "Comm", "Op", "Count", "Tree(us)", "MPI(us)",
+                   "RS+AG(us)", "Speedup", "Check" );
+   }
+/*
+ * Loop over the process grids, the communicators of each grid, the col-
+ * lectives and the message sizes
+ */
+   for( p = 1; p <= size; p++ )
+   {
+      if( size % p != 0 ) continue;
+      (void) HPL_grid_init( MPI_COMM_WORLD, HPL_ROW_MAJOR, p, size / p,
+                            &grid );
+      (void) HPL_grid_info( &grid, &nprow, &npcol, &myrow, &mycol );
+
+      for( ic = 0; ic < 3; ic++ )
+      {
+         if(      ic == 0 ) { comm = grid.row_comm; if( npcol == 1 ) continue; }
+         else if( ic == 1 ) { comm = grid.col_comm; if( nprow == 1 ) continue; }
+         else               { comm = grid.all_comm; if( ( nprow == 1 ) ||
+                                                        ( npcol == 1 ) ) continue; }
+
+         for( op = 0; op < 3; op++ )
+         {
+            nimpl = ( op == HPL_COLLBENCH_ARED ? 3 : 2 );
+
+            for( count = 1; count <= maxcount; count *= 4 )
+            {
+               nrep = Mmax( 2, Mmin( HPL_COLLBENCH_REP, 262144 / count ) );
+               nerr = 0;
+               for( impl = 0; impl < nimpl; impl++ )
+                  time[impl] = HPL_pcollbench_time( op, impl, count, nrep,
+                                                    buf, comm, &nerr );
+               if( nimpl < 3 ) time[HPL_COLLBENCH_RSAG] = HPL_rzero;
+               (void) MPI_Allreduce( MPI_IN_PLACE, &nerr, 1, MPI_INT,
+                                     MPI_SUM, MPI_COMM_WORLD );
+/*
+ * The row and column timings reported are those of the first process
+ */
+               if( rank == 0 )
+               {
+                  HPL_fprintf( stdout,
+                               "%5d %5d %-6s %-9s %8d %11.2f %11.2f ",
+                               nprow, npcol, cname[ic], oname[op], count,
+                               1.0e+6 * time[HPL_COLLBENCH_TREE],
+                               1.0e+6 * time[HPL_COLLBENCH_MPI] );
+                  if( nimpl == 3 )
+                     HPL_fprintf( stdout, "%11.2f ",
+                                  1.0e+6 * time[HPL_COLLBENCH_RSAG] );
+                  else
+                     HPL_fprintf( stdout, "%11s ", "-" );
+                  if( ( nimpl == 3 ) &&
+                      ( time[HPL_COLLBENCH_RSAG] < time[HPL_COLLBENCH_MPI] ) )
+                     time[HPL_COLLBENCH_MPI] = time[HPL_COLLBENCH_RSAG];
+                  HPL_fprintf( stdout, "%7.2f %s\n",
+                               time[HPL_COLLBENCH_TREE] /
+                               Mmax( time[HPL_COLLBENCH_MPI], 1.0e-9 ),
+                               ( nerr == 0 ? "PASSED" : "FAILED" ) );
+               }
+            }
+         }
+      }
+      (void) HPL_grid_exit( &grid );
+   }
+   HPL_coll_set( HPL_COLL_TREE, 0 );
+
+   if( buf ) free( buf );
+   MPI_Finalize();
+   exit( 0 );
+
+   return( 0 );
+/*
+ * End of main
+ */
+}
@@ -26,11 +26,6 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
     /*
  * By Junkang Huang, November, 2020
  * 
@@ -47,19 +42,31 @@ extern "C"
 
     /*
  * Generate matrix A with alpha and beta parameters given.
+ *
+ * A(i,j) = (-beta  + (i-1)*alpha*beta) * scale   if i < j,
+ *          (1      + (i-1)*alpha*beta) * scale   if i = j,
+ *          (-alpha + (j-1)*alpha*beta) * scale   if i > j.
+ *
+ * The local matrix is filled one NB x NB tile at a time, the tiles are
+ * split across the OpenMP threads. In a given column of a tile,  the
+ * rows above the diagonal come first and the rows below come last, so
+ * that each column is filled by two branch-free loops around at most
+ * one diagonal entry. Every entry is computed by the same expression as
+ * in the element-wise generator,  hence the matrix is bit-identical.
  */
+    template <typename T>
     static void generateA(
         const HPL_T_grid *GRID,
         const int N,
         const int NB,
-        double *A,
+        T *A,
         const int LDA,
         const double alpha,
         const double beta,
         const double scale)
     {
         /* Local variables */
-        int iloc, jloc, jdisp, i, j, k1, k2, mp, nq;
+        int iblk, jblk, mblks, nblks, mp, nq;
         int myrow = GRID->myrow;
         int mycol = GRID->mycol;
         int nprow = GRID->nprow;
@@ -71,41 +78,51 @@ extern "C"
         /* shape of local A */
         Mnumroc(mp, N, NB, NB, myrow, 0, nprow);
         Mnumroc(nq, N, NB, NB, mycol, 0, npcol);
+        if ((mp <= 0) || (nq <= 0))
+            return;
+
+        /* local number of tiles */
+        mblks = (mp + NB - 1) / NB;
+        nblks = (nq + NB - 1) / NB;
 
-        /* iloc, jloc are local indices */
-        jloc = 0;
-        /* i, j are the global indices */
-        j = mycol * NB + 1;
-        while (jloc < nq)
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(static)
+#endif
+        for (jblk = 0; jblk < nblks; ++jblk)
         {
-            /* k1 iterates over different columns in a block column */
-            for (k1 = 0; k1 < NB && j <= N; ++k1)
+            for (iblk = 0; iblk < mblks; ++iblk)
             {
-                jdisp = jloc * LDA;
-                i = myrow * NB + 1;
-                iloc = 0;
-                while (iloc < mp)
+                /* shape of the tile and global indices of its first entry */
+                const int ib = Mmin(NB, mp - iblk * NB);
+                const int jb = Mmin(NB, nq - jblk * NB);
+                const int i0 = (iblk * nprow + myrow) * NB + 1;
+                const int j0 = (jblk * npcol + mycol) * NB + 1;
+                T *W = Mptr(A, iblk * NB, jblk * NB, LDA);
+                int k, r;
+
+                for (k = 0; k < jb; ++k)
                 {
-                    /* k2 iterates over different rows in a block */
-                    for (k2 = 0; k2 < NB && i <= N; ++k2)
-                    {
-                        if (i > j)
-                            A[jdisp + iloc] = (a + (j - 1) * ab);
-                        else if (i == j)
-                            A[jdisp + iloc] = (1 + (i - 1) * ab);
-                        else // (j < i)
-                            A[jdisp + iloc] = (b + (i - 1) * ab);
-
-                        A[jdisp + iloc] *= scale;
-                        iloc++;
-                        i++;
-                    }
-                    i += NB * (nprow - 1);
+                    const int j = j0 + k;
+                    const T l = (T)((a + (j - 1) * ab) * scale);
+                    /* rows of the tile with i < j and with i <= j */
+                    const int nu = Mmax(0, Mmin(ib, j - i0));
+                    const int nd = Mmax(0, Mmin(ib, j - i0 + 1));
+                    T *c = W + (size_t)(k) * (size_t)(LDA);
+
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+                    for (r = 0; r < nu; ++r)
+                        c[r] = (T)((b + (i0 + r - 1) * ab) * scale);
+                    if (nd > nu)
+                        c[nu] = (T)((1 + (j - 1) * ab) * scale);
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+                    for (r = nd; r < ib; ++r)
+                        c[r] = l;
                 }
-                jloc++;
-                j++;
             }
-            j += NB * (npcol - 1);
         }
     }
 
@@ -126,15 +143,21 @@ extern "C"
         *alpha = 0.5 * *beta;
     }
 
+    /* 
+ * Scale of the hole matrix, as suggested
+ */
+#define HPLAI_PMATGEN_SCALE (65504. / 2)
+
     /* 
  * HPL_generateA generates (or regenerates) a parallel N*N matrix A.
  *  Matrix A is generated based on the method proposed by Fasi M..
  */
+    template <typename T>
     static void HPLAI_generateA(
         const HPL_T_grid *GRID,
         const int N,
         const int NB,
-        double *A,
+        T *A,
         const int LDA)
     {
         /*
@@ -146,7 +169,7 @@ extern "C"
         calculate_ab(&alpha, &beta, N);
 
         /* scale the hole matrix as suggested */
-        scale = 65504. / 2;
+        scale = HPLAI_PMATGEN_SCALE;
         /* generate matrix A with alpha, beta and scale */
         generateA(GRID, N, NB, A, LDA, alpha, beta, scale);
 
@@ -161,11 +184,12 @@ extern "C"
  * Programming, Knuth 1973, Vol. 2.
  * 
  */
+    template <typename T>
     static void HPLAI_generateB(
         const HPL_T_grid *GRID,
         const int N,
         const int NB,
-        double *B,
+        T *B,
         const int ISEED)
     {
         /*
@@ -232,7 +256,7 @@ extern "C"
         {
             ib = (iblk == mblks - 1 ? lmb : NB);
             for (ik = 0; ik < ib; B++, ik++)
-                *B = HPL_rand();
+                *B = (T)HPL_rand();
             HPL_jumpit(ia2, ic2, ib1, iran2);
             ib1[0] = iran2[0];
             ib1[1] = iran2[1];
@@ -243,31 +267,24 @@ extern "C"
  */
     }
 
-#ifdef STDC_HEADERS
-    void HPLAI_pdmatgen(
+    template <typename T>
+    void HPLAI_pmatgen(
         const HPL_T_grid *GRID,
         const int M,
         const int N,
         const int NB,
-        double *A,
+        T *A,
         const int LDA,
         const int ISEED)
-#else
-void HPLAI_pdmatgen(GRID, M, N, NB, A, LDA, ISEED)
-    const HPL_T_grid *GRID;
-const int M;
-const int N;
-const int NB;
-double *A;
-const int LDA;
-const int ISEED;
-#endif
     {
         /* 
  * Purpose
  * =======
  *
- * HPL_pdmatgen generates (or regenerates) a parallel random matrix A.
+ * HPLAI_pmatgen generates (or regenerates) a parallel random matrix A
+ * directly in the precision T, e.g. HPLAI_T_LFLOAT or double. Each entry
+ * is generated in double and rounded once to T,  so that the result is
+ * the same as generating the matrix in double and converting it.
  *  
  * The  pseudo-random  generator uses the linear congruential algorithm:
  * X(n+1) = (a * X(n) + c) mod m  as  described  in the  Art of Computer
@@ -292,7 +309,7 @@ const int ISEED;
  *         On entry,  NB specifies the blocking factor used to partition
  *         and distribute the matrix A. NB must be larger than one.
  *
- * A       (local output)                double *
+ * A       (local output)                T *
  *         On entry,  A  points  to an array of dimension (LDA,LocQ(N)).
  *         On exit, this array contains the coefficients of the randomly
  *         generated matrix.
@@ -394,7 +411,7 @@ const int ISEED;
                 {
                     ib = (iblk == mblks - 1 ? lmb : NB);
                     for (ik = 0; ik < ib; A++, ik++)
-                        *A = HPL_rand();
+                        *A = (T)HPL_rand();
                     HPL_jumpit(ia2, ic2, ib1, iran2);
                     ib1[0] = iran2[0];
                     ib1[1] = iran2[1];
@@ -415,10 +432,201 @@ const int ISEED;
             ib3[1] = iran4[1];
         }
         /*
- * End of HPL_pdmatgen
+ * End of HPLAI_pmatgen
+ */
+    }
+
+/*
+ * Instantiate the generator for the precisions in use
+ */
+template void HPLAI_pmatgen<float>(const HPL_T_grid *, const int, const int,
+                                   const int, float *, const int, const int);
+template void HPLAI_pmatgen<double>(const HPL_T_grid *, const int, const int,
+                                    const int, double *, const int, const int);
+#if defined(HPLAI_SOFT_LFLOAT)
+template void HPLAI_pmatgen<HPLAI_T_LFLOAT>(const HPL_T_grid *, const int, const int,
+                                            const int, HPLAI_T_LFLOAT *, const int, const int);
+#endif
+
+#ifdef STDC_HEADERS
+    void HPLAI_pdmatgen(
+        const HPL_T_grid *GRID,
+        const int M,
+        const int N,
+        const int NB,
+        double *A,
+        const int LDA,
+        const int ISEED)
+#else
+void HPLAI_pdmatgen(GRID, M, N, NB, A, LDA, ISEED)
+    const HPL_T_grid *GRID;
+const int M;
+const int N;
+const int NB;
+double *A;
+const int LDA;
+const int ISEED;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_pdmatgen generates (or regenerates) a parallel matrix A in double
+ * precision, see HPLAI_pmatgen.
+ *
+ * ---------------------------------------------------------------------
+ */
+        HPLAI_pmatgen<double>(GRID, M, N, NB, A, LDA, ISEED);
+        /*
+ * End of HPLAI_pdmatgen
+ */
+    }
+
+#ifdef STDC_HEADERS
+    void HPLAI_pdrhsgen(
+        const HPL_T_grid *GRID,
+        const int N,
+        const int NB,
+        double *B,
+        const int ISEED)
+#else
+void HPLAI_pdrhsgen(GRID, N, NB, B, ISEED)
+    const HPL_T_grid *GRID;
+const int N;
+const int NB;
+double *B;
+const int ISEED;
+#endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_pdrhsgen generates only the right-hand side b of [ A | b ],  as
+ * generated by HPLAI_pdmatgen( GRID, N, N+1, NB, A, LDA, ISEED ),  in
+ * the process column owning it. B is the local part of b, i.e.  column
+ * LocQ(N) of A.
+ *
+ * ---------------------------------------------------------------------
+ */
+        HPLAI_generateB(GRID, N, NB, B, ISEED);
+        /*
+ * End of HPLAI_pdrhsgen
  */
     }
 
-#ifdef __cplusplus
-}
+#ifdef STDC_HEADERS
+    void HPLAI_pdoper_analytic(
+        const HPL_T_grid *GRID,
+        const HPL_T_pmat *A,
+        const double ALPHA,
+        const double *X,
+        const double BETA,
+        double *Y)
+#else
+void HPLAI_pdoper_analytic(GRID, A, ALPHA, X, BETA, Y)
+    const HPL_T_grid *GRID;
+const HPL_T_pmat *A;
+const double ALPHA;
+const double *X;
+const double BETA;
+double *Y;
 #endif
+    {
+        /* 
+ * Purpose
+ * =======
+ *
+ * HPLAI_pdoper_analytic computes  y := alpha * A x + beta * y  restric-
+ * ted to the local part of the N by N matrix A generated by  HPLAI_pd-
+ * matgen, without reading A->A.  Off the diagonal,  the  entries of  A
+ * only depend on the row (above) or on the column (below),  so that row
+ * i of the local product is
+ *
+ *    u_i * sum_{j>i} x_j  +  d_i * x_i  +  sum_{j<i} l_j * x_j,
+ *
+ * computed with a prefix and a suffix sum over the local columns in
+ * O( LocP(N) + LocQ(N) ) operations.  The entries are computed as in
+ * the generator. The sum over the process row is left to the caller.
+ *
+ * Arguments
+ * =========
+ *
+ * See HPLAI_pdoper_stored.
+ *
+ * ---------------------------------------------------------------------
+ */
+        /*
+ * .. Local Variables ..
+ */
+        double alpha, beta, ab, a, b, scale, sum;
+        int gi, gj, il, jl, mp, mycol, myrow, nb,
+            npcol, nprow, nq;
+        /* ..
+ * .. Executable Statements ..
+ */
+        (void)HPL_grid_info(GRID, &nprow, &npcol, &myrow, &mycol);
+        mp = A->mp;
+        nq = A->nq - 1;
+        nb = A->nb;
+        if (mp <= 0)
+            return;
+
+        calculate_ab(&alpha, &beta, A->n);
+        scale = HPLAI_PMATGEN_SCALE;
+        ab = alpha * beta;
+        a = -alpha;
+        b = -beta;
+
+        if (BETA == HPL_rzero)
+        {
+            for (il = 0; il < mp; il++)
+                Y[il] = HPL_rzero;
+        }
+        else if (BETA != HPL_rone)
+        {
+            for (il = 0; il < mp; il++)
+                Y[il] *= BETA;
+        }
+        /*
+ * Lower part and diagonal: rows and columns by increasing global index
+ */
+        sum = HPL_rzero;
+        jl = 0;
+        for (il = 0; il < mp; il++)
+        {
+            gi = HPL_indxl2g(il, nb, nb, myrow, 0, nprow);
+            for (; jl < nq; jl++)
+            {
+                gj = HPL_indxl2g(jl, nb, nb, mycol, 0, npcol);
+                if (gj >= gi)
+                    break;
+                sum += ((a + gj * ab) * scale) * X[jl];
+            }
+            if ((jl < nq) && (HPL_indxl2g(jl, nb, nb, mycol, 0, npcol) == gi))
+                Y[il] += ALPHA * (sum + ((1 + gi * ab) * scale) * X[jl]);
+            else
+                Y[il] += ALPHA * sum;
+        }
+        /*
+ * Upper part: rows and columns by decreasing global index
+ */
+        sum = HPL_rzero;
+        jl = nq - 1;
+        for (il = mp - 1; il >= 0; il--)
+        {
+            gi = HPL_indxl2g(il, nb, nb, myrow, 0, nprow);
+            for (; jl >= 0; jl--)
+            {
+                gj = HPL_indxl2g(jl, nb, nb, mycol, 0, npcol);
+                if (gj <= gi)
+                    break;
+                sum += X[jl];
+            }
+            Y[il] += ALPHA * (((b + gi * ab) * scale) * sum);
+        }
+        /*
+ * End of HPLAI_pdoper_analytic
+ */
+    }
@@ -26,10 +26,150 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
+template <typename HPLAI_T_AFLOAT>
+static void HPLAI_pdrun(
+    HPLAI_T_test *TEST,
+    HPL_T_grid *GRID,
+    const int N,
+    const int NB,
+    const HPLAI_T_TOP TOPO,
+    const int DEPTH,
+    const int NBMIN,
+    const int NBDIV,
+    const HPLAI_T_FACT PFACT,
+    const HPLAI_T_FACT RFACT,
+    const int L1NOTRAN,
+    const int UNOTRAN,
+    const HPLAI_T_SWAP FSWAP,
+    const int TSWAP,
+    const int EQUIL,
+    const int ALIGN,
+    const HPLAI_T_OPER OPER,
+    const int BSEG,
+    const int NOPIV,
+    const int RBT,
+    const int MXSWP,
+    HPLAI_T_tres *RES)
 {
-#endif
+    /*
+ * Set up the algorithm parameters for a factorization in HPLAI_T_AFLOAT
+ * and run the test
+ */
+    HPLAI_T_palg algo;
+
+    algo.btopo = TOPO;
+    algo.depth = DEPTH;
+    algo.nbmin = NBMIN;
+    algo.nbdiv = NBDIV;
+
+    algo.pfact = PFACT;
+    algo.rfact = RFACT;
+
+    if (L1NOTRAN != 0)
+    {
+        if (PFACT == HPLAI_LEFT_LOOKING)
+            algo.pffun = HPLAI_papanllN;
+        else if (PFACT == HPLAI_CROUT)
+            algo.pffun = HPLAI_papancrN;
+        else if (PFACT == HPLAI_RIGHT_THREADED)
+            algo.pffun = HPLAI_papanthN;
+        else
+            algo.pffun = HPLAI_papanrlN;
+
+        if (RFACT == HPLAI_LEFT_LOOKING)
+            algo.rffun = HPLAI_parpanllN;
+        else if (RFACT == HPLAI_CROUT)
+            algo.rffun = HPLAI_parpancrN;
+        else
+            algo.rffun = HPLAI_parpanrlN;
+        if (PFACT == HPLAI_TOURNAMENT)
+            algo.pffun = algo.rffun = HPLAI_papantpN;
+
+        if (UNOTRAN != 0)
+            algo.upfun = HPLAI_paupdateNN;
+        else
+            algo.upfun = HPLAI_paupdateNT;
+    }
+    else
+    {
+        if (PFACT == HPLAI_LEFT_LOOKING)
+            algo.pffun = HPLAI_papanllT;
+        else if (PFACT == HPLAI_CROUT)
+            algo.pffun = HPLAI_papancrT;
+        else if (PFACT == HPLAI_RIGHT_THREADED)
+            algo.pffun = HPLAI_papanthT;
+        else
+            algo.pffun = HPLAI_papanrlT;
+
+        if (RFACT == HPLAI_LEFT_LOOKING)
+            algo.rffun = HPLAI_parpanllT;
+        else if (RFACT == HPLAI_CROUT)
+            algo.rffun = HPLAI_parpancrT;
+        else
+            algo.rffun = HPLAI_parpanrlT;
+        if (PFACT == HPLAI_TOURNAMENT)
+            algo.pffun = algo.rffun = HPLAI_papantpT;
+
+        if (UNOTRAN != 0)
+            algo.upfun = HPLAI_paupdateTN;
+        else
+            algo.upfun = HPLAI_paupdateTT;
+    }
+
+    algo.fswap = FSWAP;
+    algo.fsthr = TSWAP;
+    algo.equil = EQUIL;
+    algo.align = ALIGN;
+    algo.bseg = BSEG;
+    algo.rbt = RBT;
+    algo.mxswp = MXSWP;
+    algo.nopiv = ((NOPIV != 0) || (RBT > 0) ? 1 : 0);
+
+    algo.oper = OPER;
+    if (OPER == HPLAI_OPER_ANALYTIC)
+        algo.opfun = HPLAI_pdoper_analytic;
+    else
+        algo.opfun = HPLAI_pdoper_stored;
+
+    HPLAI_pdtest(TEST, GRID, &algo, N, NB, RES);
+}
+
+static void HPLAI_pdsweep(
+    HPLAI_T_test *TEST,
+    const int N,
+    const int NB,
+    const int NPRS,
+    const HPLAI_T_PREC *PREC,
+    const HPLAI_T_tres *RES)
+{
+    /*
+ * Print the results of one problem for every precision of the factori-
+ * zation side by side
+ */
+    int i;
+
+    HPLAI_fprintf(TEST->outfp, "%s%s\n",
+                  "----------------------------------------",
+                  "----------------------------------------");
+    HPLAI_fprintf(TEST->outfp, "Precision sweep for N = %d, NB = %d\n", N, NB);
+    HPLAI_fprintf(TEST->outfp, "%s%s\n",
+                  "PREC                 Time          Gflops",
+                  "    IR iter          Residual");
+    for (i = 0; i < NPRS; i++)
+    {
+        HPLAI_fprintf(TEST->outfp, "%-8s %12.2f %15.4e %10d",
+                      (PREC[i] == HPLAI_PREC_DOUBLE ? "double" : HPLAI_LFLOAT_NAME),
+                      RES[i].time, RES[i].gflops, RES[i].iter);
+        if (RES[i].resid < HPL_rzero)
+            HPLAI_fprintf(TEST->outfp, "%18s\n", "-");
+        else
+            HPLAI_fprintf(TEST->outfp, "%18.8e %s\n", RES[i].resid,
+                          (RES[i].resid < TEST->thrsh ? "PASSED" : "FAILED"));
+    }
+    HPLAI_fprintf(TEST->outfp, "%s%s\n\n",
+                  "----------------------------------------",
+                  "----------------------------------------");
+}
 
 #ifdef STDC_HEADERS
     int main(
@@ -72,25 +212,62 @@ char **ARGV;
 
         HPLAI_T_TOP topval[HPLAI_MAX_PARAM];
 
+        HPLAI_T_PREC prcval[HPLAI_MAX_PARAM];
+
+        HPLAI_T_tres tres[HPLAI_MAX_PARAM];
+
         HPL_T_grid grid;
-        HPLAI_T_palg algo;
         HPLAI_T_test test;
         int L1notran, Unotran, align, equil, in, inb,
-            inbm, indh, indv, ipfa, ipq, irfa, itop,
+            inbm, indh, indv, ipfa, ipq, iprc, irfa, itop,
             mycol, myrow, ns, nbs, nbms, ndhs, ndvs,
-            npcol, npfs, npqs, nprow, nrfs, ntps,
-            rank, size, tswap;
+            npcol, npfs, npqs, nprow, nprs, nrfs, ntps,
+            ntrace, rank, size, thread, tswap, bseg, nopiv, rbt, mxswp;
+        char *trace;
         HPL_T_ORDER pmapping;
-        HPLAI_T_FACT rpfa;
         HPLAI_T_SWAP fswap;
+        HPLAI_T_OPER oper;
         /* ..
  * .. Executable Statements ..
  */
-        MPI_Init(&ARGC, &ARGV);
+#ifdef HPLAI_PROGRESS_THREAD
+        MPI_Init_thread(&ARGC, &ARGV, MPI_THREAD_MULTIPLE, &thread);
+#else
+        MPI_Init_thread(&ARGC, &ARGV, MPI_THREAD_SERIALIZED, &thread);
+#endif
         MPI_Comm_rank(MPI_COMM_WORLD, &rank);
         MPI_Comm_size(MPI_COMM_WORLD, &size);
         HPLAI_blas_init(rank, size);
         /*
+ * Time the broadcast calls of the main thread if HPLAI_BSTAT is set (they
+ * always are with the progress thread)
+ */
+        (void)HPLAI_bprog_init(thread, (getenv("HPLAI_BSTAT") != NULL));
+        /*
+ * Enable the timeline recorder if HPLAI_TRACE gives a file name prefix,
+ * HPLAI_TRACE_EVENTS overrides the number of events kept per process
+ */
+        trace = getenv("HPLAI_TRACE");
+        ntrace = HPLAI_TRACE_SIZE;
+        if (getenv("HPLAI_TRACE_EVENTS") != NULL)
+            ntrace = atoi(getenv("HPLAI_TRACE_EVENTS"));
+        (void)HPLAI_trace_init(trace, ntrace);
+        /*
+ * Report the progress of the factorizations every HPLAI_PROGRESS seconds,
+ * to stdout or to the file HPLAI_PROGRESS_FILE
+ */
+        if (getenv("HPLAI_PROGRESS") != NULL)
+            (void)HPLAI_progress_init(atof(getenv("HPLAI_PROGRESS")),
+                                      getenv("HPLAI_PROGRESS_FILE"));
+        /*
+ * Map the grid collectives onto the MPI collectives if HPLAI_COLL is mpi,
+ * HPLAI_COLL_LONG overrides the all-reduce reduce-scatter threshold
+ */
+        if ((getenv("HPLAI_COLL") != NULL) &&
+            (strcmp(getenv("HPLAI_COLL"), "mpi") == 0))
+            HPL_coll_set(HPL_COLL_MPI, (getenv("HPLAI_COLL_LONG") != NULL ?
+                                            atoi(getenv("HPLAI_COLL_LONG")) : 0));
+        /*
  * Read and check validity of test parameters from input file
  *
  * HPL Version 1.0, Linpack benchmark input file
@@ -107,7 +284,7 @@ char **ARGV;
  * 2 4 1        Qs
  * 16.0         threshold
  * 3            # of panel fact
- * 0 1 2        PFACTs (0=left, 1=Crout, 2=Right)
+ * 0 1 2        PFACTs (0=left, 1=Crout, 2=Right, 3=Tournament, 4=Right+OpenMP)
  * 2            # of recursive stopping criterium
  * 2 4          NBMINs (>= 1)
  * 1            # of panels in recursion
@@ -115,20 +292,27 @@ char **ARGV;
  * 3            # of recursive panel fact.
  * 0 1 2        RFACTs (0=left, 1=Crout, 2=Right)
  * 1            # of broadcast
- * 0            BCASTs (0=1rg,1=1rM,2=2rg,3=2rM,4=Lng,5=LnM)
+ * 0            BCASTs (0=1rg,1=1rM,2=2rg,3=2rM,4=Lng,5=LnM,6=Ibc,7=1rS,8=Hie,9=HSm)
  * 1            # of lookahead depth
- * 0            DEPTHs (>=0)
+ * 0            DEPTHs (>=-1)
  * 2            SWAP (0=bin-exch,1=long,2=mix)
  * 4            swapping threshold
  * 0            L1 in (0=transposed,1=no-transposed) form
  * 0            U  in (0=transposed,1=no-transposed) form
  * 1            Equilibration (0=no,1=yes)
  * 8            memory alignment in double (> 0)
+ * 0            refinement operator (0=stored,1=analytic), optional
+ * 1            # of precisions, optional
+ * 0            PRECs (0=float or HPLAI_T_LFLOAT,1=double), optional
+ * 65536        BSEG segment length of BCAST 7 (> 0), optional
+ * 0            NOPIV (0=partial pivoting,1=no pivoting), optional
+ * 0            RBT depth of the random butterfly transform (0..2), optional
+ * 0            MXSWP (0=bin-exch,1=allreduce), optional
  */
         HPLAI_pdinfo(&test, &ns, nval, &nbs, nbval, &pmapping, &npqs, pval, qval,
                      &npfs, pfaval, &nbms, nbmval, &ndvs, ndvval, &nrfs, rfaval,
                      &ntps, topval, &ndhs, ndhval, &fswap, &tswap, &L1notran,
-                     &Unotran, &equil, &align);
+                     &Unotran, &equil, &align, &oper, &nprs, prcval, &bseg, &nopiv, &rbt, &mxswp);
         /*
  * Loop over different process grids - Define process grid. Go to bottom
  * of process grid loop if this case does not use my process.
@@ -160,66 +344,31 @@ char **ARGV;
                                         for (indv = 0; indv < ndvs; indv++)
                                         { /* Loop over various # of panels in recursion */
                                             /*
- * Set up the algorithm parameters
+ * Loop over various precisions of the factorization
  */
-                                            algo.btopo = topval[itop];
-                                            algo.depth = ndhval[indh];
-                                            algo.nbmin = nbmval[inbm];
-                                            algo.nbdiv = ndvval[indv];
-
-                                            algo.pfact = rpfa = pfaval[ipfa];
-
-                                            if (L1notran != 0)
+                                            for (iprc = 0; iprc < nprs; iprc++)
                                             {
-                                                if (rpfa == HPLAI_LEFT_LOOKING)
-                                                    algo.pffun = HPLAI_papanllN;
-                                                else if (rpfa == HPLAI_CROUT)
-                                                    algo.pffun = HPLAI_papancrN;
-                                                else
-                                                    algo.pffun = HPLAI_papanrlN;
-
-                                                algo.rfact = rpfa = rfaval[irfa];
-                                                if (rpfa == HPLAI_LEFT_LOOKING)
-                                                    algo.rffun = HPLAI_parpanllN;
-                                                else if (rpfa == HPLAI_CROUT)
-                                                    algo.rffun = HPLAI_parpancrN;
-                                                else
-                                                    algo.rffun = HPLAI_parpanrlN;
-
-                                                if (Unotran != 0)
-                                                    algo.upfun = HPLAI_paupdateNN;
+                                                if (prcval[iprc] == HPLAI_PREC_DOUBLE)
+                                                    HPLAI_pdrun<double>(
+                                                        &test, &grid, nval[in], nbval[inb],
+                                                        topval[itop], ndhval[indh], nbmval[inbm],
+                                                        ndvval[indv], pfaval[ipfa], rfaval[irfa],
+                                                        L1notran, Unotran, fswap, tswap, equil,
+                                                        align, oper, bseg, nopiv, rbt, mxswp, &tres[iprc]);
                                                 else
-                                                    algo.upfun = HPLAI_paupdateNT;
+                                                    HPLAI_pdrun<HPLAI_T_LFLOAT>(
+                                                        &test, &grid, nval[in], nbval[inb],
+                                                        topval[itop], ndhval[indh], nbmval[inbm],
+                                                        ndvval[indv], pfaval[ipfa], rfaval[irfa],
+                                                        L1notran, Unotran, fswap, tswap, equil,
+                                                        align, oper, bseg, nopiv, rbt, mxswp, &tres[iprc]);
                                             }
-                                            else
-                                            {
-                                                if (rpfa == HPLAI_LEFT_LOOKING)
-                                                    algo.pffun = HPLAI_papanllT;
-                                                else if (rpfa == HPLAI_CROUT)
-                                                    algo.pffun = HPLAI_papancrT;
-                                                else
-                                                    algo.pffun = HPLAI_papanrlT;
-
-                                                algo.rfact = rpfa = rfaval[irfa];
-                                                if (rpfa == HPLAI_LEFT_LOOKING)
-                                                    algo.rffun = HPLAI_parpanllT;
-                                                else if (rpfa == HPLAI_CROUT)
-                                                    algo.rffun = HPLAI_parpancrT;
-                                                else
-                                                    algo.rffun = HPLAI_parpanrlT;
-
-                                                if (Unotran != 0)
-                                                    algo.upfun = HPLAI_paupdateTN;
-                                                else
-                                                    algo.upfun = HPLAI_paupdateTT;
-                                            }
-
-                                            algo.fswap = fswap;
-                                            algo.fsthr = tswap;
-                                            algo.equil = equil;
-                                            algo.align = align;
-
-                                            HPLAI_pdtest(&test, &grid, &algo, nval[in], nbval[inb]);
+                                            /*
+ * Print the precisions side by side
+ */
+                                            if ((nprs > 1) && (myrow == 0) && (mycol == 0))
+                                                HPLAI_pdsweep(&test, nval[in], nbval[inb],
+                                                              nprs, prcval, tres);
                                         }
                                     }
                                 }
@@ -242,7 +391,7 @@ char **ARGV;
                           "========================================",
                           "========================================");
 #else
-        if (test.thrsh > HPLAI_rzero)
+        if (test.thrsh > HPL_rzero)
             HPLAI_fprintf(test.outfp, "%s%s\n",
                           "========================================",
                           "========================================");
@@ -250,7 +399,7 @@ char **ARGV;
 
             HPLAI_fprintf(test.outfp, "\n%s %6d %s\n", "Finished", test.ktest,
                           "tests with the following results:");
-            if (test.thrsh > HPLAI_rzero)
+            if (test.thrsh > HPL_rzero)
             {
                 HPLAI_fprintf(test.outfp, "         %6d %s\n", test.kpass,
                               "tests completed and passed residual checks,");
@@ -278,6 +427,9 @@ char **ARGV;
             if ((test.outfp != stdout) && (test.outfp != stderr))
                 (void)fclose(test.outfp);
         }
+        HPLAI_progress_finalize();
+        HPLAI_trace_finalize();
+        HPLAI_bprog_finalize();
         HPLAI_blas_finalize();
         MPI_Finalize();
         exit(0);
@@ -287,7 +439,3 @@ char **ARGV;
  * End of main
  */
     }
-
-#ifdef __cplusplus
-}
-#endif
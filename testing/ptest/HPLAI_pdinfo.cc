@@ -26,11 +26,6 @@
  */
 #include "hplai.hh"
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
 #ifdef STDC_HEADERS
     void HPLAI_pdinfo(
         HPLAI_T_test *TEST,
@@ -59,9 +54,16 @@ extern "C"
         int *L1NOTRAN,
         int *UNOTRAN,
         int *EQUIL,
-        int *ALIGN)
+        int *ALIGN,
+        HPLAI_T_OPER *OPER,
+        int *NPRS,
+        HPLAI_T_PREC *PREC,
+        int *BSEG,
+        int *NOPIV,
+        int *RBT,
+        int *MXSWP)
 #else
-void HPLAI_pdinfo(TEST, NS, N, NBS, NB, PMAPPIN, NPQS, P, Q, NPFS, PF, NBMS, NBM, NDVS, NDV, NRFS, RF, NTPS, TP, NDHS, DH, FSWAP, TSWAP, L1NOTRAN, UNOTRAN, EQUIL, ALIGN)
+void HPLAI_pdinfo(TEST, NS, N, NBS, NB, PMAPPIN, NPQS, P, Q, NPFS, PF, NBMS, NBM, NDVS, NDV, NRFS, RF, NTPS, TP, NDHS, DH, FSWAP, TSWAP, L1NOTRAN, UNOTRAN, EQUIL, ALIGN, OPER, NPRS, PREC, BSEG, NOPIV, RBT, MXSWP)
     HPLAI_T_test *TEST;
 int *NS;
 int *N;
@@ -89,6 +91,13 @@ int *L1NOTRAN;
 int *UNOTRAN;
 int *EQUIL;
 int *ALIGN;
+HPLAI_T_OPER *OPER;
+int *NPRS;
+HPLAI_T_PREC *PREC;
+int *BSEG;
+int *NOPIV;
+int *RBT;
+int *MXSWP;
 #endif
     {
         /* 
@@ -201,7 +210,11 @@ int *ALIGN;
  * TP      (global output)               HPLAI_T_TOP *
  *         On entry, TP is an array of dimension HPLAI_MAX_PARAM. On exit,
  *         the  first NTPS  entries of this  array  contain  the various
- *         broadcast (along rows) topologies to run the code with.
+ *         broadcast (along rows) topologies to run the code with: the
+ *         six HPL ones (0..5), MPI_Ibcast (6, HPLAI_IBCAST), the seg-
+ *         mented increasing ring  (7, HPLAI_1RING_S),  the node-aware
+ *         two-level tree  (8, HPLAI_HIER)  or the same tree with a panel
+ *         shared by the processes of a node (9, HPLAI_HIER_SHM).
  *
  * NDHS    (global output)               int *
  *         On exit, NDHS  specifies the  number of different values that
@@ -212,7 +225,8 @@ int *ALIGN;
  *         On entry,  DH  is  an array of  dimension  HPLAI_MAX_PARAM.  On
  *         exit, the first NDHS entries of this array contain the values
  *         of lookahead depths to run the code with.  Such a value is at
- *         least 0 (no-lookahead) or greater than zero.
+ *         least 0 (no-lookahead) or greater than zero,  or -1 for the
+ *         dynamic lookahead of the task graph driver (HPLAI_pagesvT).
  *
  * FSWAP   (global output)               HPLAI_T_SWAP *
  *         On exit, FSWAP specifies the swapping algorithm to be used in
@@ -239,9 +253,49 @@ int *ALIGN;
  *
  * ALIGN   (global output)               int *
  *         On exit,  ALIGN  specifies the alignment  of  the dynamically
- *         allocated buffers in HPLAI_T_AFLOAT precision words. ALIGN is greater
+ *         allocated buffers in working precision words.  ALIGN is greater
  *         than zero.
  *
+ * OPER    (global output)               HPLAI_T_OPER *
+ *         On exit,  OPER  specifies how the iterative refinement applies
+ *         the matrix: with the stored double matrix (HPLAI_OPER_STORED)
+ *         or matrix-free from the generator formula (HPLAI_OPER_ANALYTIC).
+ *         This line of HPL.dat is optional, it defaults to stored.
+ *
+ * NPRS    (global output)               int *
+ *         On exit, NPRS  specifies the  number of different precisions
+ *         the factorization is  done in.  NPRS must be at least one and
+ *         less than or equal to HPLAI_MAX_PARAM.
+ *
+ * PREC    (global output)               HPLAI_T_PREC *
+ *         On entry, PREC is an array of dimension HPLAI_MAX_PARAM.  On
+ *         exit, the first NPRS entries of this array contain the preci-
+ *         sions of the factorization (HPLAI_PREC_LFLOAT or HPLAI_PREC_
+ *         DOUBLE). These two lines of HPL.dat are optional, they default
+ *         to one factorization in HPLAI_T_LFLOAT.
+ *
+ * BSEG    (global output)               int *
+ *         On exit,  BSEG  specifies the length in entries of the segments
+ *         of the segmented ring broadcast  (HPLAI_1RING_S).  This line of
+ *         HPL.dat is optional, it defaults to HPLAI_BSEG_DEFAULT.
+ *
+ * NOPIV   (global output)               int *
+ *         On exit,  NOPIV  specifies  whether the panels are factored
+ *         without pivoting (1) or with partial pivoting (0),  see HPLAI_
+ *         panopiv. This line of HPL.dat is optional, it defaults to 0.
+ *
+ * RBT     (global output)               int *
+ *         On exit,  RBT  specifies the depth (0, 1 or 2) of the random
+ *         butterfly transformation applied to  A  before a factorization
+ *         without pivoting,  see HPLAI_parbt.  0 disables it.  This line
+ *         of HPL.dat is optional, it defaults to 0.
+ *
+ * MXSWP   (global output)               int *
+ *         On exit,  MXSWP  specifies how the pivot row is found and ex-
+ *         changed in the process column: binary exchange (0),  or  one
+ *         MPI_Allreduce with a user-defined operation (1),  see  HPLAI_
+ *         pamxswp. This line of HPL.dat is optional, it defaults to 0.
+ *
  * ---------------------------------------------------------------------
  */
         /*
@@ -460,6 +514,10 @@ int *ALIGN;
                     PF[i] = HPLAI_CROUT;
                 else if (j == 2)
                     PF[i] = HPLAI_RIGHT_LOOKING;
+                else if (j == 3)
+                    PF[i] = HPLAI_TOURNAMENT;
+                else if (j == 4)
+                    PF[i] = HPLAI_RIGHT_THREADED;
                 else
                     PF[i] = HPLAI_RIGHT_LOOKING;
             }
@@ -582,11 +640,19 @@ int *ALIGN;
                     TP[i] = HPLAI_BLONG;
                 else if (j == 5)
                     TP[i] = HPLAI_BLONG_M;
+                else if (j == 6)
+                    TP[i] = HPLAI_IBCAST;
+                else if (j == 7)
+                    TP[i] = HPLAI_1RING_S;
+                else if (j == 8)
+                    TP[i] = HPLAI_HIER;
+                else if (j == 9)
+                    TP[i] = HPLAI_HIER_SHM;
                 else
                     TP[i] = HPLAI_1RING_M;
             }
             /*
- * Lookahead depth (>=0) (NDH)
+ * Lookahead depth (>=-1) (NDH)
  */
             (void)fgets(line, HPLAI_LINE_MAX - 2, infp);
             (void)sscanf(line, "%s", num);
@@ -605,10 +671,10 @@ int *ALIGN;
             {
                 (void)sscanf(lineptr, "%s", num);
                 lineptr += strlen(num) + 1;
-                if ((DH[i] = atoi(num)) < 0)
+                if ((DH[i] = atoi(num)) < HPLAI_DEPTH_DYNAMIC)
                 {
                     HPLAI_pwarn(stderr, __LINE__, "HPLAI_pdinfo",
-                                "Value of DEPTH less than 0");
+                                "Value of DEPTH less than -1");
                     error = 1;
                     goto label_error;
                 }
@@ -667,6 +733,79 @@ int *ALIGN;
             *ALIGN = atoi(num);
             if (*ALIGN <= 0)
                 *ALIGN = 4;
+            /*
+ * Refinement operator (0=stored,1=analytic), optional
+ */
+            *OPER = HPLAI_OPER_STORED;
+            if (fgets(line, HPLAI_LINE_MAX - 2, infp) != NULL)
+            {
+                (void)sscanf(line, "%s", num);
+                if (atoi(num) == 1)
+                    *OPER = HPLAI_OPER_ANALYTIC;
+            }
+            /*
+ * Precisions of the factorization (0=HPLAI_T_LFLOAT,1=double), optional
+ */
+            *NPRS = 1;
+            PREC[0] = HPLAI_PREC_LFLOAT;
+            if (fgets(line, HPLAI_LINE_MAX - 2, infp) != NULL)
+            {
+                (void)sscanf(line, "%s", num);
+                *NPRS = atoi(num);
+                if ((*NPRS < 1) || (*NPRS > HPLAI_MAX_PARAM))
+                {
+                    HPLAI_pwarn(stderr, __LINE__, "HPLAI_pdinfo", "%s %s %d",
+                                "Number of values of PREC",
+                                "is less than 1 or greater than", HPLAI_MAX_PARAM);
+                    error = 1;
+                    goto label_error;
+                }
+                (void)fgets(line, HPLAI_LINE_MAX - 2, infp);
+                lineptr = line;
+                for (i = 0; i < *NPRS; i++)
+                {
+                    (void)sscanf(lineptr, "%s", num);
+                    lineptr += strlen(num) + 1;
+                    PREC[i] = (atoi(num) == 1 ? HPLAI_PREC_DOUBLE : HPLAI_PREC_LFLOAT);
+                }
+            }
+            /*
+ * Segment length of the segmented ring broadcast (> 0), optional
+ */
+            *BSEG = HPLAI_BSEG_DEFAULT;
+            if (fgets(line, HPLAI_LINE_MAX - 2, infp) != NULL)
+            {
+                (void)sscanf(line, "%s", num);
+                if (atoi(num) > 0)
+                    *BSEG = atoi(num);
+            }
+            /*
+ * No pivoting mode (0 or 1), optional
+ */
+            *NOPIV = 0;
+            if (fgets(line, HPLAI_LINE_MAX - 2, infp) != NULL)
+            {
+                (void)sscanf(line, "%s", num);
+                *NOPIV = (atoi(num) != 0 ? 1 : 0);
+            }
+            /*
+ * Depth of the random butterfly transformation (0..2), optional
+ */
+            *RBT = 0;
+            if (fgets(line, HPLAI_LINE_MAX - 2, infp) != NULL)
+            {
+                (void)sscanf(line, "%s", num);
+                *RBT = Mmax(0, Mmin(2, atoi(num)));
+            }
+            /*
+ * Pivot row exchange (0=bin-exch,1=allreduce), optional
+ */
+            *MXSWP = 0;
+            if (fgets(line, HPLAI_LINE_MAX - 2, infp) != NULL)
+            {
+                (void)sscanf(line, "%s", num);
+                *MXSWP = (atoi(num) != 0 ? 1 : 0);
+            }
         /*
  * Close input file
  */
@@ -705,7 +844,7 @@ int *ALIGN;
         /*
  * Broadcast array sizes
  */
-        iwork = (int *)malloc((size_t)(15) * sizeof(int));
+        iwork = (int *)malloc((size_t)(21) * sizeof(int));
         if (rank == 0)
         {
             iwork[0] = *NS;
@@ -723,8 +862,14 @@ int *ALIGN;
             iwork[12] = *UNOTRAN;
             iwork[13] = *EQUIL;
             iwork[14] = *ALIGN;
+            iwork[15] = (*OPER == HPLAI_OPER_ANALYTIC ? 1 : 0);
+            iwork[16] = *NPRS;
+            iwork[17] = *BSEG;
+            iwork[18] = *NOPIV;
+            iwork[19] = *RBT;
+            iwork[20] = *MXSWP;
         }
-        (void)HPL_broadcast((void *)iwork, 15, HPL_INT, 0, MPI_COMM_WORLD);
+        (void)HPL_broadcast((void *)iwork, 21, HPL_INT, 0, MPI_COMM_WORLD);
         if (rank != 0)
         {
             *NS = iwork[0];
@@ -742,6 +887,12 @@ int *ALIGN;
             *UNOTRAN = iwork[12];
             *EQUIL = iwork[13];
             *ALIGN = iwork[14];
+            *OPER = (iwork[15] == 1 ? HPLAI_OPER_ANALYTIC : HPLAI_OPER_STORED);
+            *NPRS = iwork[16];
+            *BSEG = iwork[17];
+            *NOPIV = iwork[18];
+            *RBT = iwork[19];
+            *MXSWP = iwork[20];
         }
         if (iwork)
             free(iwork);
@@ -749,7 +900,7 @@ int *ALIGN;
  * Pack information arrays and broadcast
  */
         lwork = (*NS) + (*NBS) + 2 * (*NPQS) + (*NPFS) + (*NBMS) +
-                (*NDVS) + (*NRFS) + (*NTPS) + (*NDHS) + 1;
+                (*NDVS) + (*NRFS) + (*NTPS) + (*NDHS) + (*NPRS) + 1;
         iwork = (int *)malloc((size_t)(lwork) * sizeof(int));
         if (rank == 0)
         {
@@ -782,6 +933,10 @@ int *ALIGN;
                     iwork[j] = 1;
                 else if (PF[i] == HPLAI_RIGHT_LOOKING)
                     iwork[j] = 2;
+                else if (PF[i] == HPLAI_TOURNAMENT)
+                    iwork[j] = 3;
+                else if (PF[i] == HPLAI_RIGHT_THREADED)
+                    iwork[j] = 4;
                 j++;
             }
             for (i = 0; i < *NBMS; i++)
@@ -818,6 +973,14 @@ int *ALIGN;
                     iwork[j] = 4;
                 else if (TP[i] == HPLAI_BLONG_M)
                     iwork[j] = 5;
+                else if (TP[i] == HPLAI_IBCAST)
+                    iwork[j] = 6;
+                else if (TP[i] == HPLAI_1RING_S)
+                    iwork[j] = 7;
+                else if (TP[i] == HPLAI_HIER)
+                    iwork[j] = 8;
+                else if (TP[i] == HPLAI_HIER_SHM)
+                    iwork[j] = 9;
                 j++;
             }
             for (i = 0; i < *NDHS; i++)
@@ -825,6 +988,11 @@ int *ALIGN;
                 iwork[j] = DH[i];
                 j++;
             }
+            for (i = 0; i < *NPRS; i++)
+            {
+                iwork[j] = (PREC[i] == HPLAI_PREC_DOUBLE ? 1 : 0);
+                j++;
+            }
 
             if (*FSWAP == HPLAI_SWAP00)
                 iwork[j] = 0;
@@ -868,6 +1036,10 @@ int *ALIGN;
                     PF[i] = HPLAI_CROUT;
                 else if (iwork[j] == 2)
                     PF[i] = HPLAI_RIGHT_LOOKING;
+                else if (iwork[j] == 3)
+                    PF[i] = HPLAI_TOURNAMENT;
+                else if (iwork[j] == 4)
+                    PF[i] = HPLAI_RIGHT_THREADED;
                 j++;
             }
             for (i = 0; i < *NBMS; i++)
@@ -904,6 +1076,14 @@ int *ALIGN;
                     TP[i] = HPLAI_BLONG;
                 else if (iwork[j] == 5)
                     TP[i] = HPLAI_BLONG_M;
+                else if (iwork[j] == 6)
+                    TP[i] = HPLAI_IBCAST;
+                else if (iwork[j] == 7)
+                    TP[i] = HPLAI_1RING_S;
+                else if (iwork[j] == 8)
+                    TP[i] = HPLAI_HIER;
+                else if (iwork[j] == 9)
+                    TP[i] = HPLAI_HIER_SHM;
                 j++;
             }
             for (i = 0; i < *NDHS; i++)
@@ -911,6 +1091,11 @@ int *ALIGN;
                 DH[i] = iwork[j];
                 j++;
             }
+            for (i = 0; i < *NPRS; i++)
+            {
+                PREC[i] = (iwork[j] == 1 ? HPLAI_PREC_DOUBLE : HPLAI_PREC_LFLOAT);
+                j++;
+            }
 
             if (iwork[j] == 0)
                 *FSWAP = HPLAI_SWAP00;
@@ -1047,6 +1232,10 @@ int *ALIGN;
                     HPLAI_fprintf(TEST->outfp, "   Crout ");
                 else if (PF[i] == HPLAI_RIGHT_LOOKING)
                     HPLAI_fprintf(TEST->outfp, "   Right ");
+                else if (PF[i] == HPLAI_TOURNAMENT)
+                    HPLAI_fprintf(TEST->outfp, "   Tourn ");
+                else if (PF[i] == HPLAI_RIGHT_THREADED)
+                    HPLAI_fprintf(TEST->outfp, "  RightT ");
             }
             if (*NPFS > 8)
             {
@@ -1059,6 +1248,10 @@ int *ALIGN;
                         HPLAI_fprintf(TEST->outfp, "   Crout ");
                     else if (PF[i] == HPLAI_RIGHT_LOOKING)
                         HPLAI_fprintf(TEST->outfp, "   Right ");
+                    else if (PF[i] == HPLAI_TOURNAMENT)
+                        HPLAI_fprintf(TEST->outfp, "   Tourn ");
+                    else if (PF[i] == HPLAI_RIGHT_THREADED)
+                        HPLAI_fprintf(TEST->outfp, "  RightT ");
                 }
                 if (*NPFS > 16)
                 {
@@ -1071,6 +1264,10 @@ int *ALIGN;
                             HPLAI_fprintf(TEST->outfp, "   Crout ");
                         else if (PF[i] == HPLAI_RIGHT_LOOKING)
                             HPLAI_fprintf(TEST->outfp, "   Right ");
+                        else if (PF[i] == HPLAI_TOURNAMENT)
+                            HPLAI_fprintf(TEST->outfp, "   Tourn ");
+                        else if (PF[i] == HPLAI_RIGHT_THREADED)
+                            HPLAI_fprintf(TEST->outfp, "  RightT ");
                     }
                 }
             }
@@ -1167,6 +1364,14 @@ int *ALIGN;
                     HPLAI_fprintf(TEST->outfp, "   Blong ");
                 else if (TP[i] == HPLAI_BLONG_M)
                     HPLAI_fprintf(TEST->outfp, "  BlongM ");
+                else if (TP[i] == HPLAI_IBCAST)
+                    HPLAI_fprintf(TEST->outfp, "  Ibcast ");
+                else if (TP[i] == HPLAI_1RING_S)
+                    HPLAI_fprintf(TEST->outfp, "  1ringS ");
+                else if (TP[i] == HPLAI_HIER)
+                    HPLAI_fprintf(TEST->outfp, "    Hier ");
+                else if (TP[i] == HPLAI_HIER_SHM)
+                    HPLAI_fprintf(TEST->outfp, "    HShm ");
             }
             if (*NTPS > 8)
             {
@@ -1185,6 +1390,14 @@ int *ALIGN;
                         HPLAI_fprintf(TEST->outfp, "   Blong ");
                     else if (TP[i] == HPLAI_BLONG_M)
                         HPLAI_fprintf(TEST->outfp, "  BlongM ");
+                    else if (TP[i] == HPLAI_IBCAST)
+                        HPLAI_fprintf(TEST->outfp, "  Ibcast ");
+                    else if (TP[i] == HPLAI_1RING_S)
+                        HPLAI_fprintf(TEST->outfp, "  1ringS ");
+                    else if (TP[i] == HPLAI_HIER)
+                        HPLAI_fprintf(TEST->outfp, "    Hier ");
+                    else if (TP[i] == HPLAI_HIER_SHM)
+                        HPLAI_fprintf(TEST->outfp, "    HShm ");
                 }
                 if (*NTPS > 16)
                 {
@@ -1203,10 +1416,23 @@ int *ALIGN;
                             HPLAI_fprintf(TEST->outfp, "   Blong ");
                         else if (TP[i] == HPLAI_BLONG_M)
                             HPLAI_fprintf(TEST->outfp, "  BlongM ");
+                        else if (TP[i] == HPLAI_IBCAST)
+                            HPLAI_fprintf(TEST->outfp, "  Ibcast ");
+                        else if (TP[i] == HPLAI_1RING_S)
+                            HPLAI_fprintf(TEST->outfp, "  1ringS ");
+                        else if (TP[i] == HPLAI_HIER)
+                            HPLAI_fprintf(TEST->outfp, "    Hier ");
+                        else if (TP[i] == HPLAI_HIER_SHM)
+                            HPLAI_fprintf(TEST->outfp, "    HShm ");
                     }
                 }
             }
             /*
+ * Segment length of the segmented ring broadcast
+ */
+            HPLAI_fprintf(TEST->outfp, "\nBSEG   : %d working precision words",
+                          *BSEG);
+            /*
  * Lookahead depths
  */
             HPLAI_fprintf(TEST->outfp, "\nDEPTH  :");
@@ -1235,6 +1461,30 @@ int *ALIGN;
             else if (*FSWAP == HPLAI_SW_MIX)
                 HPLAI_fprintf(TEST->outfp, " Mix (threshold = %d)", *TSWAP);
             /*
+ * Pivoting
+ */
+            HPLAI_fprintf(TEST->outfp, "\nNOPIV  :");
+            if (*NOPIV != 0)
+                HPLAI_fprintf(TEST->outfp, " no pivoting (partial pivoting fallback)");
+            else
+                HPLAI_fprintf(TEST->outfp, " partial pivoting");
+            /*
+ * Random butterfly transformation
+ */
+            HPLAI_fprintf(TEST->outfp, "\nRBT    :");
+            if (*RBT > 0)
+                HPLAI_fprintf(TEST->outfp, " depth %d (no pivoting)", *RBT);
+            else
+                HPLAI_fprintf(TEST->outfp, " none");
+            /*
+ * Pivot row exchange
+ */
+            HPLAI_fprintf(TEST->outfp, "\nMXSWP  :");
+            if (*MXSWP != 0)
+                HPLAI_fprintf(TEST->outfp, " MPI_Allreduce (user-defined op)");
+            else
+                HPLAI_fprintf(TEST->outfp, " Binary-exchange");
+            /*
  * L1 storage form
  */
             HPLAI_fprintf(TEST->outfp, "\nL1     :");
@@ -1261,14 +1511,41 @@ int *ALIGN;
             /*
  * Alignment
  */
-            HPLAI_fprintf(TEST->outfp, "\nALIGN  : %d HPLAI_T_AFLOAT precision words",
+            HPLAI_fprintf(TEST->outfp, "\nALIGN  : %d working precision words",
                           *ALIGN);
+            /*
+ * Refinement operator
+ */
+            HPLAI_fprintf(TEST->outfp, "\nOPER   :");
+            if (*OPER == HPLAI_OPER_ANALYTIC)
+                HPLAI_fprintf(TEST->outfp, " analytic (matrix-free)");
+            else
+                HPLAI_fprintf(TEST->outfp, " stored");
+            /*
+ * Grid collectives backend
+ */
+            HPLAI_fprintf(TEST->outfp, "\nCOLL   :");
+            if (HPL_coll_get(&i) == HPL_COLL_MPI)
+                HPLAI_fprintf(TEST->outfp, " MPI (reduce-scatter from %d)", i);
+            else
+                HPLAI_fprintf(TEST->outfp, " binomial trees");
+            /*
+ * Precisions of the factorization
+ */
+            HPLAI_fprintf(TEST->outfp, "\nPREC   :");
+            for (i = 0; i < *NPRS; i++)
+            {
+                if (i > 0 && i % 8 == 0)
+                    HPLAI_fprintf(TEST->outfp, "\n        ");
+                HPLAI_fprintf(TEST->outfp, "%8s ",
+                              (PREC[i] == HPLAI_PREC_DOUBLE ? "double" : HPLAI_LFLOAT_NAME));
+            }
 
             HPLAI_fprintf(TEST->outfp, "\n\n");
             /*
  * For testing only
  */
-            if (TEST->thrsh > HPLAI_rzero)
+            if (TEST->thrsh > HPL_rzero)
             {
                 HPLAI_fprintf(TEST->outfp, "%s%s\n\n",
                               "----------------------------------------",
@@ -1291,7 +1568,3 @@ int *ALIGN;
  * End of HPLAI_pdinfo
  */
     }
-
-#ifdef __cplusplus
-}
-#endif
@@ -25,26 +25,25 @@
  * Include files
  */
 #include "hplai.hh"
+#include <sys/resource.h>
 
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
+    template <typename HPLAI_T_AFLOAT>
 #ifdef STDC_HEADERS
     void HPLAI_pdtest(
         HPLAI_T_test *TEST,
         HPL_T_grid *GRID,
         HPLAI_T_palg *ALGO,
         const int N,
-        const int NB)
+        const int NB,
+        HPLAI_T_tres *RES)
 #else
-void HPLAI_pdtest(TEST, GRID, ALGO, N, NB)
+void HPLAI_pdtest(TEST, GRID, ALGO, N, NB, RES)
     HPLAI_T_test *TEST;
 HPL_T_grid *GRID;
 HPLAI_T_palg *ALGO;
 const int N;
 const int NB;
+HPLAI_T_tres *RES;
 #endif
     {
 /* 
@@ -55,7 +54,8 @@ const int NB;
  * process grid, the  problem size, the distribution blocking factor ...
  * This function generates  the data, calls  and times the linear system
  * solver,  checks  the  accuracy  of the  obtained vector solution  and
- * writes this information to the file pointed to by TEST->outfp.
+ * writes this information to the file pointed to by TEST->outfp.  The
+ * factorization is done in HPLAI_T_AFLOAT.
  *
  * Arguments
  * =========
@@ -93,6 +93,12 @@ const int NB;
  *         On entry,  NB specifies the blocking factor used to partition
  *         and distribute the matrix A. NB must be larger than one.
  *
+ * RES     (global output)               HPLAI_T_tres *
+ *         On exit, RES contains the wall time and Gflops of the solve,
+ *         the number of  GMRES  iterations of the refinement  and  the
+ *         scaled residual, which is negative when it is not checked.
+ *         The time and Gflops are only defined in process (0,0).
+ *
  * ---------------------------------------------------------------------
  */
 /*
@@ -102,21 +108,29 @@ const int NB;
         double HPL_w[HPL_TIMING_N];
 #endif
         HPL_T_pmat mat;
-        double wtime[1];
+        HPLAI_T_pwstat pwstat;
+        HPLAI_T_bstat bstat;
+        double wtime[1], gtime[1], rss[1], wbuf[5], bbuf[2];
+        struct rusage usage;
         int info[3];
         double Anorm1, AnormI, Gflops, Xnorm1, XnormI,
             BnormI, resid0, resid1;
         double *Bptr;
         void *vptr = NULL;
         static int first = 1;
-        int ii, ip2, mycol, myrow, npcol, nprow, nq;
-        char ctop, cpfact, crfact;
+        int ii, ip2, iter, mycol, myrow, npcol, nprow, nq;
+        char cdepth[16], ctop, cpfact, crfact;
         time_t current_time_start, current_time_end;
         /* ..
  * .. Executable Statements ..
  */
         (void)HPL_grid_info(GRID, &nprow, &npcol, &myrow, &mycol);
 
+        RES->time = HPL_rzero;
+        RES->gflops = HPL_rzero;
+        RES->resid = -HPL_rone;
+        RES->iter = 0;
+
         mat.n = N;
         mat.nb = NB;
         mat.info = 0;
@@ -172,7 +186,17 @@ const int NB;
         mat.A = (double *)HPL_PTR(vptr,
                                   ((size_t)(ALGO->align) * sizeof(double)));
         mat.X = Mptr(mat.A, 0, mat.nq, mat.ld);
+#ifdef HPLAI_PMAT_DIRECT
+        /*
+ * HPLAI_pdgesv generates the matrix  in low precision itself,  the pages
+ * of mat.A are not touched before the refinement.
+ */
+        gtime[0] = HPL_rzero;
+#else
+        gtime[0] = HPL_ptimer_walltime();
         HPLAI_pdmatgen(GRID, N, N + 1, NB, mat.A, mat.ld, HPL_ISEED);
+        gtime[0] = HPL_ptimer_walltime() - gtime[0];
+#endif
 #ifdef HPL_CALL_VSIPL
         mat.block = vsip_blockbind_d((vsip_scalar_d *)(mat.A),
                                      (vsip_length)(mat.ld * mat.nq),
@@ -184,8 +208,10 @@ const int NB;
         HPL_ptimer_boot();
         (void)HPL_barrier(GRID->all_comm);
         time(&current_time_start);
+        HPLAI_papanel_wstat(&pwstat);
+        HPLAI_bprog_stat(&bstat);
         HPL_ptimer(0);
-        HPLAI_pdgesv(GRID, ALGO, &mat);
+        iter = HPLAI_pdgesv(GRID, ALGO, &mat);
         HPL_ptimer(0);
         time(&current_time_end);
 #ifdef HPL_CALL_VSIPL
@@ -197,6 +223,15 @@ const int NB;
  */
         HPL_ptimer_combine(GRID->all_comm, HPL_AMAX_PTIME, HPL_WALL_PTIME,
                            1, 0, wtime);
+        (void)HPL_reduce((void *)(gtime), 1, HPL_DOUBLE, HPL_max, 0,
+                         GRID->all_comm);
+        /*
+ * Peak resident set size of the processes so far (ru_maxrss is in KB)
+ */
+        (void)getrusage(RUSAGE_SELF, &usage);
+        rss[0] = (double)(usage.ru_maxrss) / 1024.0;
+        (void)HPL_reduce((void *)(rss), 1, HPL_DOUBLE, HPL_max, 0,
+                         GRID->all_comm);
 
         if ((myrow == 0) && (mycol == 0))
         {
@@ -221,11 +256,14 @@ const int NB;
             Gflops = (((double)(N) / 1.0e+9) *
                       ((double)(N) / wtime[0])) *
                      ((2.0 / 3.0) * (double)(N) + (3.0 / 2.0));
+            RES->time = wtime[0];
+            RES->gflops = Gflops;
+            RES->iter = iter;
 
             cpfact = (((HPL_T_FACT)(ALGO->pfact) ==
                        (HPL_T_FACT)(HPL_LEFT_LOOKING))
                           ? (char)('L')
-                          : (((HPL_T_FACT)(ALGO->pfact) == (HPL_T_FACT)(HPL_CROUT)) ? (char)('C') : (char)('R')));
+                          : (((HPL_T_FACT)(ALGO->pfact) == (HPL_T_FACT)(HPL_CROUT)) ? (char)('C') : ((ALGO->pfact == HPLAI_TOURNAMENT) ? (char)('T') : ((ALGO->pfact == HPLAI_RIGHT_THREADED) ? (char)('M') : (char)('R')))));
             crfact = (((HPL_T_FACT)(ALGO->rfact) ==
                        (HPL_T_FACT)(HPL_LEFT_LOOKING))
                           ? (char)('L')
@@ -241,22 +279,90 @@ const int NB;
                 ctop = '3';
             else if (ALGO->btopo == HPL_BLONG)
                 ctop = '4';
-            else /* if( ALGO->btopo == HPL_BLONG_M ) */
+            else if (ALGO->btopo == HPL_BLONG_M)
                 ctop = '5';
+            else if (ALGO->btopo == HPLAI_IBCAST)
+                ctop = '6';
+            else if (ALGO->btopo == HPLAI_1RING_S)
+                ctop = '7';
+            else if (ALGO->btopo == HPLAI_HIER)
+                ctop = '8';
+            else /* if( ALGO->btopo == HPLAI_HIER_SHM ) */
+                ctop = '9';
+
+            if (ALGO->depth < 0)
+                (void)strcpy(cdepth, "D");
+            else
+                (void)sprintf(cdepth, "%d", ALGO->depth);
 
             if (wtime[0] > HPL_rzero)
             {
                 HPL_fprintf(TEST->outfp,
-                            "W%c%1d%c%c%1d%c%1d%12d %5d %5d %5d %18.2f    %19.4e\n",
+                            "W%c%s%c%c%1d%c%1d%12d %5d %5d %5d %18.2f    %19.4e\n",
                             (GRID->order == HPL_ROW_MAJOR ? 'R' : 'C'),
-                            ALGO->depth, ctop, crfact, ALGO->nbdiv, cpfact, ALGO->nbmin,
+                            cdepth, ctop, crfact, ALGO->nbdiv, cpfact, ALGO->nbmin,
                             N, NB, nprow, npcol, wtime[0], Gflops);
                 HPL_fprintf(TEST->outfp,
                             "HPLAI_pdgesv() start time %s\n", ctime(&current_time_start));
                 HPL_fprintf(TEST->outfp,
                             "HPLAI_pdgesv() end time   %s\n", ctime(&current_time_end));
+                if (gtime[0] > HPL_rzero)
+                    HPL_fprintf(TEST->outfp,
+                                "HPLAI_pdmatgen() time %18.2f\n\n", gtime[0]);
+                HPL_fprintf(TEST->outfp,
+                            "Peak resident set size %12.2f MB (max over processes)\n\n",
+                            rss[0]);
+                HPL_fprintf(TEST->outfp,
+                            "Factorization in %s, %d GMRES iterations in the refinement\n\n",
+                            (sizeof(HPLAI_T_AFLOAT) == sizeof(double) ? "double" : HPLAI_LFLOAT_NAME),
+                            iter);
             }
         }
+        /*
+ * Sum the panel workspace counters over all processes - The time saved
+ * by recycling is estimated from the average cost per allocated byte.
+ */
+        HPLAI_papanel_wstat(&pwstat);
+        wbuf[0] = pwstat.nalloc;
+        wbuf[1] = pwstat.balloc;
+        wbuf[2] = pwstat.talloc;
+        wbuf[3] = pwstat.nreuse;
+        wbuf[4] = pwstat.breuse;
+        (void)HPL_reduce((void *)(wbuf), 5, HPL_DOUBLE, HPL_sum, 0,
+                         GRID->all_comm);
+        pwstat.nalloc = wbuf[0];
+        pwstat.balloc = wbuf[1];
+        pwstat.talloc = wbuf[2];
+        pwstat.nreuse = wbuf[3];
+        pwstat.breuse = wbuf[4];
+        if ((myrow == 0) && (mycol == 0) && (pwstat.nalloc > HPL_rzero))
+        {
+            HPL_fprintf(TEST->outfp,
+                        "Panel workspaces: %.0f allocated (%.2f MB, %.4f s), %.0f recycled (%.2f MB, ~%.4f s saved), per process\n\n",
+                        pwstat.nalloc / (nprow * npcol), pwstat.balloc / (nprow * npcol) / 1.0e+6,
+                        pwstat.talloc / (nprow * npcol),
+                        pwstat.nreuse / (nprow * npcol), pwstat.breuse / (nprow * npcol) / 1.0e+6,
+                        pwstat.talloc * pwstat.breuse / pwstat.balloc / (nprow * npcol));
+        }
+        /*
+ * Time spent by the  main thread of the processes in the panel broad-
+ * casts, i.e. not overlapped with the update (max over processes). It
+ * is only measured with HPLAI_BSTAT or the progress thread.
+ */
+        HPLAI_bprog_stat(&bstat);
+        bbuf[0] = bstat.npanel;
+        bbuf[1] = bstat.tidle;
+        (void)HPL_reduce((void *)(bbuf), 2, HPL_DOUBLE, HPL_max, 0,
+                         GRID->all_comm);
+        bstat.npanel = bbuf[0];
+        bstat.tidle = bbuf[1];
+        if ((myrow == 0) && (mycol == 0) && (bstat.npanel > HPL_rzero))
+        {
+            HPL_fprintf(TEST->outfp,
+                        "Panel broadcasts: %.0f panels, %.4f s in HPLAI_bcast/HPLAI_bwait (%.2f us per iteration), progress thread %s\n\n",
+                        bstat.npanel, bstat.tidle, 1.0e+6 * bstat.tidle / bstat.npanel,
+                        (bstat.thread ? "on" : "off"));
+        }
 #ifdef HPL_DETAILED_TIMING
         HPL_ptimer_combine(GRID->all_comm, HPL_AMAX_PTIME, HPL_WALL_PTIME,
                            HPL_TIMING_N, HPL_TIMING_BEG, HPL_w);
@@ -413,6 +519,7 @@ const int NB;
             resid1 = resid0 / (TEST->epsil * (AnormI * XnormI + BnormI) * (double)(N));
         }
 
+        RES->resid = resid1;
         if (resid1 < TEST->thrsh)
             (TEST->kpass)++;
         else
@@ -450,6 +557,4 @@ const int NB;
  */
     }
 
-#ifdef __cplusplus
-}
-#endif
+HPLAI_INSTANTIATE(HPLAI_pdtest);